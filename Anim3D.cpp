@@ -56,6 +56,7 @@
 #include "RSPiX.h"
 
 #include "Anim3D.h"
+#include "AnimPack.h"
 #include "game.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -71,6 +72,51 @@
 // Functions.
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+// Get a channel from ppack, if it has it, or else from its own resource, which
+// is then added to ppackNew, if not NULL, so it can be written out as a pack.
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+static int16_t GetChannel(			// Returns 0 on success.
+	CAnimPack*	ppack,				// In:  Pack to look in first or NULL.
+	CAnimPack*	ppackNew,			// In:  Pack to add loose channels to or NULL.
+	const char*	pszBaseName,		// In:  Base string for resource filenames.
+	const char*	pszSuffix,			// In:  String to add to get this channel's.
+	T**			ppchan,				// Out: Channel.
+	char*			pszResName)			// Out: Resource name (for complaining).
+	{
+	sprintf(pszResName, "%s%s", pszBaseName, pszSuffix);
+	if (ppack != NULL)
+		{
+		if (ppack->Get(pszSuffix, ppchan) == true)
+			return 0;
+		}
+
+	int16_t	sRes	= rspGetResource(&g_resmgrGame, pszResName, ppchan);
+	if (sRes == 0 && ppackNew != NULL)
+		ppackNew->Add(pszSuffix, *ppchan);
+
+	return sRes;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Release a channel, unless it belongs to ppack, in which case it's just
+// forgotten.
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+static void ReleaseChannel(		// Returns nothing.
+	CAnimPack*	ppack,				// In:  Pack the channel might belong to or NULL.
+	T**			ppchan)				// In:  Channel, which is set to NULL.
+	{
+	if (*ppchan != NULL)
+		{
+		if (ppack != NULL && ppack->Has(*ppchan) == true)
+			*ppchan	= NULL;
+		else
+			rspReleaseResource(&g_resmgrGame, ppchan);
+		}
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Default constructor.
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,6 +129,7 @@ CAnim3D::CAnim3D()
 	m_ptransRigid	= NULL;
 	m_pevent			= NULL;
 	m_ptransWeapon	= NULL;
+	m_ppack			= NULL;
 	}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,76 +232,10 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 	int16_t		sLoopFlags)				// In:  Looping flags to apply to all channels
 											// in this anim.
 	{
-	int16_t	sRes;
-	char	szResName[RSP_MAX_PATH];
-	sprintf(szResName, "%s.sop", pszBaseFileName);
-	sRes	=  rspGetResource(&g_resmgrGame, szResName, &m_psops);
-	if (sRes == 0)
-		{
-		sprintf(szResName, "%s.mesh", pszBaseFileName);
-		sRes	= rspGetResource(&g_resmgrGame, szResName, &m_pmeshes);
-		if (sRes == 0)
-			{
-			sprintf(szResName, "%s.tex", pszBaseFileName);
-			sRes	= rspGetResource(&g_resmgrGame, szResName, &m_ptextures);
-			if (sRes == 0)
-				{
-				sprintf(szResName, "%s.bounds", pszBaseFileName);
-				sRes	= rspGetResource(&g_resmgrGame, szResName, &m_pbounds);
-				if (sRes == 0)
-					{
-					if (pszRigidName != NULL)
-						{
-						if (*pszRigidName != '\0')
-							{
-							sprintf(szResName, "%s_%s.trans", pszBaseFileName, pszRigidName);
-							sRes	= rspGetResource(&g_resmgrGame, szResName, &m_ptransRigid);
-							}
-						}
+	char	szTexResName[RSP_MAX_PATH];
+	sprintf(szTexResName, "%s.tex", pszBaseFileName);
 
-					if (sRes == 0)
-						{
-						if (pszEventName != NULL)
-							{
-							if (*pszEventName != '\0')
-								{
-								sprintf(szResName, "%s_%s.event", pszBaseFileName, pszEventName);
-								sRes	= rspGetResource(&g_resmgrGame, szResName, &m_pevent);
-								}
-							}
-
-						if (sRes == 0)
-							{
-							if (pszWeaponTransName != NULL)
-								{
-								if (*pszWeaponTransName != '\0')
-									{
-									sprintf(szResName, "%s_%s.trans", pszBaseFileName, pszWeaponTransName);
-									sRes	= rspGetResource(&g_resmgrGame, szResName, &m_ptransWeapon);
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-	// If successful . . .
-	if (sRes == 0)
-		{
-		SetLooping(sLoopFlags);
-		}
-	else
-		{
-#if defined(VERBOSE)
-		TRACE("Get(): Unable to load \"%s\".\n", szResName);
-#endif
-		// Clean.
-		Release();
-		}
-
-	return sRes;
+	return GetChannels(pszBaseFileName, szTexResName, pszRigidName, pszEventName, pszWeaponTransName, sLoopFlags);
 	}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -300,39 +281,79 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 	char	szVerbedBaseName[RSP_MAX_PATH];
 	sprintf(szVerbedBaseName, "%s_%s", pszBaseFileName, pszVerb);
 
+	// If there's an associated texture scheme . . .
+	char	szTexResName[RSP_MAX_PATH];
+	if (sTextureScheme >= 0)
+		{
+		sprintf(szTexResName, "%s%d.tex", pszBaseFileName, sTextureScheme);
+		}
+	else
+		{
+		sprintf(szTexResName, "%s.tex", szVerbedBaseName);
+		}
+
+	return GetChannels(szVerbedBaseName, szTexResName, pszRigidName, pszEventName, pszWeaponTransName, sLoopFlags);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Get the various components of this animation from its .anim pack, if packs
+// are in use and it has one, or from their own resources.  The texture always
+// comes from its own resource.
+////////////////////////////////////////////////////////////////////////////////
+int16_t CAnim3D::GetChannels(		// Returns 0 on success.
+	char*		pszBaseName,			// In:  Base string for resource filenames
+											// (including verb).
+	char*		pszTexResName,			// In:  Texture resource name.
+	char*		pszRigidName,			// In:  String to add for rigid transform channel,
+											// "", or NULL for none.
+	char*		pszEventName,			// In:  String to add for event states channel,
+											// "", or NULL for none.
+	char*		pszWeaponTransName,	// In:  String to add for weapon transforms channel,
+											// "", or NULL for none.
+	int16_t		sLoopFlags)				// In:  Looping flags to apply to all channels
+											// in this anim.
+	{
 	int16_t	sRes;
 	char	szResName[RSP_MAX_PATH];
-	sprintf(szResName, "%s.sop", szVerbedBaseName);
-	sRes	=  rspGetResource(&g_resmgrGame, szResName, &m_psops);
-	if (sRes == 0)
+	char	szSuffix[RSP_MAX_PATH];
+
+	// If packs are in use, see if there's one for this animation.  If not and
+	// we're making them, collect what we load to make one.
+	CAnimPack	packNew;
+	CAnimPack*	ppackNew	= NULL;
+	char	szPackName[RSP_MAX_PATH];
+	sprintf(szPackName, "%s.anim", pszBaseName);
+	if (g_GameSettings.m_sAnimPacks != FALSE)
 		{
-		sprintf(szResName, "%s.mesh", szVerbedBaseName);
-		sRes	= rspGetResource(&g_resmgrGame, szResName, &m_pmeshes);
-		if (sRes == 0)
+		if (rspGetResource(&g_resmgrGame, szPackName, &m_ppack) != 0)
 			{
-			// If there's an associated texture scheme . . .
-			if (sTextureScheme >= 0)
+			if (g_GameSettings.m_sAnimPacks == 2)
 				{
-				sprintf(szResName, "%s%d.tex", pszBaseFileName, sTextureScheme);
-				}
-			else
-				{
-				sprintf(szResName, "%s.tex", szVerbedBaseName);
+				ppackNew	= &packNew;
+				packNew.SetKeyStep(g_GameSettings.m_sAnimKeyStep);
 				}
+			}
+		}
 
+	sRes	= GetChannel(m_ppack, ppackNew, pszBaseName, ".sop", &m_psops, szResName);
+	if (sRes == 0)
+		{
+		sRes	= GetChannel(m_ppack, ppackNew, pszBaseName, ".mesh", &m_pmeshes, szResName);
+		if (sRes == 0)
+			{
+			strcpy(szResName, pszTexResName);
 			sRes	= rspGetResource(&g_resmgrGame, szResName, &m_ptextures);
 			if (sRes == 0)
 				{
-				sprintf(szResName, "%s.bounds", szVerbedBaseName);
-				sRes	= rspGetResource(&g_resmgrGame, szResName, &m_pbounds);
+				sRes	= GetChannel(m_ppack, ppackNew, pszBaseName, ".bounds", &m_pbounds, szResName);
 				if (sRes == 0)
 					{
 					if (pszRigidName != NULL)
 						{
 						if (*pszRigidName != '\0')
 							{
-							sprintf(szResName, "%s_%s.trans", szVerbedBaseName, pszRigidName);
-							sRes	= rspGetResource(&g_resmgrGame, szResName, &m_ptransRigid);
+							sprintf(szSuffix, "_%s.trans", pszRigidName);
+							sRes	= GetChannel(m_ppack, ppackNew, pszBaseName, szSuffix, &m_ptransRigid, szResName);
 							}
 						}
 
@@ -342,8 +363,8 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 							{
 							if (*pszEventName != '\0')
 								{
-								sprintf(szResName, "%s_%s.event", szVerbedBaseName, pszEventName);
-								sRes	= rspGetResource(&g_resmgrGame, szResName, &m_pevent);
+								sprintf(szSuffix, "_%s.event", pszEventName);
+								sRes	= GetChannel(m_ppack, ppackNew, pszBaseName, szSuffix, &m_pevent, szResName);
 								}
 							}
 
@@ -353,8 +374,8 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 								{
 								if (*pszWeaponTransName != '\0')
 									{
-									sprintf(szResName, "%s_%s.trans", szVerbedBaseName, pszWeaponTransName);
-									sRes	= rspGetResource(&g_resmgrGame, szResName, &m_ptransWeapon);
+									sprintf(szSuffix, "_%s.trans", pszWeaponTransName);
+									sRes	= GetChannel(m_ppack, ppackNew, pszBaseName, szSuffix, &m_ptransWeapon, szResName);
 									}
 								}
 							}
@@ -368,6 +389,15 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 	if (sRes == 0)
 		{
 		SetLooping(sLoopFlags);
+
+		// If we're making packs and this animation didn't have one . . .
+		if (ppackNew != NULL)
+			{
+			if (packNew.Save(szPackName) == 0)
+				{
+				TRACE("GetChannels(): Wrote \"%s\".\n", szPackName);
+				}
+			}
 		}
 	else
 		{
@@ -379,7 +409,7 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 		}
 
 	return sRes;
-}
+	}
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -388,26 +418,16 @@ int16_t CAnim3D::Get(					// Returns 0 on success.
 ////////////////////////////////////////////////////////////////////////////////
 void CAnim3D::Release(void)	// Returns nothing.
 	{
-	if (m_psops != NULL)
-		rspReleaseResource(&g_resmgrGame, &m_psops);
-
-	if (m_pmeshes != NULL)
-		rspReleaseResource(&g_resmgrGame, &m_pmeshes);
-
-	if (m_ptextures != NULL)
-		rspReleaseResource(&g_resmgrGame, &m_ptextures);
-
-	if (m_pbounds != NULL)
-		rspReleaseResource(&g_resmgrGame, &m_pbounds);
-
-	if (m_ptransRigid != NULL)
-		rspReleaseResource(&g_resmgrGame, &m_ptransRigid);
-
-	if (m_pevent != NULL)
-		rspReleaseResource(&g_resmgrGame, &m_pevent);
-
-	if (m_ptransWeapon)
-		rspReleaseResource(&g_resmgrGame, &m_ptransWeapon);
+	ReleaseChannel(m_ppack, &m_psops);
+	ReleaseChannel(m_ppack, &m_pmeshes);
+	ReleaseChannel(m_ppack, &m_ptextures);
+	ReleaseChannel(m_ppack, &m_pbounds);
+	ReleaseChannel(m_ppack, &m_ptransRigid);
+	ReleaseChannel(m_ppack, &m_pevent);
+	ReleaseChannel(m_ppack, &m_ptransWeapon);
+
+	if (m_ppack != NULL)
+		rspReleaseResource(&g_resmgrGame, &m_ppack);
 	}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -430,6 +450,69 @@ void CAnim3D::SetLooping(		// Returns nothing.
 		m_ptransWeapon->SetLooping(sLoopFlags);
 	}
 
+////////////////////////////////////////////////////////////////////////////////
+// Get the sop for the specified time.  If sops are being blended, also get the
+// next key sop and how far toward it the specified time is.
+////////////////////////////////////////////////////////////////////////////////
+RSop* CAnim3D::GetSop(			// Returns the sop at lTime.
+	int32_t	lTime,					// In:  Channel time.
+	RSop**	ppsopNext,				// Out: Next key sop or NULL.
+	REAL*		pfBlend)					// Out: How far (0 to 1) toward *ppsopNext.
+	{
+	RSop*	psop	= m_psops->GetAtTime(lTime);
+
+	*ppsopNext	= NULL;
+	*pfBlend		= 0;
+
+	int32_t	lInterval	= m_psops->Resolution();
+	int32_t	lTotalTime	= m_psops->TotalTime();
+	if (g_GameSettings.m_sBlendAnims != FALSE && lInterval > 1 && lTotalTime > 0)
+		{
+		// Wrap or clamp the time the way GetAtTime() does.
+		int16_t	sLoopFlags	= m_psops->Looping();
+		if (lTime >= lTotalTime)
+			{
+			if (sLoopFlags & RChannel_LoopAtEnd)
+				lTime %= lTotalTime;
+			else
+				lTime = lTotalTime - 1;
+			}
+		else if (lTime < 0)
+			{
+			if (sLoopFlags & RChannel_LoopAtStart)
+				lTime = (lTotalTime - 1) - ((-1 - lTime) % lTotalTime);
+			else
+				lTime = 0;
+			}
+
+		int32_t	lInto	= lTime % lInterval;
+		if (lInto > 0)
+			{
+			// The key after the last one is the first, but only if it loops,
+			// and it's only as far off as the end of the channel.
+			int32_t	lNext	= lTime / lInterval + 1;
+			int32_t	lSpan	= lInterval;
+			if (lNext >= m_psops->NumItems() && (sLoopFlags & RChannel_LoopAtEnd) )
+				{
+				lNext	= 0;
+				lSpan	= lTotalTime - (lTime - lInto);
+				}
+
+			if (lNext < m_psops->NumItems() && lInto < lSpan)
+				{
+				RSop*	psopNext	= m_psops->GetItem(lNext);
+				if (psopNext != psop && psopNext->m_lNum == psop->m_lNum)
+					{
+					*ppsopNext	= psopNext;
+					*pfBlend		= REAL(lInto) / REAL(lSpan);
+					}
+				}
+			}
+		}
+
+	return psop;
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
 ////////////////////////////////////////////////////////////////////////////////
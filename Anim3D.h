@@ -54,6 +54,8 @@ typedef RChannel<REAL> ChanFloor;				// Channel of floor circles
 typedef RChannel<RTransform> ChanTransform;	// Channel of transforms.
 typedef RChannel<U8> ChanEvent;					// Channel of event states.
 
+class CAnimPack;
+
 /////////////////////////////////////////////////////////////////////////
 // This class describes the components of any 3D animation.
 // To add more stuff (e.g., links for rigid bodies and such), descend
@@ -78,6 +80,8 @@ class CAnim3D
 		ChanTransform*	m_ptransWeapon;	// Rigid body transforms for weapon
 													// position.
 
+		CAnimPack*		m_ppack;				// Pack the other channels came from, if any.
+
 	public:	// Methods for this animation.
 
 		// Constructor.
@@ -165,6 +169,32 @@ class CAnim3D
 			int16_t sLoopFlags);		// In:  Looping flags to apply to all channels
 											// in this anim.
 
+		// Get the sop for the specified time.  If sops are being blended (see
+		// the BlendAnims setting), also get the next key sop and how far
+		// toward it the specified time is; otherwise, *ppsopNext is NULL.
+		RSop* GetSop(							// Returns the sop at lTime.
+			int32_t	lTime,					// In:  Channel time.
+			RSop**	ppsopNext,				// Out: Next key sop or NULL.
+			REAL*		pfBlend);				// Out: How far (0 to 1) toward *ppsopNext.
+
+	protected:	// Internal methods.
+
+		// Get the various components of this animation from its .anim pack,
+		// if packs are in use and it has one, or from their own resources.
+		// The texture always comes from its own resource.
+		int16_t GetChannels(					// Returns 0 on success.
+			char*		pszBaseName,			// In:  Base string for resource filenames
+													// (including verb).
+			char*		pszTexResName,			// In:  Texture resource name.
+			char*		pszRigidName,			// In:  String to add for rigid transform channel,
+													// "", or NULL for none.
+			char*		pszEventName,			// In:  String to add for event states channel,
+													// "", or NULL for none.
+			char*		pszWeaponTransName,	// In:  String to add for weapon transforms channel,
+													// "", or NULL for none.
+			int16_t		sLoopFlags);			// In:  Looping flags to apply to all channels
+													// in this anim.
+
 	};
 
 
@@ -0,0 +1,732 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// AnimPack.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+// File format (little endian):
+//
+//		U32		FileID
+//		S16		FileVersion
+//		S32		Size of everything that follows (read all at once)
+//		S16		Number of channels
+//		S32		Number of packed points in all sop channels
+//		For each channel:
+//			RString	Suffix
+//			S16		Kind
+//			For Sops:
+//				RString	Channel name
+//				S16		Looping flags
+//				S32		Total time
+//				S32		Interval
+//				S32		Number of frames
+//				S32		Number of stored frames
+//				float		Scale for x, y, z
+//				float		Bias for x, y, z
+//				S32		Stored frame for each frame
+//				For each stored frame:
+//					S32	Number of points
+//					U8		Method (0 for S16 x, y, z; 1 for S8 differences from
+//							the previous stored frame)
+//					S16 or S8 x, y, z for each point
+//			For everything else:
+//				The RChannel as saved by RChannel::Save().
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "RSPiX.h"
+
+#include "AnimPack.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Macros.
+//////////////////////////////////////////////////////////////////////////////
+
+// Ways a stored frame's points can be saved.
+#define METHOD_RAW		0	// S16 x, y, z.
+#define METHOD_DELTA		1	// S8 differences from the previous stored frame.
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CAnimPack::CAnimPack()
+	{
+	m_sNumChannels	= 0;
+	m_bOwned			= false;
+	m_psPts			= NULL;
+	m_lNumPts		= 0;
+	m_lPt				= 0;
+	m_sKeyStep		= 1;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CAnimPack::~CAnimPack()
+	{
+	Free();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get rid of all channels (only deleting the ones this pack owns).
+//////////////////////////////////////////////////////////////////////////////
+void CAnimPack::Free(void)
+	{
+	if (m_bOwned == true)
+		{
+		int16_t	s;
+		for (s = 0; s < m_sNumChannels; s++)
+			{
+			void*	pv	= m_achannels[s].pvChan;
+			switch (m_achannels[s].kind)
+				{
+				case Sops:			delete (ChanForm*)pv;		break;
+				case Meshes:		delete (ChanMesh*)pv;		break;
+				case Bounds:		delete (ChanBounds*)pv;		break;
+				case Transforms:	delete (ChanTransform*)pv;	break;
+				case Events:		delete (ChanEvent*)pv;		break;
+				}
+			}
+		}
+
+	m_sNumChannels	= 0;
+	m_bOwned			= false;
+
+	delete[] m_psPts;
+	m_psPts		= NULL;
+	m_lNumPts	= 0;
+	m_lPt			= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Add a channel this pack doesn't own.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CAnimPack::Add(			// Returns 0 on success.
+	const char*	pszSuffix,		// In:  Suffix.
+	Kind			kind,				// In:  Kind of channel.
+	void*			pvChan)			// In:  Channel.
+	{
+	int16_t	sResult	= 0;
+
+	ASSERT(m_bOwned == false || m_sNumChannels == 0);
+
+	if (m_sNumChannels < MaxChannels)
+		{
+		m_achannels[m_sNumChannels].strSuffix	= pszSuffix;
+		m_achannels[m_sNumChannels].kind			= kind;
+		m_achannels[m_sNumChannels].pvChan		= pvChan;
+		m_sNumChannels++;
+		}
+	else
+		{
+		TRACE("Add(): Too many channels.\n");
+		sResult	= -1;
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Find the channel with the specified suffix and kind.
+//////////////////////////////////////////////////////////////////////////////
+void* CAnimPack::Find(				// Returns the channel or NULL.
+	const char*	pszSuffix,			// In:  Suffix.
+	Kind			kind)					// In:  Kind of channel.
+	{
+	int16_t	s;
+	for (s = 0; s < m_sNumChannels; s++)
+		{
+		if (m_achannels[s].kind == kind && m_achannels[s].strSuffix == pszSuffix)
+			return m_achannels[s].pvChan;
+		}
+
+	return NULL;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Find out whether the specified channel is one of this pack's.
+//////////////////////////////////////////////////////////////////////////////
+bool CAnimPack::Has(				// Returns true if it is.
+	void*		pvChan)				// In:  Channel.
+	{
+	int16_t	s;
+	for (s = 0; s < m_sNumChannels; s++)
+		{
+		if (m_achannels[s].pvChan == pvChan)
+			return true;
+		}
+
+	return false;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Load a pack, replacing whatever this one had.  Everything after the header
+// is read with one read and then picked apart in memory.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CAnimPack::Load(		// Returns 0 on success.
+	RFile*	pfile)				// In:  File to load from.
+	{
+	int16_t	sResult	= 0;
+
+	Free();
+
+	U32	u32ID			= 0;
+	S16	sVersion		= 0;
+	S32	lSize			= 0;
+	pfile->Read(&u32ID);
+	pfile->Read(&sVersion);
+	pfile->Read(&lSize);
+	if (!pfile->Error() && u32ID == FileID && sVersion == FileVersion && lSize > 0)
+		{
+		U8*	pu8Data	= new U8[lSize];
+		if (pfile->Read(pu8Data, lSize) == lSize)
+			{
+			RFile	fileMem;
+			fileMem.Open(pu8Data, lSize, RFile::LittleEndian);
+
+			S16	sNumChannels	= 0;
+			fileMem.Read(&sNumChannels);
+			fileMem.Read(&m_lNumPts);
+			if (!fileMem.Error() && sNumChannels >= 0 && sNumChannels <= MaxChannels && m_lNumPts >= 0)
+				{
+				m_psPts	= new int16_t[m_lNumPts * 3 + 1];
+				m_bOwned	= true;
+
+				while (m_sNumChannels < sNumChannels && sResult == 0)
+					{
+					Channel*	pchannel	= &m_achannels[m_sNumChannels];
+					S16		sKind		= 0;
+					sResult	= pchannel->strSuffix.Load(&fileMem);
+					fileMem.Read(&sKind);
+					if (sResult == 0 && !fileMem.Error())
+						{
+						pchannel->kind		= (Kind)sKind;
+						pchannel->pvChan	= NULL;
+						switch (pchannel->kind)
+							{
+							case Sops:
+								{
+								ChanForm*	pchan	= new ChanForm;
+								pchannel->pvChan	= pchan;
+								sResult	= LoadSops(&fileMem, pchan);
+								break;
+								}
+							case Meshes:
+								{
+								ChanMesh*	pchan	= new ChanMesh;
+								pchannel->pvChan	= pchan;
+								sResult	= pchan->Load(&fileMem);
+								break;
+								}
+							case Bounds:
+								{
+								ChanBounds*	pchan	= new ChanBounds;
+								pchannel->pvChan	= pchan;
+								sResult	= pchan->Load(&fileMem);
+								break;
+								}
+							case Transforms:
+								{
+								ChanTransform*	pchan	= new ChanTransform;
+								pchannel->pvChan	= pchan;
+								sResult	= pchan->Load(&fileMem);
+								break;
+								}
+							case Events:
+								{
+								ChanEvent*	pchan	= new ChanEvent;
+								pchannel->pvChan	= pchan;
+								sResult	= pchan->Load(&fileMem);
+								break;
+								}
+							default:
+								TRACE("Load(): Unknown kind of channel %d.\n", (int)sKind);
+								sResult	= -4;
+								break;
+							}
+
+						// Even a channel that failed to load must be counted so it's
+						// deleted.
+						if (pchannel->pvChan != NULL)
+							m_sNumChannels++;
+						}
+					else
+						{
+						TRACE("Load(): Error reading channel header.\n");
+						sResult	= -3;
+						}
+					}
+				}
+			else
+				{
+				TRACE("Load(): Bad pack header.\n");
+				sResult	= -2;
+				}
+
+			fileMem.Close();
+			}
+		else
+			{
+			TRACE("Load(): Error reading %ld bytes.\n", (long)lSize);
+			sResult	= -1;
+			}
+
+		delete[] pu8Data;
+		}
+	else
+		{
+		TRACE("Load(): Not a version %d anim pack.\n", (int)FileVersion);
+		sResult	= -1;
+		}
+
+	if (sResult != 0)
+		{
+		Free();
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Load a packed sop channel, putting its points at m_psPts + m_lPt.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CAnimPack::LoadSops(		// Returns 0 on success.
+	RFile*		pfile,				// In:  File to load from.
+	ChanForm*	pchan)				// In:  Channel to fill in.
+	{
+	int16_t	sResult	= 0;
+
+	RString	strName;
+	S16		sLoopFlags			= 0;
+	S32		lTotalTime			= 0;
+	S32		lInterval			= 0;
+	S32		lNumFrames			= 0;
+	S32		lNumStored			= 0;
+	float		afScale[3];
+	float		afBias[3];
+	strName.Load(pfile);
+	pfile->Read(&sLoopFlags);
+	pfile->Read(&lTotalTime);
+	pfile->Read(&lInterval);
+	pfile->Read(&lNumFrames);
+	pfile->Read(&lNumStored);
+	pfile->Read(afScale, 3);
+	pfile->Read(afBias, 3);
+	if (pfile->Error() || lNumFrames <= 0 || lNumStored <= 0 || lNumStored > lNumFrames || lInterval <= 0)
+		{
+		TRACE("LoadSops(): Bad sop channel header.\n");
+		return -1;
+		}
+
+	S32*		plIndices	= new S32[lNumFrames];
+	S32*		plFirstPt	= new S32[lNumStored];
+	S32*		plNumPts		= new S32[lNumStored];
+	S8*		ps8Delta		= NULL;
+	S32		lDeltaSize	= 0;
+
+	pfile->Read(plIndices, lNumFrames);
+
+	S32	l;
+	for (l = 0; l < lNumStored && sResult == 0; l++)
+		{
+		U8	u8Method	= METHOD_RAW;
+		pfile->Read(&plNumPts[l]);
+		pfile->Read(&u8Method);
+		plFirstPt[l]	= m_lPt;
+
+		S32	lNum	= plNumPts[l] * 3;
+		if (pfile->Error() || plNumPts[l] < 0 || m_lPt + plNumPts[l] > m_lNumPts)
+			{
+			TRACE("LoadSops(): Bad stored frame %ld.\n", (long)l);
+			sResult	= -2;
+			}
+		else if (u8Method == METHOD_RAW)
+			{
+			pfile->Read(m_psPts + m_lPt * 3, lNum);
+			}
+		else if (u8Method == METHOD_DELTA && l > 0 && plNumPts[l - 1] == plNumPts[l])
+			{
+			if (lDeltaSize < lNum)
+				{
+				delete[] ps8Delta;
+				ps8Delta		= new S8[lNum];
+				lDeltaSize	= lNum;
+				}
+
+			pfile->Read(ps8Delta, lNum);
+
+			int16_t*	psPrev	= m_psPts + plFirstPt[l - 1] * 3;
+			int16_t*	psCur		= m_psPts + m_lPt * 3;
+			S32		i;
+			for (i = 0; i < lNum; i++)
+				psCur[i]	= int16_t(psPrev[i] + ps8Delta[i]);
+			}
+		else
+			{
+			TRACE("LoadSops(): Bad method %d for stored frame %ld.\n", (int)u8Method, (long)l);
+			sResult	= -3;
+			}
+
+		m_lPt	+= plNumPts[l];
+		}
+
+	if (sResult == 0 && pfile->Error())
+		{
+		TRACE("LoadSops(): Error reading points.\n");
+		sResult	= -4;
+		}
+
+	if (sResult == 0)
+		{
+		pchan->SetType(RChannel_Array);
+		pchan->SetName(strName);
+		pchan->CreateItems(lNumFrames);
+		pchan->SetTotalTime(lTotalTime);
+		pchan->SetResolution(lInterval);
+		pchan->SetLooping(sLoopFlags);
+
+		for (l = 0; l < lNumFrames && sResult == 0; l++)
+			{
+			S32	lStored	= plIndices[l];
+			if (lStored >= 0 && lStored < lNumStored)
+				{
+				RSop*	psop	= pchan->GetItem(l);
+				psop->m_lNum		= plNumPts[lStored];
+				psop->m_psPacked	= m_psPts + plFirstPt[lStored] * 3;
+				int16_t	c;
+				for (c = 0; c < 3; c++)
+					{
+					psop->m_afUnpackScale[c]	= afScale[c];
+					psop->m_afUnpackBias[c]		= afBias[c];
+					}
+				}
+			else
+				{
+				TRACE("LoadSops(): Bad stored frame index %ld for frame %ld.\n", (long)lStored, (long)l);
+				sResult	= -5;
+				}
+			}
+		}
+
+	delete[] ps8Delta;
+	delete[] plNumPts;
+	delete[] plFirstPt;
+	delete[] plIndices;
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Save this pack.  Everything after the header is put together in memory
+// first so its size can go in the header.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CAnimPack::Save(		// Returns 0 on success.
+	RFile*	pfile)				// In:  File to save to.
+	{
+	int16_t	sResult	= 0;
+
+	RFile	fileMem;
+	if (fileMem.Open(64 * 1024, 64 * 1024, RFile::LittleEndian) == 0)
+		{
+		// The number of sop points, so the loader can get them all in one
+		// allocation, isn't known until they've been saved, so it's filled in
+		// afterward.
+		S32		lNumPts	= 0;
+		int16_t	s;
+		fileMem.Write((S16)m_sNumChannels);
+		fileMem.Write(lNumPts);
+
+		for (s = 0; s < m_sNumChannels && sResult == 0; s++)
+			{
+			void*	pv	= m_achannels[s].pvChan;
+			sResult	= m_achannels[s].strSuffix.Save(&fileMem);
+			fileMem.Write((S16)m_achannels[s].kind);
+			if (sResult == 0)
+				{
+				switch (m_achannels[s].kind)
+					{
+					case Sops:			sResult	= SaveSops(&fileMem, (ChanForm*)pv, m_sKeyStep, &lNumPts);	break;
+					case Meshes:		sResult	= ((ChanMesh*)pv)->Save(&fileMem);			break;
+					case Bounds:		sResult	= ((ChanBounds*)pv)->Save(&fileMem);		break;
+					case Transforms:	sResult	= ((ChanTransform*)pv)->Save(&fileMem);	break;
+					case Events:		sResult	= ((ChanEvent*)pv)->Save(&fileMem);			break;
+					}
+				}
+			}
+
+		if (sResult == 0 && !fileMem.Error())
+			{
+			S32	lSize	= fileMem.Tell();
+			fileMem.Seek(sizeof(S16), SEEK_SET);
+			fileMem.Write(lNumPts);
+			pfile->Write((U32)FileID);
+			pfile->Write((S16)FileVersion);
+			pfile->Write(lSize);
+			pfile->Write(fileMem.GetMemory(), lSize);
+			if (pfile->Error())
+				{
+				TRACE("Save(): Error writing pack.\n");
+				sResult	= -3;
+				}
+			}
+		else if (sResult == 0)
+			{
+			TRACE("Save(): Error putting pack together.\n");
+			sResult	= -2;
+			}
+
+		fileMem.Close();
+		}
+	else
+		{
+		TRACE("Save(): Unable to open memory file.\n");
+		sResult	= -1;
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Save this pack to the specified file.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CAnimPack::Save(		// Returns 0 on success.
+	const char*	pszFileName)	// In:  File to create.
+	{
+	int16_t	sResult	= 0;
+
+	RFile	file;
+	if (file.Open(pszFileName, "wb", RFile::LittleEndian) == 0)
+		{
+		sResult	= Save(&file);
+		file.Close();
+		}
+	else
+		{
+		TRACE("Save(): Unable to create \"%s\".\n", pszFileName);
+		sResult	= -1;
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Save a sop channel packed.  Only points with w of 1 can be packed.  Frames
+// are only skipped if they all have the same number of points, since each
+// must still go with the mesh for its time.
+//////////////////////////////////////////////////////////////////////////////
+// static
+int16_t CAnimPack::SaveSops(	// Returns 0 on success.
+	RFile*		pfile,			// In:  File to save to.
+	ChanForm*	pchan,			// In:  Channel.
+	int16_t		sKeyStep,		// In:  Keep only every this many frames.
+	int32_t*		plNumPts)		// In/Out:  Number of points stored is added to this.
+	{
+	int16_t	sResult	= 0;
+
+	S32	lNumItems	= pchan->NumItems();
+	if (lNumItems <= 0 || pchan->Resolution() <= 0)
+		{
+		TRACE("SaveSops(): Channel has no frames.\n");
+		return -1;
+		}
+
+	S32	lStep	= (sKeyStep > 1) ? sKeyStep : 1;
+	S32	l;
+	for (l = 1; l < lNumItems && lStep > 1; l++)
+		{
+		if (pchan->GetItem(l)->m_lNum != pchan->GetItem(0)->m_lNum)
+			{
+			TRACE("SaveSops(): Frames differ in points, so all are kept.\n");
+			lStep	= 1;
+			}
+		}
+
+	// The frames kept.
+	S32		lNumFrames	= (lNumItems + lStep - 1) / lStep;
+	RSop**	ppsops		= new RSop*[lNumFrames];
+	for (l = 0; l < lNumFrames; l++)
+		ppsops[l]	= pchan->GetItem(l * lStep);
+
+	// Find the range of each axis.
+	float	afMin[3]	= { 0.0F, 0.0F, 0.0F };
+	float	afMax[3]	= { 0.0F, 0.0F, 0.0F };
+	bool	bFirst	= true;
+	RP3d	pt;
+	S32	i;
+	int16_t	c;
+	for (l = 0; l < lNumFrames && sResult == 0; l++)
+		{
+		RSop*	psop	= ppsops[l];
+		for (i = 0; i < psop->m_lNum; i++)
+			{
+			psop->GetPt(i, pt);
+			if (fabs(pt.w - 1.0) > 0.0001)
+				{
+				TRACE("SaveSops(): Can't pack a point with w of %g.\n", (double)pt.w);
+				sResult	= -2;
+				break;
+				}
+
+			for (c = 0; c < 3; c++)
+				{
+				if (bFirst || pt.v[c] < afMin[c])
+					afMin[c]	= pt.v[c];
+				if (bFirst || pt.v[c] > afMax[c])
+					afMax[c]	= pt.v[c];
+				}
+			bFirst	= false;
+			}
+		}
+
+	if (sResult != 0)
+		{
+		delete[] ppsops;
+		return sResult;
+		}
+
+	// Spread each axis over the whole range of an S16.
+	float	afScale[3];
+	float	afBias[3];
+	for (c = 0; c < 3; c++)
+		{
+		afScale[c]	= (afMax[c] - afMin[c]) / 65535.0F;
+		if (afScale[c] <= 0.0F)
+			afScale[c]	= 1.0F;
+		afBias[c]	= afMin[c] + 32768.0F * afScale[c];
+		}
+
+	// Quantize every frame.
+	int16_t**	ppsFrames	= new int16_t*[lNumFrames];
+	for (l = 0; l < lNumFrames; l++)
+		{
+		RSop*	psop	= ppsops[l];
+		ppsFrames[l]	= new int16_t[psop->m_lNum * 3 + 1];
+		for (i = 0; i < psop->m_lNum; i++)
+			{
+			psop->GetPt(i, pt);
+			for (c = 0; c < 3; c++)
+				{
+				double	dQ	= floor((pt.v[c] - afBias[c]) / afScale[c] + 0.5);
+				if (dQ < -32768.0)
+					dQ	= -32768.0;
+				else if (dQ > 32767.0)
+					dQ	= 32767.0;
+				ppsFrames[l][i * 3 + c]	= (int16_t)dQ;
+				}
+			}
+		}
+
+	// Store each different frame once.
+	S32*	plIndices	= new S32[lNumFrames];
+	S32*	plStored		= new S32[lNumFrames];		// Frame for each stored frame.
+	S32	lNumStored	= 0;
+	for (l = 0; l < lNumFrames; l++)
+		{
+		S32	lNum	= ppsops[l]->m_lNum;
+		S32	s;
+		for (s = 0; s < lNumStored; s++)
+			{
+			S32	lOther	= plStored[s];
+			if (ppsops[lOther]->m_lNum == lNum
+				&& memcmp(ppsFrames[lOther], ppsFrames[l], lNum * 3 * sizeof(int16_t)) == 0)
+				break;
+			}
+
+		if (s == lNumStored)
+			plStored[lNumStored++]	= l;
+
+		plIndices[l]	= s;
+		}
+
+	RString	strName;
+	if (pchan->Name() != NULL)
+		strName	= pchan->Name();
+	strName.Save(pfile);
+	pfile->Write((S16)pchan->Looping());
+	pfile->Write((S32)pchan->TotalTime());
+	pfile->Write((S32)(pchan->Resolution() * lStep) );
+	pfile->Write(lNumFrames);
+	pfile->Write(lNumStored);
+	pfile->Write(afScale, 3);
+	pfile->Write(afBias, 3);
+	pfile->Write(plIndices, lNumFrames);
+
+	// Use differences from the previous stored frame wherever they all fit.
+	S8*	ps8Delta		= NULL;
+	S32	lDeltaSize	= 0;
+	S32	s;
+	for (s = 0; s < lNumStored; s++)
+		{
+		int16_t*	psCur	= ppsFrames[plStored[s]];
+		S32		lNum	= ppsops[plStored[s]]->m_lNum;
+		U8			u8Method	= METHOD_RAW;
+		if (s > 0 && ppsops[plStored[s - 1]]->m_lNum == lNum)
+			{
+			int16_t*	psPrev	= ppsFrames[plStored[s - 1]];
+			if (lDeltaSize < lNum * 3)
+				{
+				delete[] ps8Delta;
+				ps8Delta		= new S8[lNum * 3];
+				lDeltaSize	= lNum * 3;
+				}
+
+			for (i = 0; i < lNum * 3; i++)
+				{
+				int32_t	lDelta	= int32_t(psCur[i]) - int32_t(psPrev[i]);
+				if (lDelta < -128 || lDelta > 127)
+					break;
+				ps8Delta[i]	= (S8)lDelta;
+				}
+
+			if (i == lNum * 3)
+				u8Method	= METHOD_DELTA;
+			}
+
+		pfile->Write(lNum);
+		pfile->Write(u8Method);
+		*plNumPts	+= lNum;
+		if (u8Method == METHOD_DELTA)
+			pfile->Write(ps8Delta, lNum * 3);
+		else
+			pfile->Write(psCur, lNum * 3);
+		}
+
+	if (pfile->Error())
+		{
+		TRACE("SaveSops(): Error writing sops.\n");
+		sResult	= -3;
+		}
+
+	delete[] ps8Delta;
+	delete[] plStored;
+	delete[] plIndices;
+	for (l = 0; l < lNumFrames; l++)
+		delete[] ppsFrames[l];
+	delete[] ppsFrames;
+	delete[] ppsops;
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// AnimPack.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CAnimPack holds all the channels of one 3D animation (see CAnim3D) in a
+// single .anim file, which is loaded as a resource with one read instead of
+// one file per channel.  Channels are looked up by the suffix that would
+// otherwise be added to the animation's base name to get their own file
+// (e.g., ".sop", ".mesh", "_main.trans").  Textures aren't kept in packs
+// since they're picked by texture scheme, not by animation.
+//
+// The sops are what make animations big, so they're stored specially: each
+// animation gets a scale and bias per axis so that every point fits in 16
+// bit x, y, z; frames that are the same as an earlier frame are stored just
+// once; and a frame whose points are all close to the previous stored
+// frame's is stored as 8 bit differences from it.  Once loaded, all the
+// points stay packed in one allocation and the pipeline unpacks them as it
+// transforms them (see RSop::m_psPacked).  Everything else is stored just
+// as its RChannel would save itself.
+//
+// A pack can also be put together from channels loaded some other way (see
+// Add()) and saved.  Such a pack doesn't own its channels.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef ANIMPACK_H
+#define ANIMPACK_H
+
+#include "RSPiX.h"
+
+#include "Anim3D.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CAnimPack
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			FileID		= 0x4D494E41,	// ASCII for "ANIM" backwards.
+			FileVersion	= 1,				// Current file version.
+			MaxChannels	= 16				// Most channels in one pack.
+			};
+
+		// Kinds of channels.
+		typedef enum
+			{
+			Sops,
+			Meshes,
+			Bounds,
+			Transforms,
+			Events
+			} Kind;
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CAnimPack();
+
+		// Destructor.
+		~CAnimPack();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Load a pack, replacing whatever this one had.
+		int16_t Load(						// Returns 0 on success.
+			RFile*	pfile);				// In:  File to load from.
+
+		// Save this pack.
+		int16_t Save(						// Returns 0 on success.
+			RFile*	pfile);				// In:  File to save to.
+
+		// Save this pack to the specified file.
+		int16_t Save(						// Returns 0 on success.
+			const char*	pszFileName);	// In:  File to create.
+
+		// Get rid of all channels (only deleting the ones this pack owns).
+		void Free(void);
+
+		// Add a channel this pack doesn't own (so it can be saved).
+		int16_t Add(const char* pszSuffix, ChanForm* pchan)			// Returns 0 on success.
+			{ return Add(pszSuffix, Sops, pchan); }
+		int16_t Add(const char* pszSuffix, ChanMesh* pchan)			// Returns 0 on success.
+			{ return Add(pszSuffix, Meshes, pchan); }
+		int16_t Add(const char* pszSuffix, ChanBounds* pchan)		// Returns 0 on success.
+			{ return Add(pszSuffix, Bounds, pchan); }
+		int16_t Add(const char* pszSuffix, ChanTransform* pchan)	// Returns 0 on success.
+			{ return Add(pszSuffix, Transforms, pchan); }
+		int16_t Add(const char* pszSuffix, ChanEvent* pchan)		// Returns 0 on success.
+			{ return Add(pszSuffix, Events, pchan); }
+
+		// Get the channel with the specified suffix, if there is one.
+		bool Get(const char* pszSuffix, ChanForm** ppchan)			// Returns true if found.
+			{ return (*ppchan = (ChanForm*)Find(pszSuffix, Sops)) != NULL; }
+		bool Get(const char* pszSuffix, ChanMesh** ppchan)			// Returns true if found.
+			{ return (*ppchan = (ChanMesh*)Find(pszSuffix, Meshes)) != NULL; }
+		bool Get(const char* pszSuffix, ChanBounds** ppchan)		// Returns true if found.
+			{ return (*ppchan = (ChanBounds*)Find(pszSuffix, Bounds)) != NULL; }
+		bool Get(const char* pszSuffix, ChanTransform** ppchan)	// Returns true if found.
+			{ return (*ppchan = (ChanTransform*)Find(pszSuffix, Transforms)) != NULL; }
+		bool Get(const char* pszSuffix, ChanEvent** ppchan)			// Returns true if found.
+			{ return (*ppchan = (ChanEvent*)Find(pszSuffix, Events)) != NULL; }
+
+		// Find out whether the specified channel is one of this pack's.
+		bool Has(							// Returns true if it is.
+			void*		pvChan);				// In:  Channel.
+
+		// Set how many sop frames to go for each one kept when saving (1, the
+		// default, keeps them all).  Skipped frames can be made up for by
+		// blending between the ones kept (see CAnim3D::GetSop()).
+		void SetKeyStep(
+			int16_t	sKeyStep)			// In:  Frames per frame kept.
+			{ m_sKeyStep = (sKeyStep > 1) ? sKeyStep : 1; }
+
+		// Get the number of channels.
+		int16_t GetNumChannels(void)
+			{ return m_sNumChannels; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Add a channel this pack doesn't own.
+		int16_t Add(						// Returns 0 on success.
+			const char*	pszSuffix,		// In:  Suffix.
+			Kind			kind,				// In:  Kind of channel.
+			void*			pvChan);			// In:  Channel.
+
+		// Find the channel with the specified suffix and kind.
+		void* Find(							// Returns the channel or NULL.
+			const char*	pszSuffix,		// In:  Suffix.
+			Kind			kind);			// In:  Kind of channel.
+
+		// Save a sop channel packed.
+		static int16_t SaveSops(		// Returns 0 on success.
+			RFile*		pfile,			// In:  File to save to.
+			ChanForm*	pchan,			// In:  Channel.
+			int16_t		sKeyStep,		// In:  Keep only every this many frames.
+			int32_t*		plNumPts);		// In/Out:  Number of points stored is added to this.
+
+		// Load a packed sop channel, putting its points at m_psPts + m_lPt.
+		int16_t LoadSops(					// Returns 0 on success.
+			RFile*		pfile,			// In:  File to load from.
+			ChanForm*	pchan);			// In:  Channel to fill in.
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		typedef struct
+			{
+			RString	strSuffix;			// Suffix this channel replaces.
+			Kind		kind;					// Kind of channel.
+			void*		pvChan;				// The channel.
+			} Channel;
+
+		Channel		m_achannels[MaxChannels];	// The channels.
+		int16_t		m_sNumChannels;				// Number of channels.
+		bool			m_bOwned;						// true if the channels are ours to delete.
+
+		int16_t*		m_psPts;							// All packed points for all sop channels.
+		int32_t		m_lNumPts;						// Number of points in m_psPts.
+		int32_t		m_lPt;							// Next point in m_psPts to fill while loading.
+
+		int16_t		m_sKeyStep;						// Sop frames to go for each one kept when saving.
+	};
+
+#endif	// ANIMPACK_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
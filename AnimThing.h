@@ -124,7 +124,7 @@ class CAnimThing : public CThing
 			CThing** ppNew)										// Out: Pointer to new object
 			{
 			int16_t sResult = 0;
-			*ppNew = new CAnimThing(pRealm);
+			*ppNew = new (pRealm, CAnimThingID) CAnimThing(pRealm);
 			if (*ppNew == 0)
 				{
 				sResult = -1;
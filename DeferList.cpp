@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// DeferList.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RSPiX.h"
+
+#include "DeferList.h"
+#include "realm.h"
+#include "thing.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CDeferList::CDeferList()
+	{
+	m_pitems		= NULL;
+	m_lNumItems	= 0;
+	m_lMaxItems	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CDeferList::~CDeferList()
+	{
+	ASSERT(m_lNumItems == 0);
+
+	if (m_pitems != NULL)
+		{
+		free(m_pitems);
+		m_pitems	= NULL;
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Send a message once the list is applied.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CDeferList::AddMessage(	// Returns 0 on success.
+	CThing*			pthing,			// In:  Sender.
+	GameMessage*	pmsg,				// In:  Message to send.
+	U16				u16ID)			// In:  ID of thing to send it to.
+	{
+	Item*	pitem	= Add(Message);
+	if (pitem == NULL)
+		return -1;
+
+	pitem->pthing	= pthing;
+	pitem->msg		= *pmsg;
+	pitem->u16ID	= u16ID;
+
+	return 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Update a smash once the list is applied.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CDeferList::AddSmashUpdate(	// Returns 0 on success.
+	CSmash*	psmash)						// In:  Smash to update.
+	{
+	Item*	pitem	= Add(SmashUpdate);
+	if (pitem == NULL)
+		return -1;
+
+	pitem->psmash	= psmash;
+
+	return 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Remove a smash once the list is applied.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CDeferList::AddSmashRemove(	// Returns 0 on success.
+	CSmash*	psmash)						// In:  Smash to remove.
+	{
+	Item*	pitem	= Add(SmashRemove);
+	if (pitem == NULL)
+		return -1;
+
+	pitem->psmash	= psmash;
+
+	return 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Call the thing's DoDeferred() once the list is applied.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CDeferList::AddCall(		// Returns 0 on success.
+	CThing*	pthing,					// In:  Thing to call.
+	int32_t	lCode)					// In:  Passed to DoDeferred().
+	{
+	Item*	pitem	= Add(Call);
+	if (pitem == NULL)
+		return -1;
+
+	pitem->pthing	= pthing;
+	pitem->lCode	= lCode;
+
+	return 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Delete the thing once the list is applied.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CDeferList::AddDelete(	// Returns 0 on success.
+	CThing*	pthing)					// In:  Thing to delete.
+	{
+	Item*	pitem	= Add(Delete);
+	if (pitem == NULL)
+		return -1;
+
+	pitem->pthing	= pthing;
+
+	return 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Apply everything in the order it was added and empty the list.
+//////////////////////////////////////////////////////////////////////////////
+void CDeferList::Apply(				// Returns nothing.
+	CRealm*	prealm)					// In:  Realm the items belong to.
+	{
+	int32_t	l;
+	for (l = 0; l < m_lNumItems; l++)
+		{
+		Item*	pitem	= &m_pitems[l];
+		switch (pitem->kind)
+			{
+			case Message:
+				pitem->pthing->SendThingMessage(&pitem->msg, pitem->u16ID);
+				break;
+			case SmashUpdate:
+				prealm->m_smashatorium.Update(pitem->psmash);
+				break;
+			case SmashRemove:
+				prealm->m_smashatorium.Remove(pitem->psmash);
+				break;
+			case Call:
+				pitem->pthing->DoDeferred(pitem->lCode);
+				break;
+			case Delete:
+				delete pitem->pthing;
+				break;
+			}
+		}
+
+	m_lNumItems	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get a new item at the end of the list, growing it if necessary.
+//////////////////////////////////////////////////////////////////////////////
+CDeferList::Item* CDeferList::Add(	// Returns item or NULL, if out of memory.
+	Kind	kind)								// In:  Kind of item.
+	{
+	if (m_lNumItems >= m_lMaxItems)
+		{
+		Item*	pitems	= (Item*)realloc(m_pitems, (m_lMaxItems + GrowBy) * sizeof(Item));
+		if (pitems == NULL)
+			{
+			TRACE("Add(): realloc() failed.\n");
+			return NULL;
+			}
+
+		m_pitems		= pitems;
+		m_lMaxItems	+= GrowBy;
+		}
+
+	Item*	pitem	= &m_pitems[m_lNumItems++];
+	pitem->kind		= kind;
+	pitem->pthing	= NULL;
+	pitem->psmash	= NULL;
+	pitem->u16ID	= 0;
+	pitem->lCode	= 0;
+
+	return pitem;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// DeferList.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CDeferList records side effects that can't happen on a worker thread
+// (messages, smash updates and removals, deleting things, and anything else
+// through a call back to the thing, such as spawning or smash queries) so the
+// main thread can apply them later in the order they were recorded.
+//
+// The realm keeps one list per piece of the parallel update phase.  Pieces
+// are contiguous runs of the things it gathered, so applying the lists in
+// piece order applies every thing's side effects in the same order no matter
+// how many threads did the work.
+//
+// Items from one thing are applied together, in the order it added them.
+// Calls and deletes must be for the thing adding them, and a delete must be
+// the last thing it adds.  Messages go by ID so a target deleted by an
+// earlier item just doesn't get its message.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFERLIST_H
+#define DEFERLIST_H
+
+#include "RSPiX.h"
+#include "message.h"
+
+class CThing;
+class CSmash;
+class CRealm;
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CDeferList
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		typedef enum
+			{
+			Message,			// Send msg from pthing to u16ID.
+			SmashUpdate,	// Update psmash in the smashatorium.
+			SmashRemove,	// Remove psmash from the smashatorium.
+			Call,				// Call pthing->DoDeferred(lCode).
+			Delete			// Delete pthing.
+			} Kind;
+
+		enum
+			{
+			GrowBy	= 64		// Number of items to grow by when full.
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+		struct Item
+			{
+			Kind				kind;		// What to do.
+			CThing*			pthing;	// Thing that added it (Message, Call, Delete).
+			CSmash*			psmash;	// Smash (SmashUpdate, SmashRemove).
+			U16				u16ID;	// Target (Message).
+			int32_t			lCode;	// Code (Call).
+			GameMessage		msg;		// Message (Message).
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CDeferList();
+
+		// Destructor.
+		~CDeferList();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Send a message once the list is applied.
+		int16_t AddMessage(			// Returns 0 on success.
+			CThing*			pthing,		// In:  Sender.
+			GameMessage*	pmsg,			// In:  Message to send.
+			U16				u16ID);		// In:  ID of thing to send it to.
+
+		// Update a smash once the list is applied.
+		int16_t AddSmashUpdate(		// Returns 0 on success.
+			CSmash*	psmash);				// In:  Smash to update.
+
+		// Remove a smash once the list is applied.
+		int16_t AddSmashRemove(		// Returns 0 on success.
+			CSmash*	psmash);				// In:  Smash to remove.
+
+		// Call the thing's DoDeferred() once the list is applied.
+		int16_t AddCall(				// Returns 0 on success.
+			CThing*	pthing,				// In:  Thing to call.
+			int32_t	lCode);				// In:  Passed to DoDeferred().
+
+		// Delete the thing once the list is applied.
+		int16_t AddDelete(			// Returns 0 on success.
+			CThing*	pthing);				// In:  Thing to delete.
+
+		// Apply everything in the order it was added and empty the list.
+		void Apply(						// Returns nothing.
+			CRealm*	prealm);				// In:  Realm the items belong to.
+
+		// Get the number of items waiting.
+		int32_t GetNumItems(void)
+			{ return m_lNumItems; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Get a new item at the end of the list, growing it if necessary.
+		Item* Add(						// Returns item or NULL, if out of memory.
+			Kind	kind);					// In:  Kind of item.
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		Item*		m_pitems;		// Items, in the order added.
+		int32_t	m_lNumItems;	// Number of items waiting.
+		int32_t	m_lMaxItems;	// Room in m_pitems.
+	};
+
+#endif	// DEFERLIST_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
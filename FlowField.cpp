@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// FlowField.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RSPiX.h"
+
+#include "FlowField.h"
+#include "realm.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Module specific (static) variables.
+//////////////////////////////////////////////////////////////////////////////
+
+// Directions go counterclockwise starting at +X, the same way rotations do
+// (note that -Z is "up" on the X/Z plane).  Opposite directions are always
+// NumDirs / 2 apart.
+const int16_t	CFlowField::ms_asDirX[NumDirs]		= { 1,  1,  0, -1, -1, -1,  0,  1 };
+const int16_t	CFlowField::ms_asDirZ[NumDirs]		= { 0, -1, -1, -1,  0,  1,  1,  1 };
+const double	CFlowField::ms_adDirRot[NumDirs]	= { 0, 45, 90, 135, 180, 225, 270, 315 };
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CFlowField::CFlowField()
+	{
+	m_pu8Dirs		= NULL;
+	m_psHeights		= NULL;
+	m_plQueue		= NULL;
+	Reset();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CFlowField::~CFlowField()
+	{
+	Reset();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Set up a new field toward the specified goal.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CFlowField::Setup(			// Returns 0 on success.
+	CRealm*	prealm,					// In:  Realm whose terrain to follow.
+	int16_t	sGoalX,					// In:  Goal's X position.
+	int16_t	sGoalZ,					// In:  Goal's Z position.
+	int16_t	sMaxStepUp)				// In:  Max height a walker can step up.
+	{
+	int16_t	sResult	= 0;
+
+	Reset();
+
+	m_prealm			= prealm;
+	m_sMaxStepUp	= sMaxStepUp;
+	m_sCellsW		= (prealm->GetRealmWidth() + CellSize - 1) / CellSize;
+	m_sCellsH		= (prealm->GetRealmHeight() + CellSize - 1) / CellSize;
+	m_sGoalCellX	= sGoalX / CellSize;
+	m_sGoalCellZ	= sGoalZ / CellSize;
+
+	if (m_sCellsW > 0 && m_sCellsH > 0
+		&& m_sGoalCellX >= 0 && m_sGoalCellX < m_sCellsW
+		&& m_sGoalCellZ >= 0 && m_sGoalCellZ < m_sCellsH)
+		{
+		int32_t	lNumCells	= (int32_t)m_sCellsW * m_sCellsH;
+		m_pu8Dirs	= (uint8_t*)malloc(lNumCells * sizeof(uint8_t));
+		m_psHeights	= (int16_t*)malloc(lNumCells * sizeof(int16_t));
+		m_plQueue	= (int32_t*)malloc(lNumCells * sizeof(int32_t));
+		if (m_pu8Dirs != NULL && m_psHeights != NULL && m_plQueue != NULL)
+			{
+			int32_t	l;
+			for (l = 0; l < lNumCells; l++)
+				{
+				m_pu8Dirs[l]	= DirNone;
+				m_psHeights[l]	= HeightUnknown;
+				}
+
+			// Seed the build with the goal.
+			int32_t	lGoal	= (int32_t)m_sGoalCellZ * m_sCellsW + m_sGoalCellX;
+			m_pu8Dirs[lGoal]				= DirGoal;
+			m_plQueue[m_lQueueTail++]	= lGoal;
+			}
+		else
+			{
+			TRACE("Setup(): Failed to allocate %ld cells.\n", (long)lNumCells);
+			sResult	= -1;
+			}
+		}
+	else
+		{
+		TRACE("Setup(): Goal (%hd, %hd) is outside the realm.\n", sGoalX, sGoalZ);
+		sResult	= -2;
+		}
+
+	if (sResult != 0)
+		{
+		Reset();
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Free the field.
+//////////////////////////////////////////////////////////////////////////////
+void CFlowField::Reset(void)
+	{
+	FreeBuildData();
+
+	if (m_pu8Dirs != NULL)
+		{
+		free(m_pu8Dirs);
+		m_pu8Dirs	= NULL;
+		}
+
+	m_prealm			= NULL;
+	m_sCellsW		= 0;
+	m_sCellsH		= 0;
+	m_sGoalCellX	= -1;
+	m_sGoalCellZ	= -1;
+	m_sMaxStepUp	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Free the scratch memory that is only needed while building.
+//////////////////////////////////////////////////////////////////////////////
+void CFlowField::FreeBuildData(void)
+	{
+	if (m_psHeights != NULL)
+		{
+		free(m_psHeights);
+		m_psHeights	= NULL;
+		}
+
+	if (m_plQueue != NULL)
+		{
+		free(m_plQueue);
+		m_plQueue	= NULL;
+		}
+
+	m_lQueueHead	= 0;
+	m_lQueueTail	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get the height of a cell, sampling the terrain at the cell's center the
+// first time it's needed.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CFlowField::CellHeight(	// Returns height or HeightNoWalk.
+	int16_t	sCellX,					// In:  Cell's X.
+	int16_t	sCellZ)					// In:  Cell's Z.
+	{
+	int16_t*	psHeight	= &m_psHeights[(int32_t)sCellZ * m_sCellsW + sCellX];
+	if (*psHeight == HeightUnknown)
+		{
+		bool	bNoWalk;
+		int16_t	sH	= m_prealm->GetHeightAndNoWalk(
+			sCellX * CellSize + CellSize / 2,
+			sCellZ * CellSize + CellSize / 2,
+			&bNoWalk);
+
+		*psHeight	= (bNoWalk == true) ? (int16_t)HeightNoWalk : sH;
+		}
+
+	return *psHeight;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Extend the field by up to the specified number of cells.  Each cell taken
+// off the queue points every unreached, walkable neighbor back at itself.
+// A walker must be able to step up from the neighbor into the cell, and may
+// only cut a corner diagonally when both cells beside the corner are
+// walkable.  Once the queue runs dry the field is complete and the scratch
+// memory is freed.
+//////////////////////////////////////////////////////////////////////////////
+int32_t CFlowField::Build(			// Returns number of cells processed.
+	int32_t	lMaxCells)				// In:  Max cells to process.
+	{
+	int32_t	lProcessed	= 0;
+
+	while (lProcessed < lMaxCells && m_lQueueHead < m_lQueueTail)
+		{
+		int32_t	lCell		= m_plQueue[m_lQueueHead++];
+		int16_t	sCellX	= (int16_t)(lCell % m_sCellsW);
+		int16_t	sCellZ	= (int16_t)(lCell / m_sCellsW);
+		int16_t	sHeight	= CellHeight(sCellX, sCellZ);
+
+		int16_t	sDir;
+		for (sDir = 0; sDir < NumDirs; sDir++)
+			{
+			int16_t	sNextX	= sCellX + ms_asDirX[sDir];
+			int16_t	sNextZ	= sCellZ + ms_asDirZ[sDir];
+			if (sNextX < 0 || sNextX >= m_sCellsW || sNextZ < 0 || sNextZ >= m_sCellsH)
+				continue;
+
+			int32_t	lNext	= (int32_t)sNextZ * m_sCellsW + sNextX;
+			if (m_pu8Dirs[lNext] != DirNone)
+				continue;
+
+			int16_t	sNextHeight	= CellHeight(sNextX, sNextZ);
+			if (sNextHeight == HeightNoWalk)
+				continue;
+
+			// Goal cell may be unwalkable (e.g., a bouy against a wall), in which
+			// case we just let its neighbors in.
+			if (sHeight != HeightNoWalk && sHeight - sNextHeight > m_sMaxStepUp)
+				continue;
+
+			// Diagonal moves can't squeeze between two blocked cells.
+			if (ms_asDirX[sDir] != 0 && ms_asDirZ[sDir] != 0)
+				{
+				if (CellHeight(sNextX, sCellZ) == HeightNoWalk || CellHeight(sCellX, sNextZ) == HeightNoWalk)
+					continue;
+				}
+
+			// The neighbor steps back the opposite way to get here.
+			m_pu8Dirs[lNext]				= (uint8_t)((sDir + NumDirs / 2) % NumDirs);
+			m_plQueue[m_lQueueTail++]	= lNext;
+			}
+
+		lProcessed++;
+		}
+
+	// Don't need the scratch memory once we've reached everything we can.
+	if (m_lQueueHead >= m_lQueueTail)
+		{
+		FreeBuildData();
+		}
+
+	return lProcessed;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get the direction to walk from the specified position.
+//////////////////////////////////////////////////////////////////////////////
+bool CFlowField::GetDirection(	// Returns true if the field covers the position
+											// and it is not in the goal cell.
+	double	dX,						// In:  X position.
+	double	dZ,						// In:  Z position.
+	double*	pdRot)					// Out: Direction (rotation around Y axis).
+	{
+	bool	bFound	= false;
+
+	if (m_pu8Dirs != NULL && dX >= 0 && dZ >= 0)
+		{
+		int16_t	sCellX	= (int16_t)(dX / CellSize);
+		int16_t	sCellZ	= (int16_t)(dZ / CellSize);
+		if (sCellX < m_sCellsW && sCellZ < m_sCellsH)
+			{
+			uint8_t	u8Dir	= m_pu8Dirs[(int32_t)sCellZ * m_sCellsW + sCellX];
+			if (u8Dir < NumDirs)
+				{
+				*pdRot	= ms_adDirRot[u8Dir];
+				bFound	= true;
+				}
+			}
+		}
+
+	return bFound;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
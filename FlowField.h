@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// FlowField.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// A flow field covers the realm's X/Z plane with a coarse grid of cells and
+// stores, for each cell, which neighboring cell is the next step on the
+// shortest walkable path to a single goal.  Any number of agents headed for
+// the same goal can share one field and simply steer in the direction of the
+// cell they are standing in, instead of each probing the terrain themselves.
+//
+// The field is built breadth-first outward from the goal, a limited number of
+// cells at a time (see Build()), so the cost of a new field is spread across
+// several updates.  Cells the build has not reached yet report no direction
+// and the caller is expected to fall back on its usual navigation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "RSPiX.h"
+
+class CRealm;
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CFlowField
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			CellSize		= 16,		// Size of a cell on the X/Z plane in realm units.
+			NumDirs		= 8,		// Number of directions (one per neighbor).
+			DirGoal		= 0xFE,	// Cell contains the goal.
+			DirNone		= 0xFF,	// Cell has not been reached (yet).
+			HeightUnknown	= -32768,	// Cell's height has not been sampled.
+			HeightNoWalk	= -32767		// Cell is not walkable.
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CFlowField();
+
+		// Destructor.
+		~CFlowField();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Set up a new field toward the specified goal.  The field starts out
+		// empty except for the goal cell.  Call Build() to fill it in.
+		int16_t Setup(						// Returns 0 on success.
+			CRealm*	prealm,				// In:  Realm whose terrain to follow.
+			int16_t	sGoalX,				// In:  Goal's X position.
+			int16_t	sGoalZ,				// In:  Goal's Z position.
+			int16_t	sMaxStepUp);		// In:  Max height a walker can step up.
+
+		// Free the field.
+		void Reset(void);
+
+		// Extend the field by up to the specified number of cells.
+		int32_t Build(						// Returns number of cells processed.
+			int32_t	lMaxCells);			// In:  Max cells to process.
+
+		// Get the direction to walk from the specified position.
+		bool GetDirection(				// Returns true if the field covers the position
+												// and it is not in the goal cell.
+			double	dX,					// In:  X position.
+			double	dZ,					// In:  Z position.
+			double*	pdRot);				// Out: Direction (rotation around Y axis).
+
+		// Determine whether this field leads to the specified goal.
+		bool IsGoal(						// Returns true if the goal is in the same cell.
+			int16_t	sGoalX,				// In:  Goal's X position.
+			int16_t	sGoalZ)				// In:  Goal's Z position.
+			{
+			return m_pu8Dirs != NULL && (sGoalX / CellSize) == m_sGoalCellX && (sGoalZ / CellSize) == m_sGoalCellZ;
+			}
+
+		// Determine whether the build has reached every reachable cell.
+		bool IsComplete(void)			// Returns true when there's nothing left to build.
+			{
+			return m_lQueueHead >= m_lQueueTail;
+			}
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Get the height of a cell, sampling the terrain the first time.
+		int16_t CellHeight(				// Returns height or HeightNoWalk.
+			int16_t	sCellX,				// In:  Cell's X.
+			int16_t	sCellZ);				// In:  Cell's Z.
+
+		// Free the scratch memory that is only needed while building.
+		void FreeBuildData(void);
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		CRealm*	m_prealm;				// Realm whose terrain we follow.
+		int16_t	m_sCellsW;				// Width of grid in cells.
+		int16_t	m_sCellsH;				// Height of grid in cells.
+		int16_t	m_sGoalCellX;			// Goal's cell.
+		int16_t	m_sGoalCellZ;			// Goal's cell.
+		int16_t	m_sMaxStepUp;			// Max height a walker can step up.
+
+		uint8_t*	m_pu8Dirs;				// Direction for each cell (see NumDirs, DirGoal, DirNone).
+
+		int16_t*	m_psHeights;			// Cached height for each cell while building.
+		int32_t*	m_plQueue;				// Breadth-first queue of cell indices while building.
+		int32_t	m_lQueueHead;			// Next cell to process.
+		int32_t	m_lQueueTail;			// End of queue.
+
+		// Offsets and rotations for each direction.
+		static const int16_t	ms_asDirX[NumDirs];
+		static const int16_t	ms_asDirZ[NumDirs];
+		static const double	ms_adDirRot[NumDirs];
+	};
+
+#endif	// FLOWFIELD_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -289,6 +289,16 @@ CGameSettings::CGameSettings(void)
 	m_sParticleEffects			= TRUE;
 	m_sVolumeDistance				= TRUE;
 	m_sPlayAmbientSounds			= TRUE;
+	m_sAIUpdateBuckets			= 1;
+	m_sFlowFieldNav				= FALSE;
+	m_sBatchUpdate					= FALSE;
+	m_sUpdateThreads				= 0;
+	m_sFixedStepTime				= 0;
+	m_sRenderCacheKB				= 0;
+	m_sImpostors					= FALSE;
+	m_sAnimPacks					= 0;
+	m_sAnimKeyStep					= 1;
+	m_sBlendAnims					= FALSE;
 										
 	m_sDisplayInfo					= FALSE;
 										
@@ -299,6 +309,7 @@ CGameSettings::CGameSettings(void)
 	m_sTrickySystemQuit			= FALSE;
 
 	m_szSynchLogFile[0]			= '\0';
+	m_szTelemetryFile[0]			= '\0';
 
 	m_dGameFilmScale				= 1.0;	// 100%
 	
@@ -546,9 +557,30 @@ int16_t CGameSettings::LoadPrefs(
 	pPrefs->GetVal("Features", "ParticleEffects", m_sParticleEffects, &m_sParticleEffects);
 	pPrefs->GetVal("Features", "VolumeDistance", m_sVolumeDistance, &m_sVolumeDistance);
 	pPrefs->GetVal("Features", "PlayAmbientSounds", m_sPlayAmbientSounds, &m_sPlayAmbientSounds);
+	pPrefs->GetVal("Features", "AIUpdateBuckets", m_sAIUpdateBuckets, &m_sAIUpdateBuckets);
+	if (m_sAIUpdateBuckets < 1)
+		m_sAIUpdateBuckets = 1;
+	pPrefs->GetVal("Features", "FlowFieldNav", m_sFlowFieldNav, &m_sFlowFieldNav);
+	pPrefs->GetVal("Features", "BatchUpdate", m_sBatchUpdate, &m_sBatchUpdate);
+	pPrefs->GetVal("Features", "UpdateThreads", m_sUpdateThreads, &m_sUpdateThreads);
+	if (m_sUpdateThreads < 0)
+		m_sUpdateThreads = 0;
+	pPrefs->GetVal("Features", "FixedStepTime", m_sFixedStepTime, &m_sFixedStepTime);
+	if (m_sFixedStepTime < 0)
+		m_sFixedStepTime = 0;
+	pPrefs->GetVal("Features", "RenderCacheKB", m_sRenderCacheKB, &m_sRenderCacheKB);
+	if (m_sRenderCacheKB < 0)
+		m_sRenderCacheKB = 0;
+	pPrefs->GetVal("Features", "Impostors", m_sImpostors, &m_sImpostors);
+	pPrefs->GetVal("Features", "AnimPacks", m_sAnimPacks, &m_sAnimPacks);
+	pPrefs->GetVal("Features", "AnimKeyStep", m_sAnimKeyStep, &m_sAnimKeyStep);
+	if (m_sAnimKeyStep < 1)
+		m_sAnimKeyStep = 1;
+	pPrefs->GetVal("Features", "BlendAnims", m_sBlendAnims, &m_sBlendAnims);
 
 	pPrefs->GetVal("Debug", "DisplayInfo", m_sDisplayInfo, &m_sDisplayInfo);
 	pPrefs->GetVal("Debug", "IfLog", m_szSynchLogFile, m_szSynchLogFile);
+	pPrefs->GetVal("Debug", "TelemetryFile", m_szTelemetryFile, m_szTelemetryFile);
 
 	pPrefs->GetVal("Can", "TakeSnapShots", m_sCanTakeSnapShots, &m_sCanTakeSnapShots);
 
@@ -671,8 +703,16 @@ int16_t CGameSettings::PreDemo(
 	{
 	pFile->Write(&m_sDifficulty);
 	pFile->Write(&m_sViolence);
+	pFile->Write(&m_sAIUpdateBuckets);
+	pFile->Write(&m_sFlowFieldNav);
+	pFile->Write(&m_sBatchUpdate);
 	m_sDifficulty = 10;
 	m_sViolence = 11;
+	// Demos were recorded with every agent updating every frame, in
+	// creation order, and steering on its own.
+	m_sAIUpdateBuckets = 1;
+	m_sFlowFieldNav = FALSE;
+	m_sBatchUpdate = FALSE;
 	return 0;
 	}
 
@@ -685,6 +725,9 @@ int16_t CGameSettings::PostDemo(
 	{
 	pFile->Read(&m_sDifficulty);
 	pFile->Read(&m_sViolence);
+	pFile->Read(&m_sAIUpdateBuckets);
+	pFile->Read(&m_sFlowFieldNav);
+	pFile->Read(&m_sBatchUpdate);
 	return 0;
 	}
 
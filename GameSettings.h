@@ -207,6 +207,27 @@ class CGameSettings : CSettings
 		int16_t		m_sParticleEffects;						// TRUE, if particle effects are to be used.
 		int16_t		m_sVolumeDistance;						// TRUE, if volume varied by distance is on.
 		int16_t		m_sPlayAmbientSounds;					// TRUE, if we should play ambient sounds.
+		int16_t		m_sAIUpdateBuckets;						// Idle AI far from any dude runs once every this
+																	// many realm updates (1 runs it every update).
+		int16_t		m_sFlowFieldNav;							// TRUE, if crowds share flow fields to navigate.
+		int16_t		m_sBatchUpdate;							// TRUE, if projectiles and effects update in
+																	// per-class passes after everything else.
+		int16_t		m_sUpdateThreads;							// Extra threads for the parallel update phase
+																	// (0 for none).
+		int16_t		m_sFixedStepTime;							// Milliseconds per simulation step in single
+																	// player (0 to let time flow freely).
+		int16_t		m_sRenderCacheKB;							// KB of rendered 3D sprites to keep for
+																	// reuse (0 for none).
+		int16_t		m_sImpostors;								// TRUE, if enemies and victims can be baked
+																	// into the render cache as impostors.
+		int16_t		m_sAnimPacks;								// 3D animations come from their loose files (0),
+																	// from .anim packs where there are any (1), or
+																	// the same but writing packs for any that were
+																	// loose (2).
+		int16_t		m_sAnimKeyStep;							// Packs written keep only every this many sop
+																	// frames (1 keeps them all).
+		int16_t		m_sBlendAnims;								// TRUE, if 3D characters blend their points
+																	// between key sops.
 																
 		int16_t		m_sDisplayInfo;							// TRUE, to show display info.
 																
@@ -217,6 +238,7 @@ class CGameSettings : CSettings
 		int16_t		m_sTrickySystemQuit;						// TRUE, to use 'trickier' system quit.
 
 		char		m_szSynchLogFile[RSP_MAX_PATH];		// If not "", logs if's to specified file.
+		char		m_szTelemetryFile[RSP_MAX_PATH];		// If not "", writes realm telemetry to specified file.
 
 		double	m_dGameFilmScale;							// Percentage of default film size for Play mode.
 																	// For example, if 50, what was normally displayed on 640x480
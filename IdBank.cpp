@@ -91,99 +91,126 @@
 
 //////////////////////////////////////////////////////////////////////////////
 //
-// Helper to insert an ID into a particular list.
+// Helper to add an ID to the end of the free list.
 //
 //////////////////////////////////////////////////////////////////////////////
-void CIdBank::Insert(	// Returns nothing.
-	U16	u16Id,			// ID to insert.
-	U16*	pu16IdHead)		// Head of list to add to.
+void CIdBank::Add(	// Returns nothing.
+	U16	u16Id)		// ID to add.
 	{
-	// Point this node's next at the current head of the free list.
-	m_aids[u16Id].u16IdNext			= *pu16IdHead;
-	// If there is a head . . .
-	if (*pu16IdHead != IdNil)
+	// Point this node's prev at the current tail of the free list.
+	m_pids[u16Id].u16IdPrev			= m_u16TailFreeId;
+	// If there is a tail . . .
+	if (m_u16TailFreeId != IdNil)
+		{
+		// Point current tail node's next at this node.
+		m_pids[m_u16TailFreeId].u16IdNext	= u16Id;
+		}
+	else
 		{
-		// Point current head node's prev at this node.
-		m_aids[*pu16IdHead].u16IdPrev	= u16Id;
+		// Only node.
+		m_u16HeadFreeId	= u16Id;
 		}
 
-	// Don't look back.
-	m_aids[u16Id].u16IdPrev	= IdNil;
+	// Don't look forward.
+	m_pids[u16Id].u16IdNext	= IdNil;
+	m_pids[u16Id].bFreeList	= true;
 
-	// Make this node the new head of the list.
-	*pu16IdHead								= u16Id;
+	// Make this node the new tail of the list.
+	m_u16TailFreeId			= u16Id;
 	}
 
 //////////////////////////////////////////////////////////////////////////////
 //
-// Helper to add an ID to a particular list.
+// Helper to remove an ID from the free list.
 //
 //////////////////////////////////////////////////////////////////////////////
-void CIdBank::Add(	// Returns nothing.
-	U16	u16Id,		// ID to add.
-	U16*	pu16IdTail)	// Tail of list to add to.
+void CIdBank::Remove(	// Returns nothing.
+	U16	u16Id)			// ID to remove.
 	{
-	// Point this node's prev at the current tail of the free list.
-	m_aids[u16Id].u16IdPrev			= *pu16IdTail;
-	// If there is a head . . .
-	if (*pu16IdTail != IdNil)
-		{
-		// Point current tail node's next at this node.
-		m_aids[*pu16IdTail].u16IdNext	= u16Id;
-		}
+	U16	u16IdNext	= m_pids[u16Id].u16IdNext;
+	U16	u16IdPrev	= m_pids[u16Id].u16IdPrev;
 
-	// Don't look forward.
-	m_aids[u16Id].u16IdNext	= IdNil;
+	if (u16IdPrev != IdNil)
+		m_pids[u16IdPrev].u16IdNext	= u16IdNext;
+	else
+		m_u16HeadFreeId					= u16IdNext;
 
-	// Make this node the new tail of the list.
-	*pu16IdTail								= u16Id;
+	if (u16IdNext != IdNil)
+		m_pids[u16IdNext].u16IdPrev	= u16IdPrev;
+	else
+		m_u16TailFreeId					= u16IdPrev;
+
+	m_pids[u16Id].bFreeList	= false;
 	}
 
 //////////////////////////////////////////////////////////////////////////////
 //
-// Helper to remove an ID from a particular list.
+// Make sure there's storage for the specified ID.
 //
 //////////////////////////////////////////////////////////////////////////////
-void CIdBank::Remove(	// Returns nothing.
-	U16	u16Id,			// ID to remove.
-	U16*	pu16IdHead,		// Head of list to remove from.
-	U16*	pu16IdTail)		// Tail of list to remove from.
+int16_t CIdBank::Reserve(	// Returns 0 on success.
+	U16	u16Id)				// ID to make room for.
 	{
-	// If this was the head . . .
-	if (*pu16IdHead == u16Id)
+	int16_t	sRes	= 0;	// Assume success.
+
+	if (u16Id >= m_lNumAllocated)
 		{
-		// Make the head this node's next.
-		*pu16IdHead	= m_aids[u16Id].u16IdNext;
-		// If not the end . . .
-		if (*pu16IdHead != IdNil)
+		int32_t	lNum	= ((u16Id / GrowIds) + 1) * GrowIds;
+		if (lNum > MaxIds)
+			lNum	= MaxIds;
+
+		IdNode*	pids	= (IdNode*)realloc(m_pids, lNum * sizeof(IdNode));
+		if (pids != NULL)
 			{
-			// Make the new head's prev NIL.
-			m_aids[*pu16IdHead].u16IdPrev	= IdNil;
+			int32_t	l;
+			for (l = m_lNumAllocated; l < lNum; l++)
+				{
+				pids[l].pthing				= NULL;
+				pids[l].u16IdNext			= IdNil;
+				pids[l].u16IdPrev			= IdNil;
+				pids[l].u16Generation	= 0;
+				pids[l].bFreeList			= false;
+				}
+
+			m_pids				= pids;
+			m_lNumAllocated	= lNum;
+			}
+		else
+			{
+			TRACE("Reserve(): Unable to grow to %ld IDs.\n", (long)lNum);
+			sRes	= -1;
 			}
-		}
-	else
-		{
-		// Set prev's next to this ID's next.
-		m_aids[m_aids[u16Id].u16IdPrev].u16IdNext	= m_aids[u16Id].u16IdNext;
 		}
 
-	// If this was the tail . . .
-	if (*pu16IdTail == u16Id)
+	return sRes;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Get the next fresh ID below the specified limit, skipping any that have
+// been taken (or taken and released) out of order.
+//
+//////////////////////////////////////////////////////////////////////////////
+int16_t CIdBank::GetFresh(	// Returns 0 on success.
+	int32_t	lLimit,			// In:  Get only IDs below this.
+	U16*		pu16ID)			// Out: ID.
+	{
+	while (m_lNextFresh < lLimit)
 		{
-		// Make the tail this node's prev.
-		*pu16IdTail	= m_aids[u16Id].u16IdPrev;
-		// If not the beginning . . .
-		if (*pu16IdTail != IdNil)
+		U16	u16Id	= (U16)m_lNextFresh;
+		if (Reserve(u16Id) != 0)
+			return -1;
+
+		m_lNextFresh++;
+
+		if (m_pids[u16Id].pthing == NULL && m_pids[u16Id].bFreeList == false)
 			{
-			// Make the new tail's next NIL.
-			m_aids[*pu16IdTail].u16IdNext	= IdNil;
+			*pu16ID	= u16Id;
+			return 0;
 			}
 		}
-	else
-		{
-		// Set next's prev to this ID's prev.
-		m_aids[m_aids[u16Id].u16IdNext].u16IdPrev	= m_aids[u16Id].u16IdPrev;
-		}
+
+	return -1;
 	}
 
 //////////////////////////////////////////////////////////////////////////////
@@ -194,25 +221,21 @@ void CIdBank::Remove(	// Returns nothing.
 //////////////////////////////////////////////////////////////////////////////
 void CIdBank::Reset(void)
 	{
-	// Reset all IDs.
-	// Initialize all IDs regardless of current contents.
-	U16	u16Cur;
-	U16	u16Prev;
-	for (u16Cur	= 0, u16Prev = IdNil; u16Cur < NumIds; u16Cur++, u16Prev++)
+	// Reset all IDs.  Keep the storage; we'll likely need it again.
+	int32_t	l;
+	for (l = 0; l < m_lNumAllocated; l++)
 		{
-		m_aids[u16Cur].u16IdPrev	= u16Prev;
-		m_aids[u16Cur].u16IdNext	= u16Cur + 1;
-		m_aids[u16Cur].pthing		= NULL;
+		m_pids[l].pthing				= NULL;
+		m_pids[l].u16IdNext			= IdNil;
+		m_pids[l].u16IdPrev			= IdNil;
+		m_pids[l].u16Generation		= 0;
+		m_pids[l].bFreeList			= false;
 		}
 
-	// Last item's next should indicate end.
-	m_aids[u16Prev].u16IdNext		= IdNil;
-
-	// Start at beginning for Free List head.
-	m_u16HeadFreeId	= 0;
-
-	// Start at end for Free List tail.
-	m_u16TailFreeId	= NumIds - 1;
+	// Nothing handed out or released.
+	m_lNextFresh		= 0;
+	m_u16HeadFreeId	= IdNil;
+	m_u16TailFreeId	= IdNil;
 	}
 
 //////////////////////////////////////////////////////////////////////////////
@@ -225,24 +248,30 @@ int16_t CIdBank::Get(	// Returns 0 on success.
 							// the ID table.
 	U16*		pu16ID)	// Out: ID for this particular CThing.
 	{
-	int16_t	sRes	= 0;	// Assume success.
-
-	// Make sure there's one left . . .
-	if (m_u16HeadFreeId != IdNil)
+	// Fresh ones first, then released ones, then fresh ones again if need be.
+	int16_t	sRes	= GetFresh(ReuseIds, pu16ID);
+	if (sRes != 0)
 		{
-		// Get ID.
-		*pu16ID	= m_u16HeadFreeId;
+		if (m_u16HeadFreeId != IdNil)
+			{
+			*pu16ID	= m_u16HeadFreeId;
+			Remove(*pu16ID);
+			sRes		= 0;
+			}
+		else
+			{
+			sRes	= GetFresh(MaxIds, pu16ID);
+			}
+		}
 
+	if (sRes == 0)
+		{
 		// Set IDs value.
-		m_aids[*pu16ID].pthing		= pthing;
-
-		// Remove from free list and get next head.
-		m_u16HeadFreeId	= m_aids[*pu16ID].u16IdNext;
+		m_pids[*pu16ID].pthing	= pthing;
 		}
 	else
 		{
 		TRACE("GetUniqueID(): Out of IDs!\n");
-		sRes	= -1;
 		}
 
 	return sRes;
@@ -260,22 +289,34 @@ int16_t CIdBank::Take(	// Returns 0 on success.
 	{
 	int16_t	sRes	= 0;	// Assume success.
 
-	// Range check.
-	ASSERT(u16ID < NumIds);
-
-	// Make sure the ID is available . . .
-	if (m_aids[u16ID].pthing == NULL)
+	// IdNil (and anything else past the end) can't be taken.
+	if (u16ID >= MaxIds)
 		{
-		// Set IDs value.
-		m_aids[u16ID].pthing		= pthing;
+		TRACE("TakeUniqueID(): ID %u is out of range!\n", (unsigned)u16ID);
+		sRes	= -3;
+		}
+	else if (Reserve(u16ID) == 0)
+		{
+		// Make sure the ID is available . . .
+		if (m_pids[u16ID].pthing == NULL)
+			{
+			// Set IDs value.
+			m_pids[u16ID].pthing		= pthing;
 
-		// Remove from free list.
-		Remove(u16ID, &m_u16HeadFreeId, &m_u16TailFreeId);
+			// Remove from free list, if it's there.
+			if (m_pids[u16ID].bFreeList == true)
+				Remove(u16ID);
+			}
+		else
+			{
+			TRACE("TakeUniqueID(): ID not available!\n");
+			sRes	= -1;
+			}
 		}
 	else
 		{
-		TRACE("TakeUniqueID(): ID not available!\n");
-		sRes	= -1;
+		TRACE("TakeUniqueID(): No room for ID!\n");
+		sRes	= -2;
 		}
 
 	return sRes;
@@ -293,55 +334,17 @@ void CIdBank::Release(	// Returns nothing.
 	if (u16ID != IdNil)
 		{
 		// Range check.
-		ASSERT(u16ID < NumIds);
+		ASSERT(u16ID < m_lNumAllocated);
 		// The ID should be in use.  If not, something has hosened.
-		ASSERT(m_aids[u16ID].pthing != NULL);
+		ASSERT(m_pids[u16ID].pthing != NULL);
 
-		// Clear ID.
-		m_aids[u16ID].pthing		= NULL;
+		// Clear ID.  Any handles to it are now stale.
+		m_pids[u16ID].pthing		= NULL;
+		m_pids[u16ID].u16Generation++;
 
 		// Add to free list.
-		Add(u16ID, &m_u16TailFreeId);
-		}
-	}
-
-//////////////////////////////////////////////////////////////////////////////
-//
-// Get a CThing via its ID.
-//
-//////////////////////////////////////////////////////////////////////////////
-int16_t CIdBank::GetThingByID(	// Returns 0 on success.
-	CThing**	ppthing,				// Out: Ptr to CThing identified by u16ID.
-	U16		u16ID)				// In:  ID of thing to get.
-	{
-	int16_t	sRes	= 0;	// Assume success.
-
-	if (u16ID != IdNil)
-		{
-		// Range check.
-		ASSERT(u16ID < NumIds);
-
-		// Get thing.
-		*ppthing	= m_aids[u16ID].pthing;
-		
-		// This ID should be used.
-		if (*ppthing != NULL)
-			{
-			// Success.
-			}
-		else
-			{
-//			TRACE("GetThingByID(): No such ID.\n");
-			sRes	= -2;
-			}
+		Add(u16ID);
 		}
-	else
-		{
-		*ppthing	= NULL;
-		sRes	= -1;
-		}
-
-	return sRes;
 	}
 
 ///////////////////////////////////////////////////////////////////////////////
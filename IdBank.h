@@ -31,6 +31,11 @@
 // Once an object gets an ID (which causes it to be registered in the ID
 // lookup table), it can be referenced by that ID.
 //
+// IDs stay 16 bits, since that's what gets saved, but the table only grows
+// as large as the IDs in use require.  Each ID also counts how many times
+// it's been released, so a Handle (ID plus that count) can tell when the
+// thing it referred to is gone, even if the ID has been reused since.
+//
 //////////////////////////////////////////////////////////////////////////////
 
 #ifndef IDBANK_H
@@ -83,8 +88,15 @@ class CIdBank
 //////////////////////////////////////////////////////////////////////////////
 		enum
 			{
-			NumIds	= 10000,
-			IdNil		= 0xFFFF
+			// Fresh IDs are handed out in order until this many have been.  After
+			// that, released IDs are reused (oldest first) before any more fresh
+			// ones.  Stale IDs held by things therefore take a long time to come
+			// back around.
+			ReuseIds		= 10000,
+			MaxIds		= 0xFFFF,	// IDs are 0 to MaxIds - 1.
+			GrowIds		= 1024,		// Storage grows by this many IDs at a time.
+			IdNil			= 0xFFFF,
+			HandleNil	= 0xFFFF		// Handle with IdNil in it.
 			};
 
 //////////////////////////////////////////////////////////////////////////////
@@ -93,11 +105,17 @@ class CIdBank
 		
 		typedef struct
 			{
-			CThing*	pthing;		// CThing associate with this ID.
-			U16		u16IdNext;	// Next ID in used or free list.
-			U16		u16IdPrev;	// Prev ID in used or free list.
+			CThing*	pthing;			// CThing associate with this ID.
+			U16		u16IdNext;		// Next ID in free list.
+			U16		u16IdPrev;		// Prev ID in free list.
+			U16		u16Generation;	// Number of times this ID has been released.
+			bool		bFreeList;		// true, if in the free list.
 			} IdNode;
 
+		// An ID in the low 16 bits and its generation in the high 16 bits.
+		// Only good for as long as the thing it was gotten for has the ID.
+		typedef uint32_t Handle;
+
 //////////////////////////////////////////////////////////////////////////////
 	public:	// Con/Destruction.
 //////////////////////////////////////////////////////////////////////////////
@@ -105,12 +123,19 @@ class CIdBank
 		// Default constructor.
 		CIdBank()
 			{
+			m_pids				= NULL;
+			m_lNumAllocated	= 0;
 			Reset();
 			}
 
 		// Destructor.
 		~CIdBank()
 			{
+			if (m_pids != NULL)
+				{
+				free(m_pids);
+				m_pids	= NULL;
+				}
 			}
 
 //////////////////////////////////////////////////////////////////////////////
@@ -127,7 +152,8 @@ class CIdBank
 			U16*		pu16ID);	// Out: ID for this particular CThing.
 
 		// Take a unique ID and associate it with a thing (CThing).
-		int16_t Take(				// Returns 0 on success.
+		int16_t Take(				// Returns 0 on success, -1 if taken, -2 if out of
+									// memory, -3 if out of range (e.g., IdNil).
 			CThing*	pthing,	// In:  Thing that wants to take an ID and be put in
 									// the ID table.
 			U16		u16ID);	// In:  ID for this particular CThing.
@@ -139,40 +165,92 @@ class CIdBank
 		// Get a CThing via its ID.
 		int16_t GetThingByID(	// Returns 0 on success.
 			CThing**	ppthing,	// Out: Ptr to CThing identified by u16ID.
-			U16		u16ID);	// In:  ID of thing to get.
+			U16		u16ID)	// In:  ID of thing to get.
+			{
+			if (u16ID < m_lNumAllocated)
+				{
+				*ppthing	= m_pids[u16ID].pthing;
+				return (*ppthing != NULL) ? 0 : -2;
+				}
+
+			*ppthing	= NULL;
+			return (u16ID == IdNil) ? -1 : -2;
+			}
+
+		// Get a handle to the thing currently using the specified ID.
+		Handle GetHandle(		// Returns handle or HandleNil, if ID isn't in use.
+			U16		u16ID)	// In:  ID of thing.
+			{
+			if (u16ID < m_lNumAllocated && m_pids[u16ID].pthing != NULL)
+				return ((Handle)m_pids[u16ID].u16Generation << 16) | u16ID;
+
+			return HandleNil;
+			}
+
+		// Get the ID in a handle.  IdNil for HandleNil.
+		static U16 GetIdFromHandle(	// Returns the ID.
+			Handle	handle)			// In:  Handle to get ID from.
+			{
+			return (U16)(handle & 0xFFFF);
+			}
+
+		// Get a CThing via a handle.  Fails if the thing the handle was gotten
+		// for has since released its ID, even if the ID is in use again.
+		int16_t GetThingByHandle(	// Returns 0 on success, -1 for HandleNil,
+											// -2 if stale.
+			CThing**	ppthing,		// Out: Ptr to CThing identified by handle.
+			Handle	handle)		// In:  Handle of thing to get.
+			{
+			U16	u16ID	= GetIdFromHandle(handle);
+			int16_t	sRes	= GetThingByID(ppthing, u16ID);
+			if (sRes == 0 && m_pids[u16ID].u16Generation != (U16)(handle >> 16))
+				{
+				*ppthing	= NULL;
+				sRes		= -2;
+				}
+
+			return sRes;
+			}
 
 //////////////////////////////////////////////////////////////////////////////
 	protected:	// Internal calls.
 //////////////////////////////////////////////////////////////////////////////
 
-		// Helper to insert an ID into a particular list.
-		void Insert(				// Returns nothing.
-			U16	u16Id,			// ID to insert.
-			U16*	pu16IdHead);	// Head of list to add to.
-		
-		// Helper to add an ID to a particular list.
+		// Helper to add an ID to the end of the free list.
 		void Add(					// Returns nothing.
-			U16	u16Id,			// ID to add.
-			U16*	pu16IdTail);	// Tail of list to add to.
+			U16	u16Id);			// ID to add.
 		
-		// Helper to remove an ID from a particular list.
+		// Helper to remove an ID from the free list.
 		void Remove(				// Returns nothing.
-			U16	u16Id,			// ID to remove.
-			U16*	pu16IdHead,		// Head of list to remove from.
-			U16*	pu16IdTail);	// Tail of list to remove from.
+			U16	u16Id);			// ID to remove.
+
+		// Make sure there's storage for the specified ID.
+		int16_t Reserve(			// Returns 0 on success.
+			U16	u16Id);			// ID to make room for.
+
+		// Get the next fresh ID below the specified limit.
+		int16_t GetFresh(			// Returns 0 on success.
+			int32_t	lLimit,		// In:  Get only IDs below this.
+			U16*		pu16ID);		// Out: ID.
 
 //////////////////////////////////////////////////////////////////////////////
 	protected:	// Internal variables.
 //////////////////////////////////////////////////////////////////////////////
 
-		// Bank of ID nodes.
-		IdNode	m_aids[NumIds];
+		// Bank of ID nodes.  Grown as needed.
+		IdNode*	m_pids;
+
+		// Number of ID nodes in m_pids.
+		int32_t	m_lNumAllocated;
+
+		// Next ID that has never been handed out.
+		int32_t	m_lNextFresh;
 
-		// Head of Free IDs.
+		// Head of released IDs.
 		U16		m_u16HeadFreeId;
-		// Tail of Free IDs.
-		U16		m_u16TailFreeId;
 
+		// Tail of released IDs.
+		U16		m_u16TailFreeId;
 	};
 
 #endif	// IDBANK_H
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// MessageQueue.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RSPiX.h"
+
+#include "MessageQueue.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CMsgPool::CMsgPool()
+	{
+	m_pblockHead		= NULL;
+	m_pnFree				= NULL;
+	m_lNumUsed			= 0;
+	m_lNumAllocated	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CMsgPool::~CMsgPool()
+	{
+	if (m_lNumUsed != 0)
+		{
+		TRACE("~CMsgPool(): %ld message(s) still queued!\n", (long)m_lNumUsed);
+		}
+
+	while (m_pblockHead != NULL)
+		{
+		Block*	pblock	= m_pblockHead;
+		m_pblockHead	= pblock->pNext;
+		free(pblock);
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Allocate another block of nodes and add them to the free list.
+//////////////////////////////////////////////////////////////////////////////
+void CMsgPool::Grow(void)
+	{
+	Block*	pblock	= (Block*)malloc(sizeof(Block));
+	if (pblock != NULL)
+		{
+		pblock->pNext	= m_pblockHead;
+		m_pblockHead	= pblock;
+
+		int16_t	s;
+		for (s = NodesPerBlock - 1; s >= 0; s--)
+			{
+			pblock->anodes[s].pNext	= m_pnFree;
+			m_pnFree						= &(pblock->anodes[s]);
+			}
+
+		m_lNumAllocated	+= NodesPerBlock;
+		}
+	else
+		{
+		TRACE("Grow(): Failed to allocate %hd message nodes.\n", (int16_t)NodesPerBlock);
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Enqueue the indicated message.  Walks the buckets (highest priority first)
+// to the first one whose priority isn't higher than ours, then either pushes
+// onto that bucket or starts a new bucket in front of it.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CMsgQueue::EnQ(				// Returns 0 on success.
+	GameMessage*	pmsg,				// In:  Message to add.
+	int16_t*			psPriority)		// In:  Priority level.
+	{
+	int16_t	sRes	= 0;	// Assume success.
+
+	ASSERT(m_ppool != NULL);
+
+	MsgNode*	pnode	= m_ppool->Alloc();
+	if (pnode != NULL)
+		{
+		int16_t	sPriority	= *psPriority;
+		pnode->msg			= *pmsg;
+		pnode->sPriority	= sPriority;
+
+		MsgNode**	ppnLink	= &m_pnTop;
+		while (*ppnLink != NULL && (*ppnLink)->sPriority > sPriority)
+			ppnLink	= &((*ppnLink)->pNextBucket);
+
+		MsgNode*	pnBucket	= *ppnLink;
+		if (pnBucket != NULL && pnBucket->sPriority == sPriority)
+			{
+			// Most recently posted comes out first within a priority.
+			pnode->pNext			= pnBucket;
+			pnode->pNextBucket	= pnBucket->pNextBucket;
+			}
+		else
+			{
+			pnode->pNext			= NULL;
+			pnode->pNextBucket	= pnBucket;
+			}
+
+		*ppnLink	= pnode;
+		m_sNumItems++;
+		}
+	else
+		{
+		TRACE("EnQ(): Unable to allocate message node.\n");
+		sRes	= -1;
+		}
+
+	return sRes;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// MessageQueue.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CMsgPool hands out message nodes from large blocks so posting a message
+// never has to go to the heap once the pool has warmed up.  There is one pool
+// per realm and every CThing's CMsgQueue draws from it.
+//
+// CMsgQueue is an intrusive, prioritized queue of those nodes.  Nodes of the
+// same priority are chained into a bucket, and the buckets are chained in
+// order of decreasing priority, so posting costs one step per distinct
+// priority currently queued (almost always just the one) and dequeuing is
+// constant time.
+//
+// The dequeue order matches the RPQueue this replaces exactly: highest
+// priority first and, within a priority, the most recently posted first.
+// Game logic (and therefore demos and network play) depends on that order.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef MESSAGEQUEUE_H
+#define MESSAGEQUEUE_H
+
+#include "RSPiX.h"
+#include "message.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+// A queued message.
+typedef struct MsgNode
+	{
+	GameMessage	msg;				// The message.
+	int16_t		sPriority;		// Its priority.
+	MsgNode*		pNext;			// Next node in the same bucket (or free list).
+	MsgNode*		pNextBucket;	// Top of the next bucket (only valid on a bucket's top).
+	} MsgNode;
+
+class CMsgPool
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			NodesPerBlock	= 256		// Number of nodes allocated at once.
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CMsgPool();
+
+		// Destructor.
+		~CMsgPool();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Get a node, growing the pool if necessary.
+		MsgNode* Alloc(void)			// Returns node or NULL, if out of memory.
+			{
+			if (m_pnFree == NULL)
+				Grow();
+
+			MsgNode*	pnode	= m_pnFree;
+			if (pnode != NULL)
+				{
+				m_pnFree	= pnode->pNext;
+				m_lNumUsed++;
+				}
+
+			return pnode;
+			}
+
+		// Return a node to the pool.
+		void Free(						// Returns nothing.
+			MsgNode*	pnode)			// In:  Node to free.
+			{
+			pnode->pNext	= m_pnFree;
+			m_pnFree			= pnode;
+			m_lNumUsed--;
+			}
+
+		// Get the number of nodes currently in use.
+		int32_t GetNumUsed(void)
+			{ return m_lNumUsed; }
+
+		// Get the number of nodes allocated.
+		int32_t GetNumAllocated(void)
+			{ return m_lNumAllocated; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Allocate another block of nodes and add them to the free list.
+		void Grow(void);
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		// A block of nodes.  Blocks are only freed when the pool is destroyed.
+		typedef struct Block
+			{
+			Block*	pNext;
+			MsgNode	anodes[NodesPerBlock];
+			} Block;
+
+		Block*	m_pblockHead;		// Blocks allocated so far.
+		MsgNode*	m_pnFree;			// Free nodes.
+		int32_t	m_lNumUsed;			// Nodes currently in use.
+		int32_t	m_lNumAllocated;	// Nodes allocated.
+	};
+
+class CMsgQueue
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CMsgQueue()
+			{
+			m_ppool		= NULL;
+			m_pnTop		= NULL;
+			m_sNumItems	= 0;
+			}
+
+		// Destructor.
+		~CMsgQueue()
+			{
+			Empty();
+			}
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Set the pool to get nodes from.  Must be done before anything is
+		// enqueued and can't be changed while anything is queued.
+		void SetPool(					// Returns nothing.
+			CMsgPool*	ppool)		// In:  Pool to use.
+			{
+			ASSERT(m_pnTop == NULL);
+			m_ppool	= ppool;
+			}
+
+		// Enqueue the indicated message.
+		int16_t EnQ(					// Returns 0 on success.
+			GameMessage*	pmsg,		// In:  Message to add.
+			int16_t*			psPriority);	// In:  Priority level.
+
+		// Dequeue the next message.
+		bool DeQ(						// Returns true if item dequeued, false if empty.
+			GameMessage*	pmsg)		// Out: Message dequeued on success.
+			{
+			MsgNode*	pnode	= m_pnTop;
+			if (pnode != NULL)
+				{
+				*pmsg	= pnode->msg;
+
+				// The next node in this bucket (if any) becomes its top.
+				if (pnode->pNext != NULL)
+					{
+					m_pnTop					= pnode->pNext;
+					m_pnTop->pNextBucket	= pnode->pNextBucket;
+					}
+				else
+					{
+					m_pnTop					= pnode->pNextBucket;
+					}
+
+				m_ppool->Free(pnode);
+				m_sNumItems--;
+
+				return true;
+				}
+
+			return false;
+			}
+
+		// "Peek" at the next message without removing it.
+		bool Peek(						// Returns true if there is an item to peek at, false otherwise.
+			GameMessage*	pmsg)		// Out: Message on success.
+			{
+			if (m_pnTop != NULL)
+				{
+				*pmsg	= m_pnTop->msg;
+				return true;
+				}
+
+			return false;
+			}
+
+		// Empty queue.
+		void Empty(void)
+			{
+			GameMessage	msg;
+			while (DeQ(&msg) == true)
+				(void)0;
+			}
+
+		// Get number of items currently in the queue.
+		int16_t NumItems(void)
+			{
+			return m_sNumItems;
+			}
+
+		// Determine whether the queue is empty.
+		int16_t IsEmpty(void)		// Returns TRUE if empty, FALSE otherwise.
+			{
+			return (m_pnTop == NULL) ? TRUE : FALSE;
+			}
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		CMsgPool*	m_ppool;			// Pool nodes come from.
+		MsgNode*		m_pnTop;			// Top of highest priority bucket.
+		int16_t		m_sNumItems;	// Number of items queued.
+	};
+
+#endif	// MESSAGEQUEUE_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
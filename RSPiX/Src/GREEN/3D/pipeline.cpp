@@ -21,6 +21,12 @@
 #else
 	#include "pipeline.h"
 #endif
+
+// Use SSE for transforming points wherever the compiler says it's there.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define PIPELINE_SSE
+	#include <xmmintrin.h>
+#endif
 ///////////////////////////////////////////////////////////////
 // This is the highest level considered actually part of the 3d engine.
 // It is the highest level control -> it decides how 3d pts map to 2d.
@@ -38,6 +44,207 @@ int32_t	RPipeLine::ms_lNumPipes = 0;
 
 RP3d*  RPipeLine::ms_pPts = NULL;
 
+///////////////////////////////////////////////////////////////
+// Transform lNum pts from pSrc into pDst by the 3 row form tXF.
+// Gives exactly what tXF.TransformInto() would for each pt:
+// each row is summed starting from 0 in x, y, z, w order, and
+// w always comes out 1.
+///////////////////////////////////////////////////////////////
+static void TransformPts(RTransform& tXF,RP3d* pSrc,RP3d* pDst,int32_t lNum)
+	{
+	REAL* T = tXF.T;
+	int32_t i;
+
+#ifdef PIPELINE_SSE
+	// Lane j of column c holds T[ROW j + c], so one pt is done
+	// with all three rows at once.  Lane 3 just carries the 1.
+	__m128 c0 = _mm_setr_ps(T[ROW0 + 0],T[ROW1 + 0],T[ROW2 + 0],0.0F);
+	__m128 c1 = _mm_setr_ps(T[ROW0 + 1],T[ROW1 + 1],T[ROW2 + 1],0.0F);
+	__m128 c2 = _mm_setr_ps(T[ROW0 + 2],T[ROW1 + 2],T[ROW2 + 2],0.0F);
+	__m128 c3 = _mm_setr_ps(T[ROW0 + 3],T[ROW1 + 3],T[ROW2 + 3],0.0F);
+	__m128 start = _mm_setr_ps(0.0F,0.0F,0.0F,1.0F);
+
+	for (i = 0; i < lNum; i++)
+		{
+		__m128 v = _mm_loadu_ps(pSrc[i].v);
+		__m128 r = _mm_add_ps(start,_mm_mul_ps(_mm_shuffle_ps(v,v,0x00),c0));
+		r = _mm_add_ps(r,_mm_mul_ps(_mm_shuffle_ps(v,v,0x55),c1));
+		r = _mm_add_ps(r,_mm_mul_ps(_mm_shuffle_ps(v,v,0xaa),c2));
+		r = _mm_add_ps(r,_mm_mul_ps(_mm_shuffle_ps(v,v,0xff),c3));
+		_mm_storeu_ps(pDst[i].v,r);
+		}
+#else
+	REAL	t00 = T[ROW0 + 0],t01 = T[ROW0 + 1],t02 = T[ROW0 + 2],t03 = T[ROW0 + 3];
+	REAL	t10 = T[ROW1 + 0],t11 = T[ROW1 + 1],t12 = T[ROW1 + 2],t13 = T[ROW1 + 3];
+	REAL	t20 = T[ROW2 + 0],t21 = T[ROW2 + 1],t22 = T[ROW2 + 2],t23 = T[ROW2 + 3];
+
+	for (i = 0; i < lNum; i++)
+		{
+		REAL x = pSrc[i].x,y = pSrc[i].y,z = pSrc[i].z,w = pSrc[i].w;
+		pDst[i].x = REAL(0.) + x * t00 + y * t01 + z * t02 + w * t03;
+		pDst[i].y = REAL(0.) + x * t10 + y * t11 + z * t12 + w * t13;
+		pDst[i].z = REAL(0.) + x * t20 + y * t21 + z * t22 + w * t23;
+		pDst[i].w = REAL(1.);
+		}
+#endif
+	}
+
+///////////////////////////////////////////////////////////////
+// Transform lNum packed pts (see RSop::m_psPacked) from ps into
+// pDst by the 3 row form tXF, which must already have the unpack
+// scale and bias folded into it.  w is taken to be 1.
+///////////////////////////////////////////////////////////////
+static void TransformPacked(RTransform& tXF,int16_t* ps,RP3d* pDst,int32_t lNum)
+	{
+	REAL* T = tXF.T;
+	int32_t i;
+
+#ifdef PIPELINE_SSE
+	__m128 c0 = _mm_setr_ps(T[ROW0 + 0],T[ROW1 + 0],T[ROW2 + 0],0.0F);
+	__m128 c1 = _mm_setr_ps(T[ROW0 + 1],T[ROW1 + 1],T[ROW2 + 1],0.0F);
+	__m128 c2 = _mm_setr_ps(T[ROW0 + 2],T[ROW1 + 2],T[ROW2 + 2],0.0F);
+	__m128 start = _mm_setr_ps(T[ROW0 + 3],T[ROW1 + 3],T[ROW2 + 3],1.0F);
+
+	for (i = 0; i < lNum; i++,ps += 3)
+		{
+		__m128 r = _mm_add_ps(start,_mm_mul_ps(_mm_set1_ps(REAL(ps[0])),c0));
+		r = _mm_add_ps(r,_mm_mul_ps(_mm_set1_ps(REAL(ps[1])),c1));
+		r = _mm_add_ps(r,_mm_mul_ps(_mm_set1_ps(REAL(ps[2])),c2));
+		_mm_storeu_ps(pDst[i].v,r);
+		}
+#else
+	REAL	t00 = T[ROW0 + 0],t01 = T[ROW0 + 1],t02 = T[ROW0 + 2],t03 = T[ROW0 + 3];
+	REAL	t10 = T[ROW1 + 0],t11 = T[ROW1 + 1],t12 = T[ROW1 + 2],t13 = T[ROW1 + 3];
+	REAL	t20 = T[ROW2 + 0],t21 = T[ROW2 + 1],t22 = T[ROW2 + 2],t23 = T[ROW2 + 3];
+
+	for (i = 0; i < lNum; i++,ps += 3)
+		{
+		REAL x = ps[0],y = ps[1],z = ps[2];
+		pDst[i].x = t03 + x * t00 + y * t01 + z * t02;
+		pDst[i].y = t13 + x * t10 + y * t11 + z * t12;
+		pDst[i].z = t23 + x * t20 + y * t21 + z * t22;
+		pDst[i].w = REAL(1.);
+		}
+#endif
+	}
+
+///////////////////////////////////////////////////////////////
+// Fold the unpack of pSop's packed pts into tXF, giving the
+// transform that takes packed pts straight to where tXF would
+// take the unpacked ones.
+///////////////////////////////////////////////////////////////
+static void FoldUnpack(RTransform& tXF,RSop* pSop,RTransform& tPacked)
+	{
+	tPacked = tXF;
+	for (int16_t r = ROW0; r <= ROW2; r += 4)
+		{
+		for (int16_t c = 0; c < 3; c++)
+			{
+			tPacked.T[r + 3] += tXF.T[r + c] * pSop->m_afUnpackBias[c];
+			tPacked.T[r + c] = tXF.T[r + c] * pSop->m_afUnpackScale[c];
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////
+// Put the pts fBlend of the way from pSop's to pSopNext's into
+// pDst.  If both are packed the same way, the result is still
+// in packed units (so FoldUnpack() applies) and true is
+// returned.  The sops must have the same number of pts.
+///////////////////////////////////////////////////////////////
+static bool BlendPts(RSop* pSop,RSop* pSopNext,REAL fBlend,RP3d* pDst)
+	{
+	int32_t i;
+	int32_t lNum = pSop->m_lNum;
+
+	if (pSop->m_psPacked && pSopNext->m_psPacked
+		&& rspObjCmp(pSop->m_afUnpackScale,pSopNext->m_afUnpackScale,(size_t)3)
+		&& rspObjCmp(pSop->m_afUnpackBias,pSopNext->m_afUnpackBias,(size_t)3))
+		{
+		int16_t* psA = pSop->m_psPacked;
+		int16_t* psB = pSopNext->m_psPacked;
+		for (i = 0; i < lNum; i++,psA += 3,psB += 3)
+			{
+			pDst[i].x = psA[0] + (psB[0] - psA[0]) * fBlend;
+			pDst[i].y = psA[1] + (psB[1] - psA[1]) * fBlend;
+			pDst[i].z = psA[2] + (psB[2] - psA[2]) * fBlend;
+			pDst[i].w = REAL(1.);
+			}
+		return true;
+		}
+
+	if (pSop->m_pArray && pSopNext->m_pArray)
+		{
+		RP3d* pA = pSop->m_pArray;
+		RP3d* pB = pSopNext->m_pArray;
+#ifdef PIPELINE_SSE
+		__m128 t = _mm_set1_ps(fBlend);
+		for (i = 0; i < lNum; i++)
+			{
+			__m128 a = _mm_loadu_ps(pA[i].v);
+			__m128 b = _mm_loadu_ps(pB[i].v);
+			_mm_storeu_ps(pDst[i].v,_mm_add_ps(a,_mm_mul_ps(_mm_sub_ps(b,a),t)));
+			}
+#else
+		for (i = 0; i < lNum; i++)
+			{
+			pDst[i].x = pA[i].x + (pB[i].x - pA[i].x) * fBlend;
+			pDst[i].y = pA[i].y + (pB[i].y - pA[i].y) * fBlend;
+			pDst[i].z = pA[i].z + (pB[i].z - pA[i].z) * fBlend;
+			pDst[i].w = pA[i].w + (pB[i].w - pA[i].w) * fBlend;
+			}
+#endif
+		return false;
+		}
+
+	// Mixed, so do it the slow way.
+	RP3d ptA,ptB;
+	for (i = 0; i < lNum; i++)
+		{
+		pSop->GetPt(i,ptA);
+		pSopNext->GetPt(i,ptB);
+		pDst[i].x = ptA.x + (ptB.x - ptA.x) * fBlend;
+		pDst[i].y = ptA.y + (ptB.y - ptA.y) * fBlend;
+		pDst[i].z = ptA.z + (ptB.z - ptA.z) * fBlend;
+		pDst[i].w = REAL(1.);
+		}
+	return false;
+	}
+
+///////////////////////////////////////////////////////////////
+// Transform all of pSop's pts into pDst by tXF, packed or not.
+// For packed pts, the unpack is folded into the transform so
+// it costs nothing per pt.  If pSopNext is not NULL, the pts
+// are first blended fBlend of the way toward its pts (in pDst,
+// which is then transformed in place).
+///////////////////////////////////////////////////////////////
+static void TransformSop(RTransform& tXF,RSop* pSop,RSop* pSopNext,REAL fBlend,RP3d* pDst)
+	{
+	RTransform tPacked;
+
+	if (pSopNext != NULL && fBlend > REAL(0.) && pSopNext->m_lNum == pSop->m_lNum)
+		{
+		if (BlendPts(pSop,pSopNext,fBlend,pDst) == true)
+			{
+			FoldUnpack(tXF,pSop,tPacked);
+			TransformPts(tPacked,pDst,pDst,pSop->m_lNum);
+			}
+		else
+			{
+			TransformPts(tXF,pDst,pDst,pSop->m_lNum);
+			}
+		}
+	else if (pSop->m_psPacked == NULL)
+		{
+		TransformPts(tXF,pSop->m_pArray,pDst,pSop->m_lNum);
+		}
+	else
+		{
+		FoldUnpack(tXF,pSop,tPacked);
+		TransformPacked(tPacked,pSop->m_psPacked,pDst,pSop->m_lNum);
+		}
+	}
+
 RPipeLine::RPipeLine()
 	{
 	ms_lNumPipes++; // Track for deletion purposes!
@@ -174,10 +381,10 @@ RPipeLine::~RPipeLine()
 		}
 	}
 
-void RPipeLine::Transform(RSop* pPts,RTransform& tObj)
+void RPipeLine::Transform(RSop* pPts,RTransform& tObj,
+		RSop* pPtsNext/* = NULL*/,REAL fBlend/* = 0*/)
 	{
 	RTransform tFull;
-	int32_t i;
 	// Use to stretch to z-buffer!
 
 	tFull.Make1();
@@ -186,21 +393,18 @@ void RPipeLine::Transform(RSop* pPts,RTransform& tObj)
 	// trasnform each pt by two transforms separately!
 	tFull.PreMulBy(m_tScreen.T);
 
-	for (i = 0; i < pPts->m_lNum; i++)
-		{
-		tFull.TransformInto(pPts->m_pArray[i],ms_pPts[i]);
-		// Note that you can now use RP3d directly with the renderers! 
-		}
+	TransformSop(tFull,pPts,pPtsNext,fBlend,ms_pPts);
+	// Note that you can now use RP3d directly with the renderers! 
 	}
 
 // Need to create a slightly more complex pipe:
 void RPipeLine::TransformShadow(RSop* pPts,RTransform& tObj,
-		int16_t sHeight,int16_t *psOffX,int16_t *psOffY)
+		int16_t sHeight,int16_t *psOffX,int16_t *psOffY,
+		RSop* pPtsNext/* = NULL*/,REAL fBlend/* = 0*/)
 	{
 	ASSERT(m_pimShadowBuf);
 
 	RTransform tFull;
-	int32_t i;
 	// Use to stretch to z-buffer!
 
 	tFull.Make1();
@@ -245,11 +449,8 @@ void RPipeLine::TransformShadow(RSop* pPts,RTransform& tObj,
 	// This is hard coded to the postal coordinate system
 	tFull.Trans(0.0,m_pimShadowBuf->m_sHeight-m_tScreen.T[3 + ROW1],0.0);
 
-	for (i = 0; i < pPts->m_lNum; i++)
-		{
-		tFull.TransformInto(pPts->m_pArray[i],ms_pPts[i]);
-		// Note that you can now use RP3d directly with the renderers! 
-		}
+	TransformSop(tFull,pPts,pPtsNext,fBlend,ms_pPts);
+	// Note that you can now use RP3d directly with the renderers! 
 
 	}
 
@@ -418,12 +619,18 @@ void RPipeLine::BoundingSphereToScreen(RP3d& ptCenter, RP3d& ptRadius,
 	tFull.TransformInto(ptCenter,ptCen); // z is now distorted
 
 	// store in pieline variables...(ALL OF THEM)
-	m_sCenX = int16_t(ptCen.x);
-	m_sCenY = int16_t(ptCen.y);
-	m_sCenZ = int16_t(ptCen.z / 256.0); // Scale Z's by 256 for lighting later
+	SetScreenSphere(int16_t(ptCen.x),int16_t(ptCen.y),
+		int16_t(ptCen.z / 256.0), // Scale Z's by 256 for lighting later
+		int16_t(dScreenRadius+1));
+	}
+
+void RPipeLine::SetScreenSphere(int16_t sCenX,int16_t sCenY,int16_t sCenZ,
+		int16_t sScreenRadius)
+	{
+	m_sCenX = sCenX;
+	m_sCenY = sCenY;
+	m_sCenZ = sCenZ;
 
-	int16_t	sScreenRadius = int16_t(dScreenRadius+1);
-	
 	m_sX = m_sCenX - sScreenRadius;
 	m_sY = m_sCenY - sScreenRadius;
 	m_sZ = m_sCenZ - sScreenRadius;
@@ -64,9 +64,13 @@ public:
 	void Init();
 	//-------------------------------------
 	int16_t NotCulled(RP3d *p1,RP3d *p2,RP3d *p3);
-	void Transform(RSop* pPts,RTransform& tObj);
+	// If pPtsNext is given, the pts are blended fBlend (0 to 1) of
+	// the way toward it first.  It must have as many pts as pPts.
+	void Transform(RSop* pPts,RTransform& tObj,
+		RSop* pPtsNext = NULL,REAL fBlend = 0);
 	void TransformShadow(RSop* pPts,RTransform& tObj,
-		int16_t sHeight = 0,int16_t *psOffX = NULL,int16_t *psOffY = NULL);
+		int16_t sHeight = 0,int16_t *psOffX = NULL,int16_t *psOffY = NULL,
+		RSop* pPtsNext = NULL,REAL fBlend = 0);
 
 	// Do NOT use a z-buffer.  Return offset to current position to
 	// draw the image m_pimShadowBuf
@@ -124,6 +128,11 @@ public:
 	void BoundingSphereToScreen(RP3d& ptCenter, RP3d& ptRadius, 
 		RTransform& tObj);
 
+	// Set the bounding rect from a sphere already on the screen (e.g., one
+	// BoundingSphereToScreen() found earlier):
+	void SetScreenSphere(int16_t sCenX,int16_t sCenY,int16_t sCenZ,
+		int16_t sScreenRadius);
+
 	//-------------------------------------
 	// Configurable by instance:
 	RZBuffer* m_pZB;
@@ -25,6 +25,71 @@
 typedef struct 
 	{ RFixedS32 x; RFixedS32 y; RFixedS32 z;} RRenderPt32; // For internal use
 
+// Smallest triangle (width + height of its bounds, in pixels) worth
+// checking against the z-buffer's tiles.  Smaller ones are quicker to
+// just draw.
+const int16_t HIDDEN_TRI_MIN_SIZE = 32;
+
+// Gets the triangle's bounds in the z-buffer, allowing for rounding at the
+// left and right edges, and adds them to what the z-buffer will need to
+// clear.  Points must be sorted by y.
+inline void TouchTri(RRenderPt32* pv1,RRenderPt32* pv2,RRenderPt32* pv3,
+			RZBuffer* pZB,int16_t sOffsetX,int16_t sOffsetY,
+			int16_t& sX0,int16_t& sY0,int16_t& sX1,int16_t& sY1)
+	{
+	sX0 = sX1 = pv1->x.mod;
+	if (pv2->x.mod < sX0) sX0 = pv2->x.mod;
+	if (pv2->x.mod > sX1) sX1 = pv2->x.mod;
+	if (pv3->x.mod < sX0) sX0 = pv3->x.mod;
+	if (pv3->x.mod > sX1) sX1 = pv3->x.mod;
+	sX0 += sOffsetX - 1;
+	sX1 += sOffsetX + 1;
+	sY0 = pv1->y.mod + sOffsetY;
+	sY1 = pv3->y.mod + sOffsetY;
+
+	pZB->Touch(sX0,sY0,sX1,sY1);
+	}
+
+// Returns TRUE if the triangle, with the bounds from TouchTri(), is entirely
+// behind what's already in the z-buffer, going by the z-buffer's tiles.
+// Otherwise, if it's big enough to have been checked, notes where it will be
+// drawn so those tiles get rechecked.  Small ones don't bother, which is
+// safe since drawing only ever raises the z-buffer, so a tile's lowest z is
+// never too high, just less useful.
+inline int16_t HiddenTri(RRenderPt32* pv1,RRenderPt32* pv2,RRenderPt32* pv3,
+			RZBuffer* pZB,int16_t sX0,int16_t sY0,int16_t sX1,int16_t sY1)
+	{
+	if ( (sX1 - sX0) + (sY1 - sY0) < HIDDEN_TRI_MIN_SIZE) return FALSE;
+
+	int16_t sZ = pv1->z.mod;
+	if (pv2->z.mod > sZ) sZ = pv2->z.mod;
+	if (pv3->z.mod > sZ) sZ = pv3->z.mod;
+
+	if (pZB->IsHidden(sX0,sY0,sX1,sY1,sZ))
+		{
+		pZB->m_lTrisHidden++;
+		return TRUE;
+		}
+
+	pZB->MarkDrawn(sX0,sY0,sX1,sY1);
+	return FALSE;
+	}
+
+// Shortest span (in pixels) worth handing to memset().  Shorter ones are
+// quicker to just plot.
+const int16_t FILL_SPAN_MIN_MEMSET = 16;
+
+// Fills pixels x0 through x1 of a scanline with one color.  There's nothing
+// to test per pixel, so longer spans go to memset(), which moves them as
+// many bytes at a time as the CPU allows.  Draws nothing if x1 < x0.
+inline void FillSpan(uint8_t* pDst,int16_t x0,int16_t x1,uint8_t ucColor)
+	{
+	int16_t sLen = x1 - x0 + 1;
+	if (sLen >= FILL_SPAN_MIN_MEMSET)
+		memset(pDst + x0,ucColor,sLen);
+	else
+		for (pDst += x0; sLen > 0; sLen--) *pDst++ = ucColor;
+	}
 
 // Fog should be offset such that the first index occurs
 // at the minimum z-point of the full3d object being
@@ -61,6 +126,9 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 	pt1.x.frac = 
 	pt2.x.frac = 
 	pt3.x.frac = uint16_t(32768); // offset each by 1/2
+	pt1.z.frac = 
+	pt2.z.frac = 
+	pt3.z.frac = 0; // z starts on the integer (was left uninitialized)
 
 	/*
 	// Catch the special case of a single pixel
@@ -165,6 +233,64 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 
 	if (y2 + y3 == 0) return; // don;t bother drawing horiz line
 
+	// Triangles one scanline tall are most of what a POSTAL model is made of
+	// at normal size.  Since a triangle's top scanline is never drawn, all
+	// that's left is a row on pv3's scanline from pv2 to pv3 (just pv3 if the
+	// top is flat), so plot that as a splat without any edge set up.  This
+	// draws exactly what the full version below would.
+	if (y3 == 1)
+		{
+		RRenderPt32* pvL = pv3;
+		RRenderPt32* pvR = pv3;
+		if (y2 == 1)
+			{
+			if (pv2->x.mod <= pv3->x.mod) pvL = pv2;
+			else pvR = pv2;
+			}
+
+		RFixedS32 fz,fzinc;
+		fz.val = pvL->z.val;
+		fzinc.val = 0;
+		int16_t xdel = pvR->x.mod - pvL->x.mod;
+		if (xdel)
+			{
+			// Same 16-bit z differences the full version gets:
+			int16_t sZL = pvL->z.mod - pv1->z.mod;
+			int16_t sZR = pvR->z.mod - pv1->z.mod;
+			fzinc.val = int32_t(sZR - sZL) * RInitNum::OneOver[xdel];
+			}
+
+		uint8_t* pDst = pDstOffset + lDstP * pv3->y.mod;
+		int16_t* pBufZ = pZB -> GetZPtr(sOffsetX, pv3->y.mod + sOffsetY);
+		pZB->Touch(pvL->x.mod + sOffsetX, pv3->y.mod + sOffsetY,
+			pvR->x.mod + sOffsetX, pv3->y.mod + sOffsetY);
+
+		int32_t lWritten = 0;
+		for (int16_t x = pvL->x.mod; x <= pvR->x.mod; x++)
+			{
+			if (fz.mod > *(pBufZ+x) )
+				{
+				*(pDst+x) = pFog[fz.upper];
+				*(pBufZ+x) = fz.mod;
+				lWritten++;
+				}
+			fz.val += fzinc.val;
+			}
+
+		pZB->m_lPixelsTested += xdel + 1;
+		pZB->m_lPixelsWritten += lWritten;
+		return;
+		}
+
+	int16_t sX0,sY0,sX1,sY1;
+	TouchTri(pv1,pv2,pv3,pZB,sOffsetX,sOffsetY,sX0,sY0,sX1,sY1);
+
+	// Don't bother scanning it if it's entirely behind what's already there.
+	if (HiddenTri(pv1,pv2,pv3,pZB,sX0,sY0,sX1,sY1)) return;
+
+	int32_t lTested = 0;		// Pixels tested against the z-buffer.
+	int32_t lWritten = 0;	// Pixels that passed.
+
 	// get relative floating point x coordinates: (32-bit differences)
 	int32_t fx1 = pv1->x.val;
 	int32_t fz1 = pv1->z.val;
@@ -273,17 +399,21 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 			//if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
 			// Assume 2 to 3:
+			if (xdel >= 0) lTested += xdel + 1;
 			for (x = x1.mod; x<= x2.mod;x++)
 				{
 				if (fz.mod > *(pBufZ+x) )
 					{
 					*(pDst+x) = pFog[fz.upper];// pFog[fz.upper];	// offset for fog
 					*(pBufZ+x) = fz.mod;				// set Z-buffer!
+					lWritten++;
 					}
 				fz.val += fzinc.val;
 				}
 			}
 
+		pZB->m_lPixelsTested += lTested;
+		pZB->m_lPixelsWritten += lWritten;
 		return;
 		}
 	//****************************************************************
@@ -311,12 +441,14 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 			if (xdel) fzinc.val = uint32_t(z3.mod - z2.mod) * RInitNum::OneOver[xdel];
 			//if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 			// Assume 2 to 3:
+			if (xdel >= 0) lTested += xdel + 1;
 			for (x = x2.mod; x<= x3.mod;x++)
 				{
 				if (fz.mod > *(pBufZ+x) )
 					{
 					*(pDst+x) = pFog[fz.upper];// pFog[fz.upper];
 					*(pBufZ+x) = fz.mod;// set Z-buffer!
+					lWritten++;
 					}
 				fz.val += fzinc.val;
 				}
@@ -355,12 +487,14 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 				//if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
 				// Assume 2 to 3:
+				if (xdel >= 0) lTested += xdel + 1;
 				for (x = x2.mod; x<= x3.mod;x++)
 					{
 					if (fz.mod > *(pBufZ+x) )
 						{
 						*(pDst+x) = pFog[fz.upper];// pFog[fz.upper];
 						*(pBufZ+x) = fz.mod;// set Z-buffer!
+						lWritten++;
 						}
 					fz.val += fzinc.val;
 					}
@@ -396,12 +530,14 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 			//if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
 
 			// Assume 2 to 3:
+			if (xdel >= 0) lTested += xdel + 1;
 			for (x = x3.mod; x<= x2.mod;x++)
 				{
 				if (fz.mod > *(pBufZ+x) )
 					{
 					*(pDst+x) = pFog[fz.upper];// pFog[fz.upper];
 					*(pBufZ+x) = fz.mod;// set Z-buffer!
+					lWritten++;
 					}
 				fz.val += fzinc.val;
 				}
@@ -440,18 +576,23 @@ void	DrawTri_ZColorFog(uint8_t* pDstOffset,int32_t lDstP,
 				// Full accuracy fxMul!
 				//if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
 				// Assume 2 to 3:
+				if (xdel >= 0) lTested += xdel + 1;
 				for (x = x3.mod; x<= x2.mod;x++)
 					{
 					if (fz.mod > *(pBufZ+x) )
 						{
 						*(pDst+x) = pFog[fz.upper];// pFog[fz.upper];
 						*(pBufZ+x) = fz.mod;// set Z-buffer!
+						lWritten++;
 						}
 					fz.val += fzinc.val;
 					}
 				}
 			}
 		}
+
+	pZB->m_lPixelsTested += lTested;
+	pZB->m_lPixelsWritten += lWritten;
 	}
 
 //================================================== 
@@ -505,6 +646,9 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 	pt1.x.frac = 
 	pt2.x.frac = 
 	pt3.x.frac = uint16_t(32768); // offset each by 1/2
+	pt1.z.frac = 
+	pt2.z.frac = 
+	pt3.z.frac = 0; // z starts on the integer (was left uninitialized)
 	
 	// sort the triangles and choose which mirror case to render.
 
@@ -523,6 +667,60 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 
 	if (y2 + y3 == 0) return; // don;t bother drawing horiz line
 
+	// One scanline tall -- splat it (see DrawTri_ZColorFog).
+	if (y3 == 1)
+		{
+		RRenderPt32* pvL = pv3;
+		RRenderPt32* pvR = pv3;
+		if (y2 == 1)
+			{
+			if (pv2->x.mod <= pv3->x.mod) pvL = pv2;
+			else pvR = pv2;
+			}
+
+		RFixedS32 fz,fzinc;
+		fz.val = pvL->z.val;
+		fzinc.val = 0;
+		int16_t xdel = pvR->x.mod - pvL->x.mod;
+		if (xdel)
+			{
+			// Same 16-bit z differences the full version gets:
+			int16_t sZL = pvL->z.mod - pv1->z.mod;
+			int16_t sZR = pvR->z.mod - pv1->z.mod;
+			fzinc.val = int32_t(sZR - sZL) * RInitNum::OneOver[xdel];
+			}
+
+		uint8_t* pDst = pDstOffset + lDstP * pv3->y.mod;
+		int16_t* pBufZ = pZB -> GetZPtr(sOffsetX, pv3->y.mod + sOffsetY);
+		pZB->Touch(pvL->x.mod + sOffsetX, pv3->y.mod + sOffsetY,
+			pvR->x.mod + sOffsetX, pv3->y.mod + sOffsetY);
+
+		int32_t lWritten = 0;
+		for (int16_t x = pvL->x.mod; x <= pvR->x.mod; x++)
+			{
+			if (fz.mod > *(pBufZ+x) )
+				{
+				*(pDst+x) = ucFlatColor;
+				*(pBufZ+x) = fz.mod;
+				lWritten++;
+				}
+			fz.val += fzinc.val;
+			}
+
+		pZB->m_lPixelsTested += xdel + 1;
+		pZB->m_lPixelsWritten += lWritten;
+		return;
+		}
+
+	int16_t sX0,sY0,sX1,sY1;
+	TouchTri(pv1,pv2,pv3,pZB,sOffsetX,sOffsetY,sX0,sY0,sX1,sY1);
+
+	// Don't bother scanning it if it's entirely behind what's already there.
+	if (HiddenTri(pv1,pv2,pv3,pZB,sX0,sY0,sX1,sY1)) return;
+
+	int32_t lTested = 0;		// Pixels tested against the z-buffer.
+	int32_t lWritten = 0;	// Pixels that passed.
+
 	// get relative floating point x coordinates: (32-bit differences)
 	int32_t fx1 = pv1->x.val;
 	int32_t fz1 = pv1->z.val;
@@ -631,17 +829,21 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 			//if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
 			// Assume 2 to 3:
+			if (xdel >= 0) lTested += xdel + 1;
 			for (x = x1.mod; x<= x2.mod;x++)
 				{
 				if (fz.mod > *(pBufZ+x) )
 					{
 					*(pDst+x) = ucFlatColor;// pFog[fz.upper];	// offset for fog
 					*(pBufZ+x) = fz.mod;				// set Z-buffer!
+					lWritten++;
 					}
 				fz.val += fzinc.val;
 				}
 			}
 
+		pZB->m_lPixelsTested += lTested;
+		pZB->m_lPixelsWritten += lWritten;
 		return;
 		}
 	//****************************************************************
@@ -669,12 +871,14 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 			if (xdel) fzinc.val = uint32_t(z3.mod - z2.mod) * RInitNum::OneOver[xdel];
 			//if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 			// Assume 2 to 3:
+			if (xdel >= 0) lTested += xdel + 1;
 			for (x = x2.mod; x<= x3.mod;x++)
 				{
 				if (fz.mod > *(pBufZ+x) )
 					{
 					*(pDst+x) = ucFlatColor;// pFog[fz.upper];
 					*(pBufZ+x) = fz.mod;// set Z-buffer!
+					lWritten++;
 					}
 				fz.val += fzinc.val;
 				}
@@ -713,12 +917,14 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 				//if (hzdel) Mul(hzinc,z3.val - z2.val,CInitNum::OneOver[hzdel]);
 
 				// Assume 2 to 3:
+				if (xdel >= 0) lTested += xdel + 1;
 				for (x = x2.mod; x<= x3.mod;x++)
 					{
 					if (fz.mod > *(pBufZ+x) )
 						{
 						*(pDst+x) = ucFlatColor;// pFog[fz.upper];
 						*(pBufZ+x) = fz.mod;// set Z-buffer!
+						lWritten++;
 						}
 					fz.val += fzinc.val;
 					}
@@ -754,12 +960,14 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 			//if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
 
 			// Assume 2 to 3:
+			if (xdel >= 0) lTested += xdel + 1;
 			for (x = x3.mod; x<= x2.mod;x++)
 				{
 				if (fz.mod > *(pBufZ+x) )
 					{
 					*(pDst+x) = ucFlatColor;// pFog[fz.upper];
 					*(pBufZ+x) = fz.mod;// set Z-buffer!
+					lWritten++;
 					}
 				fz.val += fzinc.val;
 				}
@@ -798,18 +1006,23 @@ void	DrawTri_ZColor(uint8_t* pDstOffset,int32_t lDstP,
 				// Full accuracy fxMul!
 				//if (hzdel) Mul(hzinc,z2.val - z3.val,CInitNum::OneOver[hzdel]);
 				// Assume 2 to 3:
+				if (xdel >= 0) lTested += xdel + 1;
 				for (x = x3.mod; x<= x2.mod;x++)
 					{
 					if (fz.mod > *(pBufZ+x) )
 						{
 						*(pDst+x) = ucFlatColor;// pFog[fz.upper];
 						*(pBufZ+x) = fz.mod;// set Z-buffer!
+						lWritten++;
 						}
 					fz.val += fzinc.val;
 					}
 				}
 			}
 		}
+
+	pZB->m_lPixelsTested += lTested;
+	pZB->m_lPixelsWritten += lWritten;
 	}
 
 //================================================== 
@@ -860,6 +1073,21 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 
 	if (y2 + y3 == 0) return; // don;t bother drawing horiz line
 
+	// One scanline tall -- splat it (see DrawTri_ZColorFog).
+	if (y3 == 1)
+		{
+		int16_t sL = pv3->x.mod;
+		int16_t sR = pv3->x.mod;
+		if (y2 == 1)
+			{
+			if (pv2->x.mod <= pv3->x.mod) sL = pv2->x.mod;
+			else sR = pv2->x.mod;
+			}
+
+		FillSpan(pDstOffset + lDstP * pv3->y.mod,sL,sR,ucFlatColor);
+		return;
+		}
+
 	// get relative floating point x coordinates: (32-bit differences)
 	int32_t fx1 = pv1->x.val;
 
@@ -887,8 +1115,7 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 	uint8_t* pDst = pDstOffset + lP * pv1->y.mod + pv1->x.mod + x2.mod; 
 
 	// Draw the upper triangle! (Assuming fx2inc < fx3inc.....)
-	int16_t x,y;
-	int16_t xdel;
+	int16_t y;
 
 //////////////////////////////////////////////////////////////////
 //****************************************************************
@@ -932,11 +1159,10 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 			x2.val += fx2inc;
 			x1.val += fx1inc;
 
-			xdel = x2.mod - x1.mod;
 			//***************8 flipped the inc value:!
 
 			// Assume 2 to 3:
-			for (x = x1.mod; x<= x2.mod;x++) *(pDst+x) = ucFlatColor;
+			FillSpan(pDst,x1.mod,x2.mod,ucFlatColor);
 			}
 
 		return;
@@ -954,9 +1180,8 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 			x3.val += fx3inc;
 
 			// Assume 2 to 3:
-			xdel = x3.mod - x2.mod;
 			// Assume 2 to 3:
-			for (x = x2.mod; x<= x3.mod;x++) *(pDst+x) = ucFlatColor;
+			FillSpan(pDst,x2.mod,x3.mod,ucFlatColor);
 			}
 
 		//===================================================================
@@ -978,10 +1203,9 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 				x2.val += fx2inc;
 				x3.val += fx3inc;
 
-				xdel = x3.mod - x2.mod;
 
 				// Assume 2 to 3:
-				for (x = x2.mod; x<= x3.mod;x++) *(pDst+x) = ucFlatColor;
+				FillSpan(pDst,x2.mod,x3.mod,ucFlatColor);
 				}
 			}
 		}
@@ -1002,10 +1226,9 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 			x3.val += fx3inc;
 			// Assume 2 to 3:
 
-			xdel = x2.mod - x3.mod; //+ x to z
 
 			// Assume 2 to 3:
-			for (x = x3.mod; x<= x2.mod;x++) *(pDst+x) = ucFlatColor;
+			FillSpan(pDst,x3.mod,x2.mod,ucFlatColor);
 			}
 
 		//===================================================================
@@ -1027,10 +1250,9 @@ void	DrawTri(uint8_t* pDstOffset,int32_t lDstP,
 				x2.val += fx2inc;
 				x3.val += fx3inc;
 
-				xdel = x2.mod - x3.mod;
 				// Full accuracy fxMul!
 				// Assume 2 to 3:
-				for (x = x3.mod; x<= x2.mod;x++) *(pDst+x) = ucFlatColor;
+				FillSpan(pDst,x3.mod,x2.mod,ucFlatColor);
 				}
 			}
 		}
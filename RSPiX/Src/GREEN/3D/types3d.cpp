@@ -350,7 +350,17 @@ int16_t RSop::Save(RFile* fp)
 	int16_t sResult = 0;
 	fp->Write(&m_lNum);
 	ASSERT(sizeof(RP3d) == (sizeof(REAL) * 4));
-	fp->Write((REAL*)m_pArray, m_lNum * 4);
+	if (m_pArray)
+		fp->Write((REAL*)m_pArray, m_lNum * 4);
+	else
+		{
+		RP3d pt;
+		for (int32_t l = 0; l < m_lNum; l++)
+			{
+			GetPt(l, pt);
+			fp->Write(pt.v, 4);
+			}
+		}
 	if (fp->Error())
 		{
 		sResult = -1;
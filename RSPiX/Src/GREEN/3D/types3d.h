@@ -339,6 +339,15 @@ class RSop
 		int32_t m_lNum;												// Number of points in array (only 65536 currently accessible)
 		RP3d*	m_pArray;											// Array of points
 
+		// Instead of m_pArray, the points can be packed as 16 bit x, y, z
+		// triples (w is always 1), where each point is
+		// m_psPacked[l * 3 + n] * m_afUnpackScale[n] + m_afUnpackBias[n].
+		// Packed points belong to whatever packed them (see CAnimPack), so
+		// they're never freed or copied, just pointed at.
+		int16_t* m_psPacked;										// Packed points or NULL
+		REAL	m_afUnpackScale[3];									// Scale for packed x, y, z
+		REAL	m_afUnpackBias[3];									// Bias for packed x, y, z
+
 	//------------------------------------------------------------------------------
 	// Functions
 	//------------------------------------------------------------------------------
@@ -382,6 +391,10 @@ class RSop
 				rspObjCpy(m_pArray, rhs.m_pArray, (size_t)m_lNum);
 				}
 
+			m_psPacked = rhs.m_psPacked;
+			rspObjCpy(m_afUnpackScale, rhs.m_afUnpackScale, (size_t)3);
+			rspObjCpy(m_afUnpackBias, rhs.m_afUnpackBias, (size_t)3);
+
 			return *this;
 			}
 
@@ -396,6 +409,10 @@ class RSop
 					// If both pointers are non-zero then we compare their data
 					if (m_pArray && rhs.m_pArray)
 						result = rspObjCmp(m_pArray, rhs.m_pArray, (size_t)m_lNum);
+					else if (m_psPacked && rhs.m_psPacked)
+						result = (m_psPacked == rhs.m_psPacked)
+							&& rspObjCmp(m_afUnpackScale, rhs.m_afUnpackScale, (size_t)3)
+							&& rspObjCmp(m_afUnpackBias, rhs.m_afUnpackBias, (size_t)3);
 					else
 						{
 						// If both pointers are not NULL then they obviously don't match
@@ -415,10 +432,25 @@ class RSop
 		// Free points
 		void Free(void);
 
+		// Get the specified point, whether it's packed or not
+		void GetPt(int32_t l, RP3d& pt) const
+			{
+			if (m_pArray)
+				pt = m_pArray[l];
+			else
+				{
+				const int16_t* ps = m_psPacked + l * 3;
+				pt.x = ps[0] * m_afUnpackScale[0] + m_afUnpackBias[0];
+				pt.y = ps[1] * m_afUnpackScale[1] + m_afUnpackBias[1];
+				pt.z = ps[2] * m_afUnpackScale[2] + m_afUnpackBias[2];
+				pt.w = REAL(1.);
+				}
+			}
+
 		// Load from file
 		int16_t	Load(RFile* fp);
 		
-		// Save to file
+		// Save to file (packed points are saved unpacked)
 		int16_t	Save(RFile* fp);
 
 	protected:
@@ -427,6 +459,9 @@ class RSop
 			{
 			m_lNum = 0;
 			m_pArray = NULL;
+			m_psPacked = NULL;
+			m_afUnpackScale[0] = m_afUnpackScale[1] = m_afUnpackScale[2] = REAL(1.);
+			m_afUnpackBias[0] = m_afUnpackBias[1] = m_afUnpackBias[2] = REAL(0.);
 			}
 	};
 
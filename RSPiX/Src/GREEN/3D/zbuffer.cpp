@@ -31,6 +31,13 @@ void	RZBuffer::Init()
 	m_sW = m_sH = 0;
 	m_lP = 0;
 	m_pBuf = NULL;
+	m_sTilesW = m_sTilesH = 0;
+	m_psTileMin = NULL;
+	m_pTileDirty = NULL;
+	m_lPixelsTested = m_lPixelsWritten = m_lTrisHidden = 0;
+	m_sDirtyX0 = m_sDirtyY0 = 32767;
+	m_sDirtyX1 = m_sDirtyY1 = -32768;
+	m_sClearZ = ZB_MIN_Z;
 	}
 
 RZBuffer::RZBuffer()
@@ -58,6 +65,20 @@ int16_t RZBuffer::Create(int16_t sW,int16_t sH)
 
 	int32_t lSize = m_lP * m_sH * sizeof(int16_t);
 	m_pBuf = (int16_t*) malloc(lSize);
+
+	m_sTilesW = int16_t( (sW + (1 << ZB_TILE_SHIFT) - 1) >> ZB_TILE_SHIFT);
+	m_sTilesH = int16_t( (sH + (1 << ZB_TILE_SHIFT) - 1) >> ZB_TILE_SHIFT);
+	int32_t lTiles = int32_t(m_sTilesW) * m_sTilesH;
+	m_psTileMin = (int16_t*) malloc(lTiles * sizeof(int16_t));
+	m_pTileDirty = (uint8_t*) malloc(lTiles);
+	// Nothing can be hidden until it's cleared:
+	for (int32_t i = 0; i < lTiles; i++)
+		{
+		m_psTileMin[i] = ZB_MIN_Z;
+		m_pTileDirty[i] = FALSE;
+		}
+	// All of it needs the first clear:
+	Touch(0,0,sW - 1,sH - 1);
 	// you then may clear it, buddy!
 
 	return 0;
@@ -77,6 +98,8 @@ int16_t RZBuffer::Destroy()
 		}
 
 	free(m_pBuf);
+	free(m_psTileMin);
+	free(m_pTileDirty);
 
 	Init();
 	return 0;
@@ -85,6 +108,25 @@ int16_t RZBuffer::Destroy()
 //----------------------------------------------
 void RZBuffer::Clear(int16_t sVal)
 	{
+	// Only what's been drawn to since the last clear needs redoing, unless
+	// it's being cleared to something else this time.
+	if (sVal != m_sClearZ)
+		{
+		Touch(0,0,m_sW - 1,m_sH - 1);
+		m_sClearZ = sVal;
+		}
+
+	int16_t sX0 = m_sDirtyX0, sY0 = m_sDirtyY0;
+	int16_t sX1 = m_sDirtyX1, sY1 = m_sDirtyY1;
+	m_sDirtyX0 = m_sDirtyY0 = 32767;
+	m_sDirtyX1 = m_sDirtyY1 = -32768;
+
+	if (sX0 < 0) sX0 = 0;
+	if (sY0 < 0) sY0 = 0;
+	if (sX1 >= m_sW) sX1 = m_sW - 1;
+	if (sY1 >= m_sH) sY1 = m_sH - 1;
+	if ( (sX0 > sX1) || (sY0 > sY1) ) return;
+
 	// Do by 64-bit longs
 	// 1) Create the 64-bit long
 	union
@@ -101,13 +143,111 @@ void RZBuffer::Clear(int16_t sVal)
 
 	BigWord.p1 = BigWord.p2 = BigWord.p3 = BigWord.p4 = sVal;
 
-	//2) Do the copy
+	//2) Do the copy, widened out to whole longs (the pitch is a multiple of 4)
 	int32_t lWordP = m_lP >> 2; // 4 * 16 = 64
-	U64* pWord = (U64*) m_pBuf;
+	int32_t lWordX0 = sX0 >> 2;
+	int32_t lWordW = (sX1 >> 2) - lWordX0 + 1;
+	U64* pWordLine = (U64*) m_pBuf + lWordP * sY0 + lWordX0;
+
+	int16_t y;
+	for (y = sY0; y <= sY1; y++,pWordLine += lWordP)
+		{
+		U64* pWord = pWordLine;
+		for (int32_t i=0;i < lWordW; i++) *pWord++ = BigWord.word;
+		}
+
+	//3) Do the tiles that were touched.  The untouched parts of them were
+	// already sVal.
+	int16_t sTX0 = sX0 >> ZB_TILE_SHIFT, sTX1 = sX1 >> ZB_TILE_SHIFT;
+	int16_t sTY1 = sY1 >> ZB_TILE_SHIFT;
+	for (int16_t sTY = sY0 >> ZB_TILE_SHIFT; sTY <= sTY1; sTY++)
+		{
+		int32_t lRow = int32_t(sTY) * m_sTilesW;
+		for (int16_t sTX = sTX0; sTX <= sTX1; sTX++)
+			{
+			m_psTileMin[lRow + sTX] = sVal;
+			m_pTileDirty[lRow + sTX] = FALSE;
+			}
+		}
+	}
+
+//----------------------------------------------
+// Finds the real lowest z in a tile that's been drawn to.
+void RZBuffer::RescanTile(int16_t sTX,int16_t sTY)
+	{
+	const int16_t sSize = 1 << ZB_TILE_SHIFT;
+	int16_t sPX0 = sTX << ZB_TILE_SHIFT;
+	int16_t sPY0 = sTY << ZB_TILE_SHIFT;
+	int16_t* pZ = GetZPtr(sPX0,sPY0);
+	int16_t sMin = 32767;
+	int16_t x,y;
 
-	int32_t lWordLen = lWordP * m_sH;
-	for (int32_t i=0;i < lWordLen; i++) *pWord++ = BigWord.word;
+	if ( (sPX0 + sSize <= m_sW) && (sPY0 + sSize <= m_sH) )
+		{
+		// Whole tile, so the loops are fixed:
+		for (y = 0; y < sSize; y++,pZ += m_lP)
+			for (x = 0; x < sSize; x++)
+				if (pZ[x] < sMin) sMin = pZ[x];
+		}
+	else
+		{
+		// Tile hangs off the edge:
+		int16_t sW = MIN(sSize,int16_t(m_sW - sPX0));
+		int16_t sH = MIN(sSize,int16_t(m_sH - sPY0));
+		for (y = 0; y < sH; y++,pZ += m_lP)
+			for (x = 0; x < sW; x++)
+				if (pZ[x] < sMin) sMin = pZ[x];
+		}
+
+	int32_t lTile = int32_t(sTY) * m_sTilesW + sTX;
+	m_psTileMin[lTile] = sMin;
+	m_pTileDirty[lTile] = FALSE;
+	}
+
+//----------------------------------------------
+// A dirty tile's lowest z can only be too low, never too high, so the clean
+// tiles are checked first.  Only if they're all hidden do dirty tiles get
+// rescanned.
+int16_t RZBuffer::IsHidden(int16_t sX0,int16_t sY0,int16_t sX1,int16_t sY1,int16_t sZ)
+	{
+	if (sX0 < 0) sX0 = 0;
+	if (sY0 < 0) sY0 = 0;
+	if (sX1 >= m_sW) sX1 = m_sW - 1;
+	if (sY1 >= m_sH) sY1 = m_sH - 1;
+	if ( (sX0 > sX1) || (sY0 > sY1) ) return FALSE;
+
+	int32_t lNeed = int32_t(sZ) + ZB_HIDDEN_MARGIN;
+	int16_t sTX0 = sX0 >> ZB_TILE_SHIFT, sTX1 = sX1 >> ZB_TILE_SHIFT;
+	int16_t sTY0 = sY0 >> ZB_TILE_SHIFT, sTY1 = sY1 >> ZB_TILE_SHIFT;
+	int16_t sTX,sTY;
+	int16_t sDirty = FALSE;
+
+	for (sTY = sTY0; sTY <= sTY1; sTY++)
+		{
+		int32_t lRow = int32_t(sTY) * m_sTilesW;
+		for (sTX = sTX0; sTX <= sTX1; sTX++)
+			{
+			if (m_psTileMin[lRow + sTX] >= lNeed) continue;
+			if (m_pTileDirty[lRow + sTX] == FALSE) return FALSE;
+			sDirty = TRUE;
+			}
+		}
+
+	if (sDirty)
+		{
+		for (sTY = sTY0; sTY <= sTY1; sTY++)
+			{
+			int32_t lRow = int32_t(sTY) * m_sTilesW;
+			for (sTX = sTX0; sTX <= sTX1; sTX++)
+				{
+				if (m_psTileMin[lRow + sTX] >= lNeed) continue;
+				RescanTile(sTX,sTY);
+				if (m_psTileMin[lRow + sTX] < lNeed) return FALSE;
+				}
+			}
+		}
 
+	return TRUE;
 	}
 
 //----------------------------------------------
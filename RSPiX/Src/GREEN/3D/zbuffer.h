@@ -33,6 +33,14 @@
 //================================================== 
 const int16_t ZB_MIN_Z = -32768;
 
+// The z-buffer is also kept as a coarse grid of square tiles, each holding
+// the lowest z in that tile, so whole triangles that can't show through can
+// be skipped without being scanned.
+const int16_t ZB_TILE_SHIFT = 3; // 8 x 8 pixel tiles
+// A triangle's z may come out this much higher than its highest corner
+// after rounding, so only hide it when it's this much behind a tile:
+const int16_t ZB_HIDDEN_MARGIN = 2;
+
 class	RZBuffer // a 16-bit signed z-buffer
 	{
 public:
@@ -41,6 +49,24 @@ public:
 	int32_t m_lP; // pitch in WORDS! (Not a real pitch!)
 	int16_t* m_pBuf; // for now, don't have great need for alignment!
 	//----------------------------------------------
+	int16_t m_sTilesW;
+	int16_t m_sTilesH;
+	int16_t* m_psTileMin; // lowest z per tile (may be lower than it really is)
+	uint8_t* m_pTileDirty; // TRUE if drawn to since m_psTileMin was found
+	//----------------------------------------------
+	// Bounds of everything drawn to since the last Clear(), which is all the
+	// next Clear() has to redo.  Empty when m_sDirtyX0 > m_sDirtyX1.
+	int16_t m_sDirtyX0;
+	int16_t m_sDirtyY0;
+	int16_t m_sDirtyX1;
+	int16_t m_sDirtyY1;
+	int16_t m_sClearZ; // what everything outside of them is set to
+	//----------------------------------------------
+	// Overdraw statistics (reset them yourself):
+	int32_t m_lPixelsTested; // pixels compared against the z-buffer
+	int32_t m_lPixelsWritten; // pixels that passed
+	int32_t m_lTrisHidden; // triangles skipped by the tiles
+	//----------------------------------------------
 	void	Init();
 	RZBuffer();
 	RZBuffer(int16_t sW,int16_t sH);
@@ -50,6 +76,37 @@ public:
 	//----------------------------------------------
 	void Clear(int16_t sVal = ZB_MIN_Z);
 	//----------------------------------------------
+	// Returns TRUE if nothing at or below sZ could show anywhere in the
+	// rectangle from (sX0,sY0) to (sX1,sY1), inclusive.
+	int16_t IsHidden(int16_t sX0,int16_t sY0,int16_t sX1,int16_t sY1,int16_t sZ);
+	void RescanTile(int16_t sTX,int16_t sTY);
+	// Note that the rectangle may be drawn to, so Clear() knows to clear it.
+	// Anything that writes to m_pBuf must call this.
+	void Touch(int16_t sX0,int16_t sY0,int16_t sX1,int16_t sY1)
+		{
+		if (sX0 < m_sDirtyX0) m_sDirtyX0 = sX0;
+		if (sY0 < m_sDirtyY0) m_sDirtyY0 = sY0;
+		if (sX1 > m_sDirtyX1) m_sDirtyX1 = sX1;
+		if (sY1 > m_sDirtyY1) m_sDirtyY1 = sY1;
+		}
+	// Note that the rectangle's tiles need rescanning before they're used.
+	void MarkDrawn(int16_t sX0,int16_t sY0,int16_t sX1,int16_t sY1)
+		{
+		if (sX0 < 0) sX0 = 0;
+		if (sY0 < 0) sY0 = 0;
+		if (sX1 >= m_sW) sX1 = m_sW - 1;
+		if (sY1 >= m_sH) sY1 = m_sH - 1;
+		if ( (sX0 > sX1) || (sY0 > sY1) ) return;
+
+		int16_t sTX0 = sX0 >> ZB_TILE_SHIFT, sTX1 = sX1 >> ZB_TILE_SHIFT;
+		int16_t sTY1 = sY1 >> ZB_TILE_SHIFT;
+		for (int16_t sTY = sY0 >> ZB_TILE_SHIFT; sTY <= sTY1; sTY++)
+			{
+			uint8_t* pDirty = m_pTileDirty + sTY * m_sTilesW;
+			for (int16_t sTX = sTX0; sTX <= sTX1; sTX++) pDirty[sTX] = TRUE;
+			}
+		}
+	//----------------------------------------------
 	// debugging stuff
 	int16_t* GetZPtr(int16_t sX,int16_t sY){return (m_pBuf + sX + m_lP*sY);}
 	void TestHeight(RImage* pimDst,int16_t sDepth,
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// RealmSnapshot.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RSPiX.h"
+
+#include "RealmSnapshot.h"
+#include "realm.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CRealmSnapshot::CRealmSnapshot()
+	{
+	m_lSize	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CRealmSnapshot::~CRealmSnapshot()
+	{
+	Reset();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Save the realm into the snapshot, replacing whatever was there.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CRealmSnapshot::Take(	// Returns 0 on success.
+	CRealm*	prealm)				// In:  Realm to save.
+	{
+	int16_t	sResult	= 0;
+
+	// Whatever happens, the old snapshot is gone.
+	m_lSize	= 0;
+
+	if (m_file.IsOpen() == FALSE)
+		{
+		if (m_file.Open(InitialSize, GrowSize, RFile::LittleEndian) != 0)
+			{
+			TRACE("Take(): Couldn't open memory file.\n");
+			sResult	= -1;
+			}
+		}
+	else
+		{
+		// Write over the last snapshot.
+		m_file.ClearError();
+		m_file.Seek(0, SEEK_SET);
+		}
+
+	if (sResult == 0)
+		{
+		sResult	= prealm->Save(&m_file);
+		if (sResult == 0)
+			{
+			m_lSize	= m_file.Tell();
+			}
+		else
+			{
+			TRACE("Take(): CRealm::Save() failed.\n");
+			}
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Load the realm from the snapshot.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CRealmSnapshot::Restore(	// Returns 0 on success.
+	CRealm*	prealm)					// In:  Realm to load.
+	{
+	int16_t	sResult	= 0;
+
+	if (m_lSize > 0)
+		{
+		// Read through a second RFile so the snapshot itself is untouched.
+		RFile	file;
+		if (file.Open(m_file.GetMemory(), m_lSize, RFile::LittleEndian) == 0)
+			{
+			sResult	= prealm->Load(&file, false, false);
+			if (sResult != 0)
+				{
+				TRACE("Restore(): CRealm::Load() failed.\n");
+				}
+
+			file.Close();
+			}
+		else
+			{
+			TRACE("Restore(): Couldn't open snapshot.\n");
+			sResult	= -2;
+			}
+		}
+	else
+		{
+		TRACE("Restore(): No snapshot.\n");
+		sResult	= -1;
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Forget the snapshot and free the buffer.
+//////////////////////////////////////////////////////////////////////////////
+void CRealmSnapshot::Reset(void)
+	{
+	if (m_file.IsOpen() != FALSE)
+		{
+		m_file.Close();
+		}
+
+	m_lSize	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
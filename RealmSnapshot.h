@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// RealmSnapshot.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CRealmSnapshot keeps a copy of a realm in memory, written by the realm's
+// (and therefore every thing's) own Save() and read back by its Load(), so
+// getting the realm back to that point doesn't have to go near the disk.
+// The buffer is a growable memory RFile that is kept between snapshots and
+// rewritten in place, so once it has grown to fit a realm, taking another
+// snapshot doesn't allocate anything.
+//
+// A snapshot holds exactly what Save() writes, no more.  Taken straight
+// after a realm is loaded that's the whole realm, which is what restarting
+// a level needs.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALMSNAPSHOT_H
+#define REALMSNAPSHOT_H
+
+#include "RSPiX.h"
+
+class CRealm;
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CRealmSnapshot
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			InitialSize	= 256 * 1024,	// Initial size of the buffer.
+			GrowSize		= 64 * 1024		// Least the buffer grows by when it's full.
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CRealmSnapshot();
+
+		// Destructor.
+		~CRealmSnapshot();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Save the realm into the snapshot, replacing whatever was there.
+		int16_t Take(					// Returns 0 on success.
+			CRealm*	prealm);			// In:  Realm to save.
+
+		// Load the realm from the snapshot.  Like CRealm::Load(), this clears
+		// the realm first and leaves calling Startup() to the caller.  Class
+		// preloads are skipped since they already happened when the realm
+		// was first loaded.
+		int16_t Restore(				// Returns 0 on success.
+			CRealm*	prealm);			// In:  Realm to load.
+
+		// Forget the snapshot and free the buffer.
+		void Reset(void);
+
+		// Find out whether there's a snapshot.
+		bool IsValid(void)
+			{ return (m_lSize > 0) ? true : false; }
+
+		// Get the size of the snapshot in bytes.
+		int32_t GetSize(void)
+			{ return m_lSize; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		RFile			m_file;				// Growable memory file holding the snapshot.
+		int32_t		m_lSize;				// Size of the snapshot (0 if none).
+	};
+
+#endif	// REALMSNAPSHOT_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// RealmTelemetry.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RSPiX.h"
+
+#include "RealmTelemetry.h"
+#include "realm.h"
+#include "game.h"
+#include "SampleMaster.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CRealmTelemetry::CRealmTelemetry()
+	{
+	m_lFrame	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CRealmTelemetry::~CRealmTelemetry()
+	{
+	Close();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Create the trace file and write its header.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CRealmTelemetry::Open(	// Returns 0 on success.
+	const char*	pszFile)				// In:  Name of file to create.
+	{
+	int16_t	sResult	= 0;
+
+	Close();
+
+	if (m_file.Open(pszFile, "wb", RFile::LittleEndian) == 0)
+		{
+		m_file.Write((U32)FileID);
+		m_file.Write((U32)FileVersion);
+		m_file.Write((S16)CThing::TotalIDs);
+		int16_t	sClass;
+		for (sClass = 0; sClass < CThing::TotalIDs; sClass++)
+			{
+			const char*	pszName	= CThing::ms_aClassInfo[sClass].pszClassName;
+			m_file.Write((pszName != NULL) ? pszName : "");
+			}
+
+		if (m_file.Error() != FALSE)
+			{
+			TRACE("Open(): Error writing header to \"%s\".\n", pszFile);
+			m_file.Close();
+			sResult	= -2;
+			}
+		}
+	else
+		{
+		TRACE("Open(): Couldn't create \"%s\".\n", pszFile);
+		sResult	= -1;
+		}
+
+	m_lFrame	= 0;
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Close the trace file.
+//////////////////////////////////////////////////////////////////////////////
+void CRealmTelemetry::Close(void)
+	{
+	if (m_file.IsOpen() != FALSE)
+		{
+		m_file.Close();
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Write a record of the realm as it is now.
+//////////////////////////////////////////////////////////////////////////////
+void CRealmTelemetry::Sample(	// Returns nothing.
+	CRealm*	prealm)					// In:  Realm to sample.
+	{
+	if (m_file.IsOpen() == FALSE)
+		return;
+
+	m_file.Write((U32)RecordID);
+	m_file.Write((S32)m_lFrame);
+	m_file.Write((S32)prealm->m_time.GetGameTime());
+	m_file.Write((S16)prealm->m_sNumThings);
+
+	// Things per class.
+	int16_t	sClass;
+	m_file.Write((S16*)prealm->m_asClassNumThings, CThing::TotalIDs);
+	for (sClass = 0; sClass < CThing::TotalIDs; sClass++)
+		{
+		int32_t	lAllocs	= prealm->m_alClassAllocsLast[sClass];
+		m_file.Write((S16)MIN(lAllocs, (int32_t)32767));
+		}
+
+	// Pools.
+	m_file.Write((S32)prealm->m_msgpool.GetNumUsed());
+	m_file.Write((S32)prealm->m_msgpool.GetNumAllocated());
+	int32_t	lPoolUsed		= 0;
+	int32_t	lPoolAllocated	= 0;
+	for (sClass = 0; sClass < CThing::TotalIDs; sClass++)
+		{
+		lPoolUsed		+= prealm->m_athingpools[sClass].GetNumUsed();
+		lPoolAllocated	+= prealm->m_athingpools[sClass].GetNumAllocated();
+		}
+	m_file.Write((S32)lPoolUsed);
+	m_file.Write((S32)lPoolAllocated);
+
+	// Sprites per layer.  Layers may have empty slots until they're sorted.
+	CScene*	pscene	= &prealm->m_scene;
+	m_file.Write((S16)pscene->m_sNumLayers);
+	int16_t	sLayer;
+	for (sLayer = 0; sLayer < pscene->m_sNumLayers; sLayer++)
+		{
+		vSprites&	sprites	= pscene->m_pLayers[sLayer].m_sprites;
+		int32_t		lNum		= 0;
+		for (vSprites::iterator i = sprites.begin(); i != sprites.end(); i++)
+			{
+			if (*i != NULL)
+				lNum++;
+			}
+		m_file.Write((S32)lNum);
+		}
+
+	// Smashatorium grid.
+	CSmashatorium*	psmash		= &prealm->m_smashatorium;
+	int32_t			lCells		= 0;
+	int32_t			lOccupied	= 0;
+	int32_t			lEntries		= 0;
+	int16_t			sMaxInCell	= 0;
+	if (psmash->m_pGrid != NULL)
+		{
+		lCells	= (int32_t)psmash->m_sGridW * psmash->m_sGridH;
+		int32_t	lCell;
+		for (lCell = 0; lCell < lCells; lCell++)
+			{
+			int16_t	sNum	= psmash->m_pGrid[lCell].m_sNum;
+			if (sNum > 0)
+				{
+				lOccupied++;
+				lEntries	+= sNum;
+				if (sNum > sMaxInCell)
+					sMaxInCell	= sNum;
+				}
+			}
+		}
+	m_file.Write((S32)lCells);
+	m_file.Write((S32)lOccupied);
+	m_file.Write((S32)lEntries);
+	m_file.Write((S16)sMaxInCell);
+
+	// Resources by type, merged across the managers.
+	RResMgr::ResidentType	atypes[MaxResTypes];
+	RResMgr::ResidentType	atypesSamples[MaxResTypes];
+	int16_t	sNumTypes			= g_resmgrGame.GetResidentStats(atypes, MaxResTypes);
+	int16_t	sNumTypesSamples	= g_resmgrSamples.GetResidentStats(atypesSamples, MaxResTypes);
+	int16_t	s;
+	for (s = 0; s < sNumTypesSamples; s++)
+		{
+		int16_t	sType;
+		for (sType = 0; sType < sNumTypes; sType++)
+			{
+			if (strcmp(atypes[sType].szExt, atypesSamples[s].szExt) == 0)
+				break;
+			}
+
+		if (sType == sNumTypes)
+			{
+			if (sNumTypes == MaxResTypes)
+				continue;
+			atypes[sNumTypes++]	= atypesSamples[s];
+			}
+		else
+			{
+			atypes[sType].lNum	+= atypesSamples[s].lNum;
+			atypes[sType].lBytes	+= atypesSamples[s].lBytes;
+			}
+		}
+
+	m_file.Write((S16)sNumTypes);
+	for (s = 0; s < sNumTypes; s++)
+		{
+		m_file.Write(atypes[s].szExt, (int32_t)sizeof(atypes[s].szExt));
+		m_file.Write((S32)atypes[s].lNum);
+		m_file.Write((S32)atypes[s].lBytes);
+		}
+
+	m_lFrame++;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
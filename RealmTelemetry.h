@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// RealmTelemetry.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CRealmTelemetry writes a binary trace of what's in a realm, one record per
+// frame, for looking over long sessions afterwards.  Each record has the
+// number of things of each class and how many were allocated that update,
+// the message and thing pools' usage, resident resources by type, sprites
+// per scene layer and how full the smashatorium's grid is.
+//
+// The file is little endian.  It starts with a header:
+//
+//		U32		FileID
+//		U32		FileVersion
+//		S16		Number of classes (n)
+//		char[]	n '\0' terminated class names, in class ID order
+//
+// and each record is:
+//
+//		U32		RecordID
+//		S32		Frame number (counts from 0 for each file)
+//		S32		Game time (ms)
+//		S16		Number of things
+//		S16[n]	Things of each class
+//		S16[n]	Things of each class allocated during the last update
+//		S32		Message pool nodes in use, allocated
+//		S32		Thing pool things in use, allocated (all classes)
+//		S16		Number of layers (l)
+//		S32[l]	Sprites in each layer
+//		S32		Smash grid cells, cells with anything in them, entries
+//		S16		Most entries in one cell
+//		S16		Number of resource types (r)
+//		r *	{ char[8] extension, S32 resources, S32 bytes }
+//
+// Resources are counted across g_resmgrGame and g_resmgrSamples, and their
+// bytes are what was read to load them.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALMTELEMETRY_H
+#define REALMTELEMETRY_H
+
+#include "RSPiX.h"
+
+class CRealm;
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CRealmTelemetry
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			FileID			= 0x4d4c5452,	// "RTLM" in the file.
+			FileVersion		= 1,
+			RecordID			= 0x454d5246,	// "FRME" in the file.
+			MaxResTypes		= 32				// Most resource types per record.
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CRealmTelemetry();
+
+		// Destructor.
+		~CRealmTelemetry();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Create the trace file and write its header, closing any that was
+		// already open.
+		int16_t Open(					// Returns 0 on success.
+			const char*	pszFile);	// In:  Name of file to create.
+
+		// Close the trace file.
+		void Close(void);
+
+		// Find out whether there's a trace file open.
+		bool IsOpen(void)
+			{ return (m_file.IsOpen() != FALSE) ? true : false; }
+
+		// Write a record of the realm as it is now.  Does nothing if there's
+		// no trace file open.
+		void Sample(					// Returns nothing.
+			CRealm*	prealm);			// In:  Realm to sample.
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		RFile			m_file;				// Trace file.
+		int32_t		m_lFrame;			// Number of records written.
+	};
+
+#endif	// REALMTELEMETRY_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// RenderCache.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RSPiX.h"
+
+#include "RenderCache.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CRenderCache::CRenderCache()
+	{
+	m_lBudget		= 0;
+	m_lNumHits		= 0;
+	m_lNumMisses	= 0;
+
+	// Start with every entry free.
+	int16_t	s;
+	for (s = 0; s < MaxEntries; s++)
+		{
+		m_aentries[s].pim		= NULL;
+		m_aentries[s].sNext	= s + 1;
+		}
+	m_aentries[MaxEntries - 1].sNext	= -1;
+	m_sFree	= 0;
+
+	for (s = 0; s < HashSize; s++)
+		m_asBuckets[s]	= -1;
+
+	m_sHead			= -1;
+	m_sTail			= -1;
+	m_sLastFound	= -1;
+	m_lBytes			= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CRenderCache::~CRenderCache()
+	{
+	Flush();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Set the most bytes of images to keep.
+//////////////////////////////////////////////////////////////////////////////
+void CRenderCache::SetBudget(		// Returns nothing.
+	int32_t	lBytes)					// In:  Budget in bytes.
+	{
+	Flush();
+	m_lBudget	= (lBytes > 0) ? lBytes : 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Forget everything.
+//////////////////////////////////////////////////////////////////////////////
+void CRenderCache::Flush(void)
+	{
+	while (m_sHead != -1)
+		Remove(m_sHead);
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Look for the image rendered for the specified key.
+//////////////////////////////////////////////////////////////////////////////
+RImage* CRenderCache::Find(		// Returns the image or NULL, if none.
+	Key*		pkey,						// In:  Key to look for.
+	bool		bBake,					// In:  true to store it the first time.
+	bool*		pbStore)					// Out: true if the caller should Store().
+	{
+	*pbStore			= false;
+	m_sLastFound	= -1;
+
+	uint32_t	u32Hash	= Hash(pkey);
+	int16_t	sBucket	= (int16_t)(u32Hash % HashSize);
+	int16_t	sEntry	= m_asBuckets[sBucket];
+	while (sEntry != -1)
+		{
+		Entry*	pentry	= &m_aentries[sEntry];
+		if (pentry->u32Hash == u32Hash && memcmp(&pentry->key, pkey, sizeof(Key)) == 0)
+			break;
+		sEntry	= pentry->sHashNext;
+		}
+
+	if (sEntry != -1)
+		{
+		Touch(sEntry);
+		if (m_aentries[sEntry].pim != NULL)
+			{
+			m_lNumHits++;
+			return m_aentries[sEntry].pim;
+			}
+
+		// Seen before, so it's worth keeping.
+		*pbStore			= true;
+		m_sLastFound	= sEntry;
+		}
+	else
+		{
+		// Just remember we've seen it, making room if we have to.
+		if (m_sFree == -1)
+			Remove(m_sTail);
+
+		sEntry	= m_sFree;
+		Entry*	pentry	= &m_aentries[sEntry];
+		m_sFree	= pentry->sNext;
+
+		pentry->key				= *pkey;
+		pentry->u32Hash		= u32Hash;
+		pentry->pim				= NULL;
+		pentry->sPrev			= -1;
+		pentry->sNext			= -1;
+		pentry->sHashNext		= m_asBuckets[sBucket];
+		m_asBuckets[sBucket]	= sEntry;
+
+		// Put it at the front.
+		pentry->sNext	= m_sHead;
+		if (m_sHead != -1)
+			m_aentries[m_sHead].sPrev	= sEntry;
+		m_sHead	= sEntry;
+		if (m_sTail == -1)
+			m_sTail	= sEntry;
+
+		if (bBake == true)
+			{
+			*pbStore			= true;
+			m_sLastFound	= sEntry;
+			}
+		}
+
+	m_lNumMisses++;
+	return NULL;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Copy the specified area of a rendered image into the cache for the key last
+// passed to Find().
+//////////////////////////////////////////////////////////////////////////////
+int16_t CRenderCache::Store(		// Returns 0 on success.
+	RImage*	pimSrc,					// In:  Image the sprite was rendered into.
+	int16_t	sSrcX,					// In:  Area of pimSrc the sprite covers.
+	int16_t	sSrcY,					// In:  Area of pimSrc the sprite covers.
+	int16_t	sW,						// In:  Area of pimSrc the sprite covers.
+	int16_t	sH)						// In:  Area of pimSrc the sprite covers.
+	{
+	int16_t	sResult	= 0;
+
+	if (m_sLastFound != -1 && m_aentries[m_sLastFound].pim == NULL && sW > 0 && sH > 0)
+		{
+		int16_t	sEntry	= m_sLastFound;
+		RImage*	pim		= new RImage;
+		if (pim->CreateImage(sW, sH, RImage::BMP8) == 0)
+			{
+			rspBlit(pimSrc, pim, sSrcX, sSrcY, 0, 0, sW, sH);
+
+			// Compress it, which also makes for a faster transparent blit.
+			// This fails for a blank image, which just stays as it is.
+			pim->Convert(RImage::FSPR8);
+
+			m_aentries[sEntry].pim	= pim;
+			m_lBytes	+= GetImageSize(pim);
+
+			// Stay within budget (this one goes too if it's bigger than that).
+			while (m_lBytes > m_lBudget && m_sTail != -1)
+				Remove(m_sTail);
+			}
+		else
+			{
+			TRACE("Store(): CreateImage() failed.\n");
+			delete pim;
+			sResult	= -1;
+			}
+		}
+
+	m_sLastFound	= -1;
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Make the specified entry the most recently used.
+//////////////////////////////////////////////////////////////////////////////
+void CRenderCache::Touch(			// Returns nothing.
+	int16_t	sEntry)					// In:  Entry.
+	{
+	if (sEntry != m_sHead)
+		{
+		Entry*	pentry	= &m_aentries[sEntry];
+
+		// Unlink (it can't be the head, so it has a prev).
+		m_aentries[pentry->sPrev].sNext	= pentry->sNext;
+		if (pentry->sNext != -1)
+			m_aentries[pentry->sNext].sPrev	= pentry->sPrev;
+		else
+			m_sTail	= pentry->sPrev;
+
+		// Put it at the front.
+		pentry->sPrev	= -1;
+		pentry->sNext	= m_sHead;
+		m_aentries[m_sHead].sPrev	= sEntry;
+		m_sHead	= sEntry;
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Throw out the specified entry and its image, if any.
+//////////////////////////////////////////////////////////////////////////////
+void CRenderCache::Remove(			// Returns nothing.
+	int16_t	sEntry)					// In:  Entry.
+	{
+	Entry*	pentry	= &m_aentries[sEntry];
+
+	// Take it out of the LRU list.
+	if (pentry->sPrev != -1)
+		m_aentries[pentry->sPrev].sNext	= pentry->sNext;
+	else
+		m_sHead	= pentry->sNext;
+	if (pentry->sNext != -1)
+		m_aentries[pentry->sNext].sPrev	= pentry->sPrev;
+	else
+		m_sTail	= pentry->sPrev;
+
+	// Take it out of its bucket.
+	int16_t*	psLink	= &m_asBuckets[pentry->u32Hash % HashSize];
+	while (*psLink != sEntry)
+		psLink	= &m_aentries[*psLink].sHashNext;
+	*psLink	= pentry->sHashNext;
+
+	if (pentry->pim != NULL)
+		{
+		m_lBytes	-= GetImageSize(pentry->pim);
+		delete pentry->pim;
+		pentry->pim	= NULL;
+		}
+
+	if (m_sLastFound == sEntry)
+		m_sLastFound	= -1;
+
+	pentry->sNext	= m_sFree;
+	m_sFree			= sEntry;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get the number of bytes an image is using.
+//////////////////////////////////////////////////////////////////////////////
+// static
+int32_t CRenderCache::GetImageSize(	// Returns size in bytes.
+	RImage*	pim)						// In:  Image.
+	{
+	int32_t	lSize;
+	if (pim->m_type == RImage::FSPR8)
+		{
+		RSpecialFSPR8*	pfspr	= (RSpecialFSPR8*)pim->m_pSpecial;
+		lSize	= sizeof(RSpecialFSPR8)
+				+ pfspr->m_lBufSize
+				+ pfspr->m_lCodeSize
+				+ 2 * (pim->m_sHeight + 1) * sizeof(uint8_t*);
+		}
+	else
+		{
+		lSize	= pim->m_lPitch * pim->m_sHeight;
+		}
+
+	return lSize;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get the hash value for a key (FNV-1a over its bytes).
+//////////////////////////////////////////////////////////////////////////////
+// static
+uint32_t CRenderCache::Hash(		// Returns hash value.
+	Key*		pkey)						// In:  Key.
+	{
+	uint8_t*	pu8		= (uint8_t*)pkey;
+	uint32_t	u32Hash	= 2166136261U;
+	size_t	i;
+	for (i = 0; i < sizeof(Key); i++)
+		{
+		u32Hash	^= pu8[i];
+		u32Hash	*= 16777619U;
+		}
+
+	return u32Hash;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// RenderCache.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CRenderCache remembers what 3D sprites looked like when they were rendered
+// so that one drawn the same way again (an idle guard, a sentry, a prop) can
+// simply be blitted instead of transformed and rasterized all over.  The key
+// is everything that goes into the picture: the sop, mesh and textures, the
+// sprite's transform and bounding sphere, the light table and how it's
+// offset, and whether fog is on.  The scene's own pipeline transforms are
+// not in the key, so the cache must be flushed whenever they change.
+//
+// A key is only given an image the second time it's asked for, so sprites
+// that animate every frame just pass through without the cost of a copy,
+// unless the caller says to bake it right away (e.g., impostors, which are
+// drawn at a few fixed directions so they're sure to come up again).  Images
+// are kept as FSPR8 and dropped least recently used first to stay within a
+// budget of bytes, which starts at 0 (off).
+//
+// Only the picture is kept, not its Z, so this is only good for sprites that
+// don't share a Z buffer with others (i.e., no parent and no children).
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include "RSPiX.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CRenderCache
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			MaxEntries	= 1024,		// Most keys remembered at once.
+			HashSize		= 1024,		// Number of hash buckets.
+			BlendSteps	= 16			// Blends between sops are rounded to this
+											// many steps so a blending sprite can hit.
+			};
+
+		// Everything that determines what a rendered sprite looks like.  Must
+		// be zeroed (see Clear()) before filling in so padding compares equal.
+		typedef struct
+			{
+			RSop*			psop;			// Points.
+			RSop*			psopNext;	// Points blended toward or NULL.
+			REAL			fSopBlend;	// How far they're blended (see QuantizeBlend()).
+			RMesh*		pmesh;		// Triangles.
+			RTexture*	ptex;			// Colors.
+			RAlpha*		plight;		// Light table.
+			REAL			aT[12];		// Sprite's transform (3 row form).
+			RP3d			sphere;		// Sprite's bounding sphere.
+			int16_t		sLightOffset;	// Fog offset passed to Render().
+			int16_t		sFog;			// TRUE if rendered with fog.
+			} Key;
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CRenderCache();
+
+		// Destructor.
+		~CRenderCache();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Zero a key so it can be filled in.
+		static void Clear(			// Returns nothing.
+			Key*		pkey)				// Out: Zeroed key.
+			{ memset(pkey, 0, sizeof(*pkey)); }
+
+		// Round a blend to the nearest of BlendSteps steps.  Sprites that
+		// might be cached must be rendered with the rounded blend, too, so
+		// the picture matches its key.
+		static REAL QuantizeBlend(	// Returns rounded blend.
+			REAL		fBlend)			// In:  Blend (0 to 1).
+			{ return REAL(int16_t(fBlend * BlendSteps + REAL(0.5) ) ) / BlendSteps; }
+
+		// Set the most bytes of images to keep.  0 turns the cache off.
+		// Either way, everything currently cached is flushed.
+		void SetBudget(				// Returns nothing.
+			int32_t	lBytes);			// In:  Budget in bytes.
+
+		// Returns true if the cache is on.
+		bool IsOn(void)
+			{ return m_lBudget > 0; }
+
+		// Forget everything.
+		void Flush(void);
+
+		// Look for the image rendered for the specified key.  If there isn't
+		// one but this key has been asked for before (or bBake is true),
+		// *pbStore is set to true and the caller should render and Store() it.
+		RImage* Find(					// Returns the image or NULL, if none.
+			Key*		pkey,				// In:  Key to look for.
+			bool		bBake,			// In:  true to store it the first time.
+			bool*		pbStore);		// Out: true if the caller should Store().
+
+		// Copy the specified area of a rendered image into the cache for the
+		// key last passed to Find().
+		int16_t Store(					// Returns 0 on success.
+			RImage*	pimSrc,			// In:  Image the sprite was rendered into.
+			int16_t	sSrcX,			// In:  Area of pimSrc the sprite covers.
+			int16_t	sSrcY,			// In:  Area of pimSrc the sprite covers.
+			int16_t	sW,				// In:  Area of pimSrc the sprite covers.
+			int16_t	sH);				// In:  Area of pimSrc the sprite covers.
+
+		// Get the number of Find()s that returned an image and that didn't
+		// (for profiling).
+		int32_t GetNumHits(void)
+			{ return m_lNumHits; }
+		int32_t GetNumMisses(void)
+			{ return m_lNumMisses; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Make the specified entry the most recently used.
+		void Touch(						// Returns nothing.
+			int16_t	sEntry);			// In:  Entry.
+
+		// Throw out the specified entry and its image, if any.
+		void Remove(					// Returns nothing.
+			int16_t	sEntry);			// In:  Entry.
+
+		// Get the number of bytes an image is using.
+		static int32_t GetImageSize(	// Returns size in bytes.
+			RImage*	pim);				// In:  Image.
+
+		// Get the hash value for a key.
+		static uint32_t Hash(		// Returns hash value.
+			Key*		pkey);			// In:  Key.
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		typedef struct
+			{
+			Key		key;				// What was rendered.
+			uint32_t	u32Hash;			// Hash(&key).
+			RImage*	pim;				// What it looked like or NULL, if only seen.
+			int16_t	sPrev;			// Next more recently used entry (-1 if none).
+			int16_t	sNext;			// Next less recently used entry (-1 if none).
+			int16_t	sHashNext;		// Next entry in the same bucket (-1 if none).
+			} Entry;
+
+		Entry		m_aentries[MaxEntries];	// Entries.
+		int16_t	m_asBuckets[HashSize];	// First entry in each bucket (-1 if none).
+		int16_t	m_sFree;						// First free entry (chained by sNext).
+		int16_t	m_sHead;						// Most recently used entry (-1 if none).
+		int16_t	m_sTail;						// Least recently used entry (-1 if none).
+		int16_t	m_sLastFound;				// Entry last passed to Find() (-1 if none).
+
+		int32_t	m_lBudget;					// Most bytes of images to keep.
+		int32_t	m_lBytes;					// Bytes of images kept.
+
+		int32_t	m_lNumHits;					// Find()s that returned an image.
+		int32_t	m_lNumMisses;				// Find()s that didn't.
+	};
+
+#endif	// RENDERCACHE_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -107,7 +107,7 @@ class CSndRelay : public CThing
 			CThing** ppNew)										// Out: Pointer to new object
 			{
 			int16_t sResult = 0;
-			*ppNew = new CSndRelay(pRealm);
+			*ppNew = new (pRealm, CSndRelayID) CSndRelay(pRealm);
 			if (*ppNew == 0)
 				{
 				sResult = -1;
@@ -443,9 +443,11 @@ void Transform(RSop* psopSrc, RSop* psopDst, RPipeLine* ppipe, RTransform& tObj)
 #endif
 
 
+	RP3d	pt;
 	for (i = 0; i < psopSrc->m_lNum; i++)
 		{
-		tFull.TransformInto(psopSrc->m_pArray[i], psopDst->m_pArray[i]);
+		psopSrc->GetPt(i, pt);
+		tFull.TransformInto(pt, psopDst->m_pArray[i]);
 		}
 	}
 
@@ -853,6 +855,9 @@ CTexEdit::DoOutput(
 	int16_t sOffsetY,		// In:  Y offset.
 	RRect& rcClip)			// In:  Dst clip rect.
 	{
+	// Render3D() uses the bounding sphere Cull3D() puts on screen.
+	m_scene.Cull3D(sOffsetX, sOffsetY, psprite, NULL, &rcClip);
+
 	m_scene.Render3D(
 		pimDst,			// Destination image.     
 		sOffsetX,		// Destination 2D x coord.
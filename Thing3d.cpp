@@ -629,8 +629,28 @@ void CThing3d::Render(void)
 		// Update sprite in scene
 		m_pRealm->m_scene.UpdateSprite(&m_sprite);
 		
-		// Set transform.
-		m_sprite.m_ptrans = &m_trans;
+		// If this can be drawn as an impostor (and has no children, which
+		// would keep it from being baked anyway) . . .
+		if (m_bImpostor == true && m_pRealm->m_scene.m_bImpostors == true && m_sprite.m_psprHeadChild == NULL)
+			{
+			// Face the nearest of a few fixed directions so each frame only has
+			// to be baked that many times.  This is only for looks, so m_trans,
+			// which others use to find points on us, is left alone.
+			int16_t	sDir	= ( (rspMod360(m_dRot) * ImpostorDirs + 180) / 360) % ImpostorDirs;
+			m_transImpostor.Make1();
+			m_transImpostor.Scale(m_dScaleX,m_dScaleY,m_dScaleZ);
+			m_transImpostor.Ry(sDir * 360 / ImpostorDirs);
+			m_transImpostor.Rz(rspMod360(m_dRotZ) );
+
+			m_sprite.m_ptrans = &m_transImpostor;
+			m_sprite.m_sInFlags |= CSprite::InImpostor;
+			}
+		else
+			{
+			// Set transform.
+			m_sprite.m_ptrans = &m_trans;
+			m_sprite.m_sInFlags &= ~CSprite::InImpostor;
+			}
 
 		// If the item is above the ground, show the shadow sprite, else hide it.
 		if (m_bAboveTerrain)
@@ -675,7 +695,13 @@ void CThing3d::Render(void)
 	ASSERT(m_panimCur != NULL);
 
 	m_sprite.m_pmesh = (RMesh*) m_panimCur->m_pmeshes->GetAtTime(m_lAnimTime);
-	m_sprite.m_psop = (RSop*) m_panimCur->m_psops->GetAtTime(m_lAnimTime);
+	m_sprite.m_psop = m_panimCur->GetSop(m_lAnimTime, &m_sprite.m_psopNext, &m_sprite.m_fSopBlend);
+	// Impostors are baked once per key, so they don't blend.
+	if (m_sprite.m_sInFlags & CSprite::InImpostor)
+		{
+		m_sprite.m_psopNext = NULL;
+		m_sprite.m_fSopBlend = 0;
+		}
 	m_sprite.m_ptex = (RTexture*) m_panimCur->m_ptextures->GetAtTime(m_lAnimTime);
 	m_sprite.m_psphere = (RP3d*) m_panimCur->m_pbounds->GetAtTime(m_lAnimTime);
 	}
@@ -1407,13 +1433,13 @@ void CThing3d::OnBurnMsg(	// Returns nothing.
 	{
 	CFire*	pfire;
 	// If we don't already have a fire . . .
-	if (m_pRealm->m_idbank.GetThingByID((CThing**)&pfire, m_u16IdFire) != 0)
+	if (m_pRealm->m_idbank.GetThingByHandle((CThing**)&pfire, m_hFire) != 0)
 		{
 		// Make a fire and remember its ID.
 		if (CThing::ConstructWithID(CThing::CFireID, m_pRealm, (CThing**) &pfire) == 0)
 			{
 			// Store its ID.
-			m_u16IdFire	= pfire->GetInstanceID();
+			m_hFire	= m_pRealm->m_idbank.GetHandle(pfire->GetInstanceID());
 
 			// Put it in the thing3d's midsection.
 			pfire->Setup(					
@@ -1471,7 +1497,7 @@ void CThing3d::UpdateFirePosition(void)
 	{
 	CFire*	pfire;
 	// If there is a fire . . .
-	if (m_pRealm->m_idbank.GetThingByID((CThing**)&pfire, m_u16IdFire) == 0)
+	if (m_pRealm->m_idbank.GetThingByHandle((CThing**)&pfire, m_hFire) == 0)
 		{
 		// Update its position.
 		pfire->m_dX	= m_dX;
@@ -1488,7 +1514,7 @@ void CThing3d::UpdateFirePosition(void)
 		}
 	else
 		{
-		m_u16IdFire	= CIdBank::IdNil;
+		m_hFire	= CIdBank::HandleNil;
 		}
 	}
 
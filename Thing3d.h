@@ -185,7 +185,8 @@ class CThing3d : public CThing
 			MaxForeVel				= 80,		// In realm units per second.
 			MaxBackVel				= -60,	// In realm units per second.
 			DefHitPoints			= 125,
-			SoundHalfLife			= 1000	// Default sound half life.
+			SoundHalfLife			= 1000,	// Default sound half life.
+			ImpostorDirs			= 16		// Directions an impostor can face.
 			};
 
 		typedef enum
@@ -329,7 +330,7 @@ class CThing3d : public CThing
 		int16_t  m_sPrevHeight;				// Previous height
 		int16_t  m_sSuspend;					// Suspend flag
 
-		U16	m_u16IdFire;					// ID of fire to carry around when you are burning.
+		CIdBank::Handle	m_hFire;	// Fire to carry around when you are burning.
 
 		CSprite3 m_sprite;					// 3D Sprite used to render the 3D Thing.
 		CSprite2	m_spriteShadow;			// 2D shadow sprite to be shown on the ground
@@ -343,6 +344,11 @@ class CThing3d : public CThing
 													// Used to determine the delta time to add
 													// to m_lAnimTime.
 		RTransform	m_trans;					// Transform to apply on Render.
+		RTransform	m_transImpostor;		// Transform actually rendered with when
+													// drawn as an impostor.
+
+		bool	m_bImpostor;					// true, if this can be drawn as an impostor
+													// (see CScene::m_bImpostors).
 
 		State	m_state;							// Current state of this thing3d.
 
@@ -409,7 +415,7 @@ class CThing3d : public CThing
 			m_sprite.m_pthing	= this;
 			m_sSuspend			= 0;
 			m_sBrightness		= 0;
-			m_u16IdFire			= CIdBank::IdNil;
+			m_hFire				= CIdBank::HandleNil;
 			m_bAboveTerrain	= false;
 			m_stockpile.m_sHitPoints	= DefHitPoints;
 			m_u16IdParent		= CIdBank::IdNil;
@@ -419,6 +425,7 @@ class CThing3d : public CThing
 			m_lAnimTime = 0;
 			m_lTimer = 0;
 			m_sLayerOverride	= -1;
+			m_bImpostor			= false;
 
 			// Default to the standard.
 			m_pap2dAttribCheckPoints	= ms_apt2dAttribCheckMedium;
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// ThingPool.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <new>
+
+#include "RSPiX.h"
+
+#include "ThingPool.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CThingPool::CThingPool()
+	{
+	m_sizeThing			= 0;
+	m_sizeStride		= 0;
+	m_pslabHead			= NULL;
+	m_phdrFree			= NULL;
+	m_lNumUsed			= 0;
+	m_lNumAllocated	= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CThingPool::~CThingPool()
+	{
+	if (m_lNumUsed != 0)
+		{
+		TRACE("~CThingPool(): %ld thing(s) still in use!\n", (long)m_lNumUsed);
+		}
+
+	while (m_pslabHead != NULL)
+		{
+		Slab*	pslab		= m_pslabHead;
+		m_pslabHead		= pslab->pNext;
+		::operator delete(pslab);
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Allocate another slab and add its things to the free list.
+//////////////////////////////////////////////////////////////////////////////
+void CThingPool::Grow(void)
+	{
+	Slab*	pslab		= (Slab*)::operator new(sizeof(Slab) + m_sizeStride * ThingsPerSlab);
+	pslab->pNext	= m_pslabHead;
+	m_pslabHead		= pslab;
+
+	// Thread them so they come off the free list in address order.
+	uint8_t*	pu8Things	= (uint8_t*)(pslab + 1);
+	int16_t	s;
+	for (s = ThingsPerSlab - 1; s >= 0; s--)
+		{
+		Header*	phdr	= (Header*)(pu8Things + m_sizeStride * s);
+		phdr->pNextFree	= m_phdrFree;
+		m_phdrFree			= phdr;
+		}
+
+	m_lNumAllocated	+= ThingsPerSlab;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get memory for a thing, growing the pool if necessary.
+//////////////////////////////////////////////////////////////////////////////
+void* CThingPool::Alloc(		// Returns memory for the thing.
+	size_t	sizeThing)			// In:  Size of the thing.
+	{
+	if (m_sizeThing == 0)
+		{
+		// Round up so the next header stays aligned.
+		m_sizeThing		= sizeThing;
+		m_sizeStride	= sizeof(Header) + ((sizeThing + sizeof(Header) - 1) / sizeof(Header)) * sizeof(Header);
+		}
+
+	// A pool only ever serves one class so this shouldn't happen, but if it
+	// does the heap can take care of it.
+	if (sizeThing > m_sizeThing)
+		{
+		TRACE("Alloc(): Size %lu doesn't fit this pool's %lu.\n", (unsigned long)sizeThing, (unsigned long)m_sizeThing);
+		return AllocHeap(sizeThing);
+		}
+
+	if (m_phdrFree == NULL)
+		Grow();
+
+	Header*	phdr	= m_phdrFree;
+	m_phdrFree		= phdr->pNextFree;
+	phdr->ppool		= this;
+	m_lNumUsed++;
+
+	return phdr + 1;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Get memory for a thing straight from the heap.
+//////////////////////////////////////////////////////////////////////////////
+void* CThingPool::AllocHeap(	// Returns memory for the thing.
+	size_t	sizeThing)			// In:  Size of the thing.
+	{
+	Header*	phdr	= (Header*)::operator new(sizeof(Header) + sizeThing);
+	phdr->ppool		= NULL;
+
+	return phdr + 1;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Return memory from Alloc() or AllocHeap() to wherever it came from.
+//////////////////////////////////////////////////////////////////////////////
+void CThingPool::Free(			// Returns nothing.
+	void*		pvThing)			// In:  Memory to free (NULL is okay).
+	{
+	if (pvThing != NULL)
+		{
+		Header*		phdr	= (Header*)pvThing - 1;
+		CThingPool*	ppool	= phdr->ppool;
+		if (ppool != NULL)
+			{
+			phdr->pNextFree	= ppool->m_phdrFree;
+			ppool->m_phdrFree	= phdr;
+			ppool->m_lNumUsed--;
+			}
+		else
+			{
+			::operator delete(phdr);
+			}
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// ThingPool.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CThingPool carves memory for CThings of one class out of large slabs and
+// recycles it through a free list, so short lived things (explosions, fire,
+// chunks, etc.) can come and go without touching the heap once the pool has
+// warmed up.  The realm owns one pool per class ID (see
+// CRealm::m_athingpools) and a class opts in by constructing with
+// new (pRealm, CXxxID) CXxx(pRealm) in its Construct().
+//
+// Every CThing, pooled or not, is preceded by a small header naming the pool
+// it came from (NULL for the heap), which is how CThing's operator delete
+// knows where to return the memory without any help from the realm.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef THINGPOOL_H
+#define THINGPOOL_H
+
+#include "RSPiX.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CThingPool
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			ThingsPerSlab	= 32		// Number of things allocated at once.
+			};
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CThingPool();
+
+		// Destructor.
+		~CThingPool();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Get memory for a thing, growing the pool if necessary.  The first
+		// call fixes the size of the things this pool hands out.  Like the
+		// global operator new, this throws if memory runs out.
+		void* Alloc(					// Returns memory for the thing.
+			size_t	sizeThing);		// In:  Size of the thing.
+
+		// Get memory for a thing straight from the heap, tagged so that Free()
+		// knows to return it there.
+		static void* AllocHeap(		// Returns memory for the thing.
+			size_t	sizeThing);		// In:  Size of the thing.
+
+		// Return memory from Alloc() or AllocHeap() to wherever it came from.
+		static void Free(				// Returns nothing.
+			void*		pvThing);		// In:  Memory to free (NULL is okay).
+
+		// Get the number of things currently in use.
+		int32_t GetNumUsed(void)
+			{ return m_lNumUsed; }
+
+		// Get the number of things allocated.
+		int32_t GetNumAllocated(void)
+			{ return m_lNumAllocated; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Allocate another slab and add its things to the free list.
+		void Grow(void);
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Precedes every thing.  The union keeps the thing itself aligned as
+		// well as the heap would have.
+		typedef union Header
+			{
+			CThingPool*	ppool;		// Pool thing came from or NULL for the heap.
+			Header*		pNextFree;	// Next free thing, while on the free list.
+			long double	ldAlign;		// Alignment only.
+			} Header;
+
+		// Precedes each slab's things.  Slabs are only freed when the pool is
+		// destroyed.
+		typedef union Slab
+			{
+			Slab*			pNext;		// Next slab.
+			long double	ldAlign;		// Alignment only.
+			} Slab;
+
+		size_t		m_sizeThing;		// Size of each thing (0 until first Alloc()).
+		size_t		m_sizeStride;		// Size of each thing including its header.
+		Slab*			m_pslabHead;		// Slabs allocated so far.
+		Header*		m_phdrFree;			// Free things.
+		int32_t		m_lNumUsed;			// Things currently in use.
+		int32_t		m_lNumAllocated;	// Things allocated.
+	};
+
+#endif	// THINGPOOL_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
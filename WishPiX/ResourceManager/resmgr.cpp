@@ -203,6 +203,7 @@
 RResMgr::RResMgr(void)
 {
 	m_bTraceUncachedLoads = false;
+	m_lLastLoadSize = 0;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -277,6 +278,7 @@ int16_t RResMgr::Get(									// Returns 0 on success.
 			// Fill in the resource block.
 			(*(p.first)).second.m_vpRes = *hRes;
 			(*(p.first)).second.m_pfnDestroy	= pfnDestroy;
+			(*(p.first)).second.m_lSize = m_lLastLoadSize;
 
 			// Clear pointer so that the object won't be deleted on exit from this function.
 			// The responsibility for deleting the object now lies with the resource block.
@@ -385,8 +387,10 @@ int16_t RResMgr::GetInstance(						// Returns 0 on success.
 			{
 			// Set endian for this file.
 			pfileSrc->SetEndian(endian);
-			// Let resource load itself from the file
+			// Let resource load itself from the file, noting how much it reads
+			int32_t	lStart	= pfileSrc->Tell();
 			sReturn	= (*pfnLoad)(pvInstance, pfileSrc);
+			m_lLastLoadSize	= pfileSrc->Tell() - lStart;
 			// Restore endian to SAK file mode (although this may or may not be
 			// the SAK file (it can't hurt (can it?) ) ).
 			pfileSrc->SetEndian(SAK_FILE_ENDIAN);
@@ -512,6 +516,66 @@ void RResMgr::Purge(void)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////
+//
+// GetResidentStats
+//
+// Description:
+//		Groups the loaded resources by the extension of their names and
+//		reports how many of each type there are and how many bytes were
+//		read to load them.  If there are more types than fit, the rest
+//		are left out.
+//
+// Parameters:
+//		ptypes = array to fill in
+//		sMaxTypes = size of that array
+//
+// Returns:
+//		Number of types filled in
+//
+//////////////////////////////////////////////////////////////////////
+
+int16_t RResMgr::GetResidentStats(ResidentType* ptypes, int16_t sMaxTypes)
+{
+	int16_t sNumTypes = 0;
+	resclassMap::iterator i;
+
+	for (i = m_map.begin(); i != m_map.end(); i++)
+	{
+		if ((*i).second.m_vpRes == NULL)
+			continue;
+
+		// Names are normalized to '/' so the extension is whatever follows
+		// the last '.' after the last '/'.
+		const char* pszName = (const char*)(*i).first;
+		const char* pszExt = strrchr(pszName, '.');
+		if (pszExt == NULL || strchr(pszExt, '/') != NULL || strlen(pszExt) >= sizeof(ptypes[0].szExt))
+			pszExt = "";
+
+		int16_t sType;
+		for (sType = 0; sType < sNumTypes; sType++)
+		{
+			if (strcmp(ptypes[sType].szExt, pszExt) == 0)
+				break;
+		}
+
+		if (sType == sNumTypes)
+		{
+			if (sNumTypes == sMaxTypes)
+				continue;
+			strcpy(ptypes[sType].szExt, pszExt);
+			ptypes[sType].lNum = 0;
+			ptypes[sType].lBytes = 0;
+			sNumTypes++;
+		}
+
+		ptypes[sType].lNum++;
+		ptypes[sType].lBytes += (*i).second.m_lSize;
+	}
+
+	return sNumTypes;
+}
+
 //////////////////////////////////////////////////////////////////////
 //
 // FreeAllResources
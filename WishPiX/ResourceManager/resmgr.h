@@ -333,6 +333,7 @@ class CResourceBlock
 
 		int16_t  m_sRefCount;
 		int16_t  m_sAccessCount;
+		int32_t  m_lSize;				// Bytes read to load the resource
 		void*  m_vpRes;
 		RString m_strFilename;
 		GenericDestroyResFunc* m_pfnDestroy;
@@ -341,6 +342,7 @@ class CResourceBlock
 			{
 			m_sRefCount = 0;
 			m_sAccessCount = 0;
+			m_lSize = 0;
 			m_vpRes = NULL;
 			m_pfnDestroy = 0;
 			};
@@ -402,6 +404,14 @@ class RResMgr
 	// Typedefs.
 	////////////////////////////////////////////////////////////////////////////
 	public:
+		// Resources of one type (all those whose names have the same
+		// extension), as reported by GetResidentStats().
+		typedef struct
+			{
+			char		szExt[8];		// Extension, including the '.' ("" for none)
+			int32_t	lNum;				// Number of these resources loaded
+			int32_t	lBytes;			// Bytes read to load them
+			} ResidentType;
 		
 	public:
 		
@@ -437,6 +447,13 @@ class RResMgr
 		// Purge - deallocate all resources with a zero reference count
 		void Purge(void);
 
+		// Fill in how many resources of each type are loaded and how many
+		// bytes were read to load them, which is a fair measure of the memory
+		// they take up.  Types are in no particular order.
+		int16_t GetResidentStats(						// Returns the number of types filled in
+			ResidentType* ptypes,						// Out: Types
+			int16_t sMaxTypes);							// In:  Size of ptypes
+
 		// Function to turn on or off tracing of non-cached loads
 		void TraceUncachedLoads(bool bShow)
 		{
@@ -573,6 +590,9 @@ class RResMgr
 		// resources were loaded from disk after that point.
 		bool m_bTraceUncachedLoads;
 
+		// Bytes read by the last successful GetInstance() (for Get()).
+		int32_t m_lLastLoadSize;
+
 		// m_map is a map of filenames to CResourceBlocks for fast
 		// access using the resource filename for lookup
 		resclassMap m_map;
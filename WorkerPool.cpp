@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// WorkerPool.cpp
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// See .H for details.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "SDL.h"
+
+#include "RSPiX.h"
+
+#include "WorkerPool.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Default constructor.
+//////////////////////////////////////////////////////////////////////////////
+CWorkerPool::CWorkerPool()
+	{
+	m_sNumThreads	= 0;
+	m_psemDone		= NULL;
+	m_bQuit			= false;
+	m_fnWork			= NULL;
+	m_pvUser			= NULL;
+	m_lNumItems		= 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Destructor.
+//////////////////////////////////////////////////////////////////////////////
+CWorkerPool::~CWorkerPool()
+	{
+	Stop();
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Start the specified number of threads.
+//////////////////////////////////////////////////////////////////////////////
+int16_t CWorkerPool::Start(		// Returns 0 on success.
+	int16_t	sNumThreads)			// In:  Number of threads (not counting the caller).
+	{
+	int16_t	sResult	= 0;
+
+	Stop();
+
+	if (sNumThreads > MaxThreads)
+		sNumThreads	= MaxThreads;
+
+	if (sNumThreads > 0)
+		{
+		m_psemDone	= SDL_CreateSemaphore(0);
+		if (m_psemDone != NULL)
+			{
+			m_bQuit	= false;
+			while (m_sNumThreads < sNumThreads)
+				{
+				Thread*	pt		= &m_athreads[m_sNumThreads];
+				pt->ppool		= this;
+				pt->sPiece		= m_sNumThreads;
+				pt->psemStart	= SDL_CreateSemaphore(0);
+				if (pt->psemStart == NULL)
+					{
+					TRACE("Start(): SDL_CreateSemaphore() failed: %s.\n", SDL_GetError());
+					sResult	= -1;
+					break;
+					}
+
+				pt->pthread	= SDL_CreateThread(Worker, "CWorkerPool", pt);
+				if (pt->pthread == NULL)
+					{
+					TRACE("Start(): SDL_CreateThread() failed: %s.\n", SDL_GetError());
+					SDL_DestroySemaphore(pt->psemStart);
+					sResult	= -1;
+					break;
+					}
+
+				m_sNumThreads++;
+				}
+			}
+		else
+			{
+			TRACE("Start(): SDL_CreateSemaphore() failed: %s.\n", SDL_GetError());
+			sResult	= -2;
+			}
+
+		if (sResult != 0)
+			{
+			Stop();
+			}
+		}
+
+	return sResult;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Stop the threads.
+//////////////////////////////////////////////////////////////////////////////
+void CWorkerPool::Stop(void)
+	{
+	if (m_sNumThreads > 0)
+		{
+		m_bQuit	= true;
+
+		int16_t	s;
+		for (s = 0; s < m_sNumThreads; s++)
+			SDL_SemPost(m_athreads[s].psemStart);
+
+		for (s = 0; s < m_sNumThreads; s++)
+			{
+			SDL_WaitThread(m_athreads[s].pthread, NULL);
+			SDL_DestroySemaphore(m_athreads[s].psemStart);
+			}
+
+		m_sNumThreads	= 0;
+		}
+
+	if (m_psemDone != NULL)
+		{
+		SDL_DestroySemaphore(m_psemDone);
+		m_psemDone	= NULL;
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Do items 0 through lNumItems - 1, spread across the threads and the caller.
+//////////////////////////////////////////////////////////////////////////////
+void CWorkerPool::Run(				// Returns nothing.
+	WorkFunc	fnWork,					// In:  Function to do the items.
+	void*		pvUser,					// In:  Passed to fnWork.
+	int32_t	lNumItems)				// In:  Number of items.
+	{
+	if (m_sNumThreads == 0)
+		{
+		(*fnWork)(pvUser, 0, 0, lNumItems);
+		}
+	else if (lNumItems > 0)
+		{
+		m_fnWork		= fnWork;
+		m_pvUser		= pvUser;
+		m_lNumItems	= lNumItems;
+
+		int16_t	s;
+		for (s = 0; s < m_sNumThreads; s++)
+			SDL_SemPost(m_athreads[s].psemStart);
+
+		// The caller does the last piece.
+		DoPiece(m_sNumThreads);
+
+		for (s = 0; s < m_sNumThreads; s++)
+			SDL_SemWait(m_psemDone);
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Do the specified piece of the current job.
+//////////////////////////////////////////////////////////////////////////////
+void CWorkerPool::DoPiece(			// Returns nothing.
+	int16_t	sPiece)					// In:  Piece (0 to m_sNumThreads).
+	{
+	int32_t	lNumPieces	= m_sNumThreads + 1;
+	int32_t	lFirst		= (int32_t)(((int64_t)m_lNumItems * sPiece) / lNumPieces);
+	int32_t	lEnd			= (int32_t)(((int64_t)m_lNumItems * (sPiece + 1)) / lNumPieces);
+	if (lEnd > lFirst)
+		{
+		(*m_fnWork)(m_pvUser, sPiece, lFirst, lEnd);
+		}
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// Thread entry point.  Waits for a job, does its piece and reports back until
+// told to quit.
+//////////////////////////////////////////////////////////////////////////////
+// static
+int CWorkerPool::Worker(			// Returns 0.
+	void*		pvWorker)				// In:  This thread's Thread.
+	{
+	Thread*			pt		= (Thread*)pvWorker;
+	CWorkerPool*	ppool	= pt->ppool;
+
+	for (;;)
+		{
+		SDL_SemWait(pt->psemStart);
+		if (ppool->m_bQuit == true)
+			break;
+
+		ppool->DoPiece(pt->sPiece);
+
+		SDL_SemPost(ppool->m_psemDone);
+		}
+
+	return 0;
+	}
+
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// WorkerPool.H
+//
+//////////////////////////////////////////////////////////////////////////////
+//
+// CWorkerPool keeps a few threads waiting to help run a loop.  Run() cuts
+// the loop's range into one contiguous piece per thread plus one for the
+// caller, and doesn't return until every piece is done.  Which thread gets
+// which piece is fixed, but nothing about the work should depend on it:
+// work functions must only touch what belongs to their own items, plus
+// anything kept per piece (see the piece number passed to them).
+//
+// With no threads started, Run() simply does the whole loop itself as piece
+// 0.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include "RSPiX.h"
+
+struct SDL_Thread;
+struct SDL_semaphore;
+
+//////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+//////////////////////////////////////////////////////////////////////////////
+
+class CWorkerPool
+	{
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Macros.
+//////////////////////////////////////////////////////////////////////////////
+		enum
+			{
+			MaxThreads	= 16		// Most threads a pool can have.
+			};
+
+		// Does items lFirst through lEnd - 1.  Pieces are numbered in item
+		// order.
+		typedef void (*WorkFunc)(
+			void*		pvUser,		// In:  User value passed to Run().
+			int16_t	sPiece,		// In:  Piece (0 to GetNumThreads()).
+			int32_t	lFirst,		// In:  First item.
+			int32_t	lEnd);		// In:  One past the last item.
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Con/Destruction.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Default constructor.
+		CWorkerPool();
+
+		// Destructor.
+		~CWorkerPool();
+
+//////////////////////////////////////////////////////////////////////////////
+	public:	// Public calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Start the specified number of threads, stopping any that are already
+		// running first.  0 just stops them.
+		int16_t Start(					// Returns 0 on success.
+			int16_t	sNumThreads);	// In:  Number of threads (not counting the caller).
+
+		// Stop the threads.
+		void Stop(void);
+
+		// Do items 0 through lNumItems - 1, spread across the threads and the
+		// caller.  Returns once they're all done.
+		void Run(						// Returns nothing.
+			WorkFunc	fnWork,			// In:  Function to do the items.
+			void*		pvUser,			// In:  Passed to fnWork.
+			int32_t	lNumItems);		// In:  Number of items.
+
+		// Get the number of threads (not counting the caller).
+		int16_t GetNumThreads(void)
+			{ return m_sNumThreads; }
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal calls.
+//////////////////////////////////////////////////////////////////////////////
+
+		// Do the specified piece of the current job.
+		void DoPiece(					// Returns nothing.
+			int16_t	sPiece);			// In:  Piece (0 to m_sNumThreads).
+
+		// Thread entry point.
+		static int Worker(			// Returns 0.
+			void*		pvWorker);		// In:  This thread's Thread.
+
+//////////////////////////////////////////////////////////////////////////////
+	protected:	// Internal variables.
+//////////////////////////////////////////////////////////////////////////////
+
+		typedef struct
+			{
+			CWorkerPool*	ppool;	// Pool this thread belongs to.
+			int16_t			sPiece;	// Piece of each job this thread does.
+			SDL_Thread*		pthread;	// The thread.
+			SDL_semaphore*	psemStart;	// Posted to start this thread on a job.
+			} Thread;
+
+		Thread			m_athreads[MaxThreads];	// The threads.
+		int16_t			m_sNumThreads;				// Number of threads running.
+		SDL_semaphore*	m_psemDone;					// Posted by each thread when it's done.
+		bool				m_bQuit;						// true to tell threads to exit.
+
+		WorkFunc			m_fnWork;					// Current job's function.
+		void*				m_pvUser;					// Current job's user value.
+		int32_t			m_lNumItems;				// Current job's number of items.
+	};
+
+#endif	// WORKERPOOL_H
+//////////////////////////////////////////////////////////////////////////////
+// EOF
+//////////////////////////////////////////////////////////////////////////////
@@ -356,7 +356,7 @@ class CLogTabVar_DudeHealth : CLogTabVar<CPerson*>
 			if (pPerson->SelectDude() == SUCCESS)
 			{
 				CDude*	pdude;
-				if (pPerson->m_pRealm->m_idbank.GetThingByID((CThing**)&pdude, pPerson->m_idDude) == 0)
+				if (pPerson->m_pRealm->m_idbank.GetThingByHandle((CThing**)&pdude, pPerson->m_hDude) == 0)
 				{
 					int16_t sHitPoints = pdude->GetHealth();
 					if (sHitPoints > 80)
@@ -592,7 +592,7 @@ bool CCharacter::WhileBurning(void)	// Returns true until state is complete.
 
 	// If the fire still exists . . .
 	CFire*	pfire;
-	if (m_pRealm->m_idbank.GetThingByID((CThing**)&pfire, m_u16IdFire) == 0)
+	if (m_pRealm->m_idbank.GetThingByHandle((CThing**)&pfire, m_hFire) == 0)
 		{
 		// If the fire is still burning . . .
 		if (pfire->IsBurning() != FALSE)
@@ -1104,7 +1104,7 @@ CWeapon* CCharacter::PrepareWeapon(void)	// Returns the weapon ptr or NULL.
 			if (ConstructWithID(m_eWeaponType, m_pRealm, (CThing**) &pweapon) == 0)
 				{
 				// Set its parent.
-				pweapon->m_idParent = GetInstanceID();
+				pweapon->m_hParent = m_pRealm->m_idbank.GetHandle(GetInstanceID());
 				// Set it up.
 				pweapon->Setup(0, 0, 0);
 				pweapon->m_dRot = m_dRot;
@@ -1223,7 +1223,7 @@ CWeapon* CCharacter::ShootWeapon(	// Returns the weapon ptr or NULL
 				pweapon->m_eState = CWeapon::State_Fire;
 				
 				// Detach parent pointer
-				pweapon->m_idParent = CIdBank::IdNil;
+				pweapon->m_hParent = CIdBank::HandleNil;
 				// Detatch weapon's sprite
 				CSprite*	pspriteWeapon	= pweapon->GetSprite();
 				if (pspriteWeapon)
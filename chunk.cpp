@@ -111,28 +111,31 @@ void CChunk::Resume(void)
 	m_sSuspend--;
 	}
 
+////////////////////////////////////////////////////////////////////////////////
+// Advance object's own state ahead of Update() (may be on another thread).
+////////////////////////////////////////////////////////////////////////////////
+void CChunk::UpdateParallel(
+	CDeferList*	pdefer)		// In:  Where to put side effects.
+	{
+	Advance();
+	m_bAdvanced	= true;
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Update object
 ////////////////////////////////////////////////////////////////////////////////
 void CChunk::Update(void)
 	{
-	int32_t	lCurTime		= m_pRealm->m_time.GetGameTime();
-
-	double	dSeconds	= (lCurTime - m_lPrevTime) / 1000.0;
-	m_lPrevTime			= lCurTime;
-
-	double	dDist		= m_dVel	* dSeconds;
-
-	m_dX					+= COSQ[(int16_t)m_dRot] * dDist;
-	m_dZ					-= SINQ[(int16_t)m_dRot] * dDist;
-
-	double dVertDeltaVel	= g_dAccelerationDueToGravity * dSeconds;
-	m_dVertVel			+= dVertDeltaVel;
+	// Move, unless the realm's parallel phase already did it for us.
+	if (m_bAdvanced == false)
+		{
+		Advance();
+		}
 
-	m_dY					+= (m_dVertVel - dVertDeltaVel / 2) * dSeconds;
+	m_bAdvanced	= false;
 
 	// If we have hit terrain . . .
-	if (m_pRealm->GetHeight(m_dX, m_dZ) >= m_dY)
+	if (m_bLanded == true)
 		{
 		int16_t	sX2d, sY2d;
 		// Map from 3d to 2d coords.
@@ -187,6 +190,30 @@ void CChunk::Update(void)
 		}
 	}
 
+////////////////////////////////////////////////////////////////////////////////
+// Move and note whether we've hit terrain.  Only touches our own members so
+// it's safe to call from UpdateParallel().
+////////////////////////////////////////////////////////////////////////////////
+void CChunk::Advance(void)
+	{
+	int32_t	lCurTime		= m_pRealm->m_time.GetGameTime();
+
+	double	dSeconds	= (lCurTime - m_lPrevTime) / 1000.0;
+	m_lPrevTime			= lCurTime;
+
+	double	dDist		= m_dVel	* dSeconds;
+
+	m_dX					+= COSQ[(int16_t)m_dRot] * dDist;
+	m_dZ					-= SINQ[(int16_t)m_dRot] * dDist;
+
+	double dVertDeltaVel	= g_dAccelerationDueToGravity * dSeconds;
+	m_dVertVel			+= dVertDeltaVel;
+
+	m_dY					+= (m_dVertVel - dVertDeltaVel / 2) * dSeconds;
+
+	m_bLanded			= (m_pRealm->GetHeight(m_dX, m_dZ) >= m_dY);
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Render object
 ////////////////////////////////////////////////////////////////////////////////
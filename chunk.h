@@ -88,6 +88,10 @@ class CChunk : public CThing
 		Type	m_type;
 
 		int16_t	m_sLen;									// Length of item.
+
+		bool	m_bAdvanced;							// true, if UpdateParallel() has moved us
+															// since the last Update().
+		bool	m_bLanded;								// true, if we've hit terrain.
 														
 	protected:
 		CSpriteLine2d		m_sprite;				// Sprite.
@@ -118,6 +122,8 @@ class CChunk : public CThing
 			m_dVel				= 0.0;
 			m_dVertVel			= 0.0;
 			m_sLen				= 0;
+			m_bAdvanced			= false;
+			m_bLanded			= false;
 
 			m_sprite.m_pthing		= this;
 			m_sprite.m_u8Color	= 1;
@@ -147,7 +153,7 @@ class CChunk : public CThing
 			// Don't allow chunks when disabled . . .
 			if (g_GameSettings.m_sParticleEffects)
 				{
-				*ppNew = new CChunk(pRealm);
+				*ppNew = new (pRealm, CChunkID) CChunk(pRealm);
 				if (*ppNew == 0)
 					{
 					sResult = -1;
@@ -177,6 +183,10 @@ class CChunk : public CThing
 		// Update object
 		void Update(void);
 
+		// Advance object's own state ahead of Update()
+		void UpdateParallel(
+			CDeferList*	pdefer);		// In:  Where to put side effects.
+
 		// Render object
 		void Render(void);
 
@@ -206,6 +216,8 @@ class CChunk : public CThing
 	// Internal functions
 	//---------------------------------------------------------------------------
 	protected:
+		// Move and note whether we've hit terrain.
+		void Advance(void);
 	};
 
 
@@ -582,7 +582,7 @@ void CDispenser::Update(void)
 				case Exists:
 					{
 					// If we don't have one . . .
-					if (m_u16IdDispensee == CIdBank::IdNil)
+					if (m_hDispensee == CIdBank::HandleNil)
 						{
 						if (lCurTime >= m_lNextUpdate)
 							{
@@ -599,10 +599,10 @@ void CDispenser::Update(void)
 						{
 						// If the last one no longer exists . . .
 						CThing* pthing;
-						if (m_pRealm->m_idbank.GetThingByID(&pthing, m_u16IdDispensee) != 0)
+						if (m_pRealm->m_idbank.GetThingByHandle(&pthing, m_hDispensee) != 0)
 							{
 							// Clear our ID.
-							m_u16IdDispensee	= CIdBank::IdNil;
+							m_hDispensee	= CIdBank::HandleNil;
 							// Set the next update time.
 							if (m_alLogicParms[1] - m_alLogicParms[0] > 0)
 								{
@@ -1297,7 +1297,7 @@ int16_t CDispenser::InstantiateDispensee(	// Returns 0 on success.
 						(*ppthing)->SetInstanceID(idInstance);
 						
 						// Success.  
-						m_u16IdDispensee	= idInstance;
+						m_hDispensee	= m_pRealm->m_idbank.GetHandle(idInstance);
 
 						// If in edit mode . . .
 						if (bEditMode == true)
@@ -1574,9 +1574,9 @@ void CDispenser::DestroyDispensee(	// Returns nothing.
 	if (*ppthing)
 		{
 		// If this one is the one indicated by the ID . . .
-		if ( (*ppthing)->GetInstanceID() == m_u16IdDispensee)
+		if (m_pRealm->m_idbank.GetHandle((*ppthing)->GetInstanceID()) == m_hDispensee)
 			{
-			m_u16IdDispensee	= CIdBank::IdNil;
+			m_hDispensee	= CIdBank::HandleNil;
 			}
 
 		// Destroy the dispensee.
@@ -116,7 +116,7 @@ class CDispenser : public CThing
 		int16_t			m_sNumDispensees;						// Number of dispensees already
 																	// dispensed.
 
-		U16			m_u16IdDispensee;						// ID of the last dispensee
+		CIdBank::Handle	m_hDispensee;							// Handle of the last dispensee
 																	// we created.
 
 		int32_t			m_lNextUpdate;							// Time of next update.
@@ -158,7 +158,7 @@ class CDispenser : public CThing
 			memset(m_alLogicParms, 0, sizeof(m_alLogicParms) );
 			m_sMaxDispensees	= 10;
 			m_sNumDispensees	= 0;
-			m_u16IdDispensee	= CIdBank::IdNil;
+			m_hDispensee		= CIdBank::HandleNil;
 			m_logictype			= Timed;
 			m_bEditMode			= false;
 			m_sDispenseeHotSpotX	= 0;
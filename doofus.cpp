@@ -437,6 +437,7 @@
 #include "SampleMaster.h"
 #include "grenade.h"
 #include "pylon.h"
+#include "FlowField.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Macros/types/etc.
@@ -749,7 +750,7 @@ CDoofus::CDoofus(CRealm* pRealm, ClassIDType id)
 	m_sSuspend = 0;
 	m_pNavNet = NULL;
 	m_u16NavNetID = 0;
-	m_idDude = CIdBank::IdNil;
+	m_hDude = CIdBank::HandleNil;
 	m_pNextBouy = NULL;
 	m_sNextX = m_sNextZ = 0;
 	m_ucDestBouyID = m_ucNextBouyID = 0;
@@ -767,6 +768,8 @@ CDoofus::CDoofus(CRealm* pRealm, ClassIDType id)
 	m_bCivilian = false;
 	m_ptransExecutionTarget	= NULL;
 	m_spriteWeapon.m_pthing	= this;
+	// Enemies and victims can be drawn as impostors (the dude never is).
+	m_bImpostor = true;
 	m_ucSpecialBouy0ID = 0;
 	m_ucSpecialBouy1ID = 0;
 	m_bPanic = false;
@@ -1166,7 +1169,7 @@ int16_t CDoofus::SelectDudeBouy(void)
 	if (SelectDude() == SUCCESS)
 		{
 		CDude*	pdude;
-		if (m_pRealm->m_idbank.GetThingByID((CThing**)&pdude, m_idDude) == 0)
+		if (m_pRealm->m_idbank.GetThingByHandle((CThing**)&pdude, m_hDude) == 0)
 			{
 			m_ucDestBouyID = m_pNavNet->FindNearestBouy(pdude->GetX(), pdude->GetZ());
 			}
@@ -1229,7 +1232,7 @@ int16_t CDoofus::SelectDude(void)
 //	Things::iterator i;
 //	Things* pDudes;
 
-	m_idDude = CIdBank::IdNil;
+	m_hDude = CIdBank::HandleNil;
 	uint32_t	ulSqrDistance;
 	uint32_t	ulCurSqrDistance	= 0xFFFFFFFF;
 	uint32_t	ulDistX;
@@ -1252,13 +1255,13 @@ int16_t CDoofus::SelectDude(void)
 			{
 				// This one is closer.
 				ulCurSqrDistance	= ulSqrDistance;
-				m_idDude	= pdude->GetInstanceID();
+				m_hDude	= m_pRealm->m_idbank.GetHandle(pdude->GetInstanceID());
 			}
 		}
 		pDudeList = pDudeList->m_pnNext;
 	}
 
-	return (m_idDude != CIdBank::IdNil) ? SUCCESS : FAILURE;
+	return (m_hDude != CIdBank::HandleNil) ? SUCCESS : FAILURE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1273,13 +1276,13 @@ int16_t CDoofus::FindDirection()
 	double dX;
 	double dZ;
 
-	if (m_idDude == CIdBank::IdNil)
+	if (m_hDude == CIdBank::HandleNil)
 		SelectDude();
 
-	if (m_idDude != CIdBank::IdNil)
+	if (m_hDude != CIdBank::HandleNil)
 	{
 		CDude*	pdude;
-		if (m_pRealm->m_idbank.GetThingByID((CThing**)&pdude, m_idDude) == 0)
+		if (m_pRealm->m_idbank.GetThingByHandle((CThing**)&pdude, m_hDude) == 0)
 		{
 			dDudeX = pdude->GetX();
 			dDudeZ = pdude->GetZ();
@@ -1306,13 +1309,13 @@ double CDoofus::SQDistanceToDude()
 	double dX;
 	double dZ;
 		
-	if (m_idDude == CIdBank::IdNil)
+	if (m_hDude == CIdBank::HandleNil)
 		SelectDude();
 
-	if (m_idDude != CIdBank::IdNil)
+	if (m_hDude != CIdBank::HandleNil)
 	{
 		CDude*	pdude;
-		if (m_pRealm->m_idbank.GetThingByID((CThing**)&pdude, m_idDude) == 0)
+		if (m_pRealm->m_idbank.GetThingByHandle((CThing**)&pdude, m_hDude) == 0)
 		{
 			dX = pdude->GetX() - m_dX;
 			dZ = pdude->GetZ() - m_dZ;
@@ -1350,10 +1353,49 @@ void CDoofus::AlignToBouy(void)
 			}
 		}
 		m_lAlignTimer = lThisTime + ms_lDefaultAlignTime;
-		m_dAnimRot = m_dRot = rspATan(m_dZ - m_sNextZ, m_sNextX - m_dX);
+		if (AlignToFlowField() == false)
+			m_dAnimRot = m_dRot = rspATan(m_dZ - m_sNextZ, m_sNextX - m_dX);
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// AlignToFlowField - Panicking, walking and marching crowds head for a shared
+//						    destination bouy, so they can all follow that bouy's
+//							 flow field rather than hopping from bouy to bouy.  Once
+//							 on the field we aim straight for the destination, which
+//							 also lets the usual arrival check in Logic_MoveNext
+//							 finish the trip.
+////////////////////////////////////////////////////////////////////////////////
+
+bool CDoofus::AlignToFlowField(void)
+{
+	bool bAligned = false;
+
+	if (m_pRealm->m_bFlowFieldNav &&
+	    (m_eDestinationState == State_PanicContinue ||
+	     m_eDestinationState == State_WalkContinue ||
+	     m_eDestinationState == State_March))
+	{
+		CBouy* pDestBouy = m_pNavNet->GetBouy(m_ucDestBouyID);
+		if (pDestBouy != NULL)
+		{
+			CFlowField* pField = m_pRealm->GetFlowField(pDestBouy->GetX(), pDestBouy->GetZ());
+			double dRot;
+			if (pField != NULL && pField->GetDirection(m_dX, m_dZ, &dRot))
+			{
+				m_ucNextBouyID = m_ucDestBouyID;
+				m_pNextBouy = pDestBouy;
+				m_sNextX = pDestBouy->GetX();
+				m_sNextZ = pDestBouy->GetZ();
+				m_dAnimRot = m_dRot = dRot;
+				bAligned = true;
+			}
+		}
+	}
+
+	return bAligned;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // TryClearDirection - Given an angle, and a variance, checks the given angle
 //							  to see if it is clear.  If it is blocked by walls or fire
@@ -2242,7 +2284,7 @@ void CDoofus::Logic_PositionSet(void)
 		// else stay where you are.
 		{
 			m_dShootAngle = m_dAnimRot = m_dRot = FindDirection();
-			if (m_idDude != CIdBank::IdNil)
+			if (m_hDude != CIdBank::HandleNil)
 			{
 				m_state = State_DelayShoot;
 				m_lTimer = lThisTime + ms_lDelayShootTimeout;
@@ -3298,10 +3340,7 @@ bool CDoofus::AvoidFire(void)
 
 void CDoofus::YellForHelp(void)
 {
-	CSmash* pSmashed = NULL;
 	CSmash smashYell;
-	double dSmashedX;
-	double dSmashedZ;
 	GameMessage msg;
 	msg.msg_Help.eType = typeHelp;
 	msg.msg_Help.sPriority = 0;
@@ -3314,46 +3353,17 @@ void CDoofus::YellForHelp(void)
 	smashYell.m_bits = 0;
 	smashYell.m_pThing = this;
 
-	m_pRealm->m_smashatorium.QuickCheckReset(&smashYell,
-														  CSmash::Character | CSmash::Bad,
-														  0,
-														  CSmash::Good);
-	while (m_pRealm->m_smashatorium.QuickCheckNext(&pSmashed))
-	{
-		ASSERT(pSmashed->m_pThing);
-		if (pSmashed->m_pThing != this)
-		{
-			dSmashedX = pSmashed->m_sphere.sphere.X;
-			dSmashedZ = pSmashed->m_sphere.sphere.Z;
-			// Check IsPathClear to that thing
-			if (m_pRealm->IsPathClear(	// Returns true, if the entire path is clear.                 
-													// Returns false, if only a portion of the path is clear.     
-													// (see *psX, *psY, *psZ).                                    
-					(int16_t) m_dX, 				// In:  Starting X.                                           
-					(int16_t) m_dY, 				// In:  Starting Y.                                           
-					(int16_t) m_dZ, 				// In:  Starting Z.                                           
-					3.0, 							// In:  Rate at which to scan ('crawl') path in pixels per    
-													// iteration.                                                 
-													// NOTE: Values less than 1.0 are inefficient.                
-													// NOTE: We scan terrain using GetHeight()                    
-													// at only one pixel.                                         
-													// NOTE: We could change this to a speed in pixels per second 
-													// where we'd assume a certain frame rate.                    
-					(int16_t) dSmashedX,		// In:  Destination X.                                        
-					(int16_t) dSmashedZ,		// In:  Destination Z.                                        
-					0,								// In:  Max traverser can step up.                      
-					NULL,							// Out: If not NULL, last clear point on path.                
-					NULL,							// Out: If not NULL, last clear point on path.                
-					NULL,							// Out: If not NULL, last clear point on path.                
-					true) )						// In:  If true, will consider the edge of the realm a path
-													// inhibitor.  If false, reaching the edge of the realm    
-													// indicates a clear path. 
-			{                                
-				SendThingMessage(&msg, pSmashed->m_pThing);				
-			}
-		}
-	}
-
+	// Tell everyone within earshot that has a clear path to us.  Hearing one
+	// yell per update is as good as hearing several, so when a whole crowd
+	// yells at once, each listener only gets one.
+	m_pRealm->SendMessageInRadius(&msg,
+											&smashYell,
+											CSmash::Character | CSmash::Bad,
+											0,
+											CSmash::Good,
+											CIdBank::IdNil,
+											true,
+											true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3816,6 +3826,38 @@ CWeapon* CDoofus::ShootWeapon(CSmash::Bits bitsInclude,
 	return pWeapon;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// IsLogicUpdateDue - Ask the realm's AI scheduler whether to run logic now.
+//							 Only the idle states can be put off, and only when
+//							 there are no messages waiting and we're not on fire.
+////////////////////////////////////////////////////////////////////////////////
+
+bool CDoofus::IsLogicUpdateDue(void)
+{
+	bool bIdle = false;
+
+	switch (m_state)
+	{
+		case State_Guard:
+		case State_Patrol:
+		case State_Walk:
+		case State_WalkBegin:
+		case State_WalkContinue:
+		case State_WalkNext:
+			bIdle = true;
+			break;
+
+		default:
+			break;
+	}
+
+	// Shots, explosions and calls for help must be handled right away.
+	if (m_MessageQueue.IsEmpty() == FALSE || m_hFire != CIdBank::HandleNil)
+		bIdle = false;
+
+	return m_pRealm->IsAIUpdateDue(GetInstanceID(), bIdle, m_dX, m_dZ);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // RunIdleAnimation - Check the idle timer and pick an idle animation to run
 ////////////////////////////////////////////////////////////////////////////////
@@ -271,7 +271,7 @@ class CDoofus : public CCharacter
 	//---------------------------------------------------------------------------
 	protected:
 		// General position, motion and time variables
-		U16	m_idDude;						// The target CDude 
+		CIdBank::Handle	m_hDude;		// The target CDude 
 
 		// Animations
 		CAnim3D	m_animStand;				// Standing animation
@@ -670,6 +670,10 @@ class CDoofus : public CCharacter
 		// If Alignment timer is up, recalc the direction to the bouy.
 		void AlignToBouy(void);
 
+		// Steer by the realm's flow field toward the destination bouy, if
+		// flow fields are on, this state uses them and the field covers us.
+		bool AlignToFlowField(void);	// Returns true if aligned.
+
 		// Find the squared distance to the CDude (to avoid sqrt)
 		double SQDistanceToDude(void);
 
@@ -724,6 +728,11 @@ class CDoofus : public CCharacter
 		// Run an idle animation and switch them up every so often
 		void RunIdleAnimation(void);
 
+		// Ask the realm's AI scheduler whether to run logic this update.
+		// Idle states with nothing in the message queue may be deferred when
+		// no CDude is nearby.
+		bool IsLogicUpdateDue(void);	// Returns true to run logic now.
+
 		// Position our smash approriately.
 		virtual			// Override to implement additional functionality.
 							// Call base class to get default functionality
@@ -2290,7 +2290,7 @@ void CDude::Update(void)
 
 				CThing*	pthingFire;
 				// If the fire's gone . . .
-				if (m_pRealm->m_idbank.GetThingByID(&pthingFire, m_u16IdFire) == 0)
+				if (m_pRealm->m_idbank.GetThingByHandle(&pthingFire, m_hFire) == 0)
 					{
 					if (!((CFire*) (pthingFire))->IsBurning())
 					// Stand.
@@ -4098,7 +4098,7 @@ bool CDude::SetState(	// Returns true if new state realized, false otherwise.
 						{
 						// If there's a fire burning . . .
 						CThing*	pthingFire;
-						if (m_pRealm->m_idbank.GetThingByID(&pthingFire, m_u16IdFire) == 0)
+						if (m_pRealm->m_idbank.GetThingByHandle(&pthingFire, m_hFire) == 0)
 							{
 							// Send it a delete message.
 							GameMessage	msg;
@@ -5373,7 +5373,7 @@ void CDude::Revive(				// Returns nothing.
 		&&	(m_pRealm->m_flags.bMultiplayer == true || bWarpIn == false) )
 		{
 		// Drop that fire.
-		m_u16IdFire	= CIdBank::IdNil;
+		m_hFire	= CIdBank::HandleNil;
 
 		// Let's not be responding to old news.
 		m_MessageQueue.Empty();
@@ -401,7 +401,6 @@ int16_t CExplode::Setup(									// Returns 0 if successfull, non-zero otherwise
 	m_smash.m_pThing	= this;
 
 	// See who we blew up and send them a message
-	CSmash* pSmashed = NULL;
 	GameMessage msg;
 	msg.msg_Explosion.eType = typeExplosion;
 	msg.msg_Explosion.sPriority = 0;
@@ -411,20 +410,13 @@ int16_t CExplode::Setup(									// Returns 0 if successfull, non-zero otherwise
 	msg.msg_Explosion.sZ = (int16_t) m_dZ;
 	msg.msg_Explosion.sVelocity = ms_sProjectVelocity;
 	msg.msg_Explosion.u16ShooterID = m_u16ShooterID;
-	m_pRealm->m_smashatorium.QuickCheckReset(
+	m_pRealm->SendMessageInRadius(
+		&msg,
 		&m_smash, 
 		CSmash::Character | CSmash::Misc | CSmash::Barrel | CSmash::Mine | CSmash::AlmostDead | CSmash::Sentry,
 		CSmash::Good | CSmash::Bad | CSmash::Civilian,
-		0);
-	while (m_pRealm->m_smashatorium.QuickCheckNext(&pSmashed))
-		{
-		ASSERT(pSmashed->m_pThing);
-		// If not the excepted thing . . .
-		if (pSmashed->m_pThing->GetInstanceID() != m_u16ExceptID)
-			{
-			SendThingMessage(&msg, pSmashed->m_pThing);
-			}
-		}
+		0,
+		m_u16ExceptID);
 
 	return sResult;
 }
@@ -135,7 +135,7 @@ class CExplode : public CThing
 			CThing** ppNew)										// Out: Pointer to new object
 			{
 			int16_t sResult = 0;
-			*ppNew = new CExplode(pRealm);
+			*ppNew = new (pRealm, CExplodeID) CExplode(pRealm);
 			if (*ppNew == 0)
 				{
 				sResult = -1;
@@ -372,6 +372,61 @@ void CFire::Resume(void)
 // Update object
 ////////////////////////////////////////////////////////////////////////////////
 void CFire::Update(void)
+{
+	// If the realm's parallel phase already stepped us, that was this update's.
+	bool bStepped = m_bStepped;
+	m_bStepped = false;
+
+	if (!m_sSuspend)
+	{
+		// See if we killed ourselves
+		if (ProcessMessages() == State_Deleted)
+			return;
+
+		if (!bStepped)
+			Step(NULL);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Do this update's Step() ahead of Update() (may be on another thread)
+////////////////////////////////////////////////////////////////////////////////
+void CFire::UpdateParallel(
+	CDeferList*	pdefer)							// In:  Where to put side effects.
+{
+	// Dequeuing gives the messages back to the realm's pool, which isn't safe
+	// from here, so if we have any, Update() does the whole thing as usual.
+	if (!m_sSuspend && m_MessageQueue.IsEmpty() == TRUE)
+	{
+		m_bStepped = true;
+		Step(pdefer);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Do something Step() put off
+////////////////////////////////////////////////////////////////////////////////
+void CFire::DoDeferred(
+	int32_t	lCode)								// In:  DeferCode.
+{
+	switch (lCode)
+	{
+		case DeferBurn:
+			Burn();
+			break;
+
+		case DeferSmokeout:
+			if (Smokeout() != SUCCESS)
+				delete this;
+			break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Burn, smolder, drift and die.
+////////////////////////////////////////////////////////////////////////////////
+void CFire::Step(
+	CDeferList*	pdefer)							// In:  Where to put side effects or NULL.
 {
 	int32_t lThisTime;
 	double dSeconds;
@@ -379,133 +434,145 @@ void CFire::Update(void)
 	double dNewX;
 	double dNewZ;
 
-	if (!m_sSuspend)
+	if (m_lTimer < m_lBurnUntil)
 	{
-		// See if we killed ourselves
-		if (ProcessMessages() == State_Deleted)
-			return;
+		lThisTime = m_pRealm->m_time.GetGameTime();
+		m_lTimer += lThisTime - m_lPrevTime;
+		// See if its time to change to the next alpha channel
+		if (m_lTimer > m_lCurrentAlphaTimeout)
+		{
+			m_sCurrentAlphaLevel--;
+			// Range check.
+			if (m_sCurrentAlphaLevel < 0)
+				m_sCurrentAlphaLevel	= 0;
+			else if (m_sCurrentAlphaLevel > 255)
+				m_sCurrentAlphaLevel	= 255;
+
+			if (m_lTimer < m_lAlphaBreakPoint)
+				m_lCurrentAlphaTimeout += m_lBrightAlphaInterval;
+			else
+				m_lCurrentAlphaTimeout += m_lDimAlphaInterval;
+		}
 
-		if (m_lTimer < m_lBurnUntil)
+		if (lThisTime > m_lCollisionTimer)
 		{
-			lThisTime = m_pRealm->m_time.GetGameTime();
-			m_lTimer += lThisTime - m_lPrevTime;
-			// See if its time to change to the next alpha channel
-			if (m_lTimer > m_lCurrentAlphaTimeout)
+			// If the fire is not smoldering out, then it has the ability
+			// to set other things on fire and should check collisions
+			// to see which things it should tell to burn.
+			if (m_bSendMessages && m_sCurrentAlphaLevel > SMOLDER_ALPHA && m_eFireAnim != Smoke && m_eFireAnim != SmallSmoke)
 			{
-				m_sCurrentAlphaLevel--;
-				// Range check.
-				if (m_sCurrentAlphaLevel < 0)
-					m_sCurrentAlphaLevel	= 0;
-				else if (m_sCurrentAlphaLevel > 255)
-					m_sCurrentAlphaLevel	= 255;
-
-				if (m_lTimer < m_lAlphaBreakPoint)
-					m_lCurrentAlphaTimeout += m_lBrightAlphaInterval;
+				if (pdefer)
+					pdefer->AddCall(this, DeferBurn);
 				else
-					m_lCurrentAlphaTimeout += m_lDimAlphaInterval;
-			}
-
-			if (lThisTime > m_lCollisionTimer)
-			{
-				// If the fire is not smoldering out, then it has the ability
-				// to set other things on fire and should check collisions
-				// to see which things it should tell to burn.
-				if (m_bSendMessages && m_sCurrentAlphaLevel > SMOLDER_ALPHA && m_eFireAnim != Smoke && m_eFireAnim != SmallSmoke)
-				{
-					CSmash* pSmashed = NULL;
-					GameMessage msg;
-					msg.msg_Burn.eType = typeBurn;
-					msg.msg_Burn.sPriority = 0;
-					msg.msg_Burn.sDamage = 10;
-					msg.msg_Burn.u16ShooterID = m_u16ShooterID;
-					m_pRealm->m_smashatorium.QuickCheckReset(&m_smash, m_u32CollideIncludeBits,
-																		  m_u32CollideDontcareBits, 
-																		  m_u32CollideExcludeBits);
-					while (m_pRealm->m_smashatorium.QuickCheckNext(&pSmashed))
-						{
-						// Default to the standard case where credit is given to the
-						// shooter.
-						msg.msg_Burn.u16ShooterID	= m_u16ShooterID;
-
-						if ((m_bIsBurningDude) && (pSmashed->m_pThing->GetClassID() != CDudeID))
-							UnlockAchievement(ACHIEVEMENT_TOUCH_SOMEONE_WHILE_BURNING);
-
-						// If the fire starter ID is set . . .
-						if (m_u16FireStarterID != CIdBank::IdNil)
-							{
-							// If this is the shooter . . .
-							if (pSmashed->m_pThing->GetInstanceID() == m_u16ShooterID)
-								{
-								// The shooter is damaged by his own fire with credit
-								// given to the fire starter.
-								msg.msg_Burn.u16ShooterID	= m_u16FireStarterID;
-								}
-							}
-
-						// Burn.
-						SendThingMessage(&msg, pSmashed->m_pThing);				
-						}
-				}
-				// Reset collision timer for next time
-				m_lCollisionTimer = lThisTime + ms_lCollisionTime;
+					Burn();
 			}
+			// Reset collision timer for next time
+			m_lCollisionTimer = lThisTime + ms_lCollisionTime;
+		}
 
-			// If this is smoke, make it drift in the wind direction
-			if (m_eFireAnim == Smoke || m_eFireAnim == SmallSmoke)
+		// If this is smoke, make it drift in the wind direction
+		if (m_eFireAnim == Smoke || m_eFireAnim == SmallSmoke)
+		{
+			// Update position using wind direction and velocity
+			dSeconds = ((double) lThisTime - (double) m_lPrevTime) / 1000.0;
+			// Apply internal velocity.
+			dDistance	= ms_dWindVelocity * dSeconds;
+			dNewX	= m_dX + COSQ[(int16_t) m_sRot] * dDistance;
+			dNewZ	= m_dZ - SINQ[(int16_t) m_sRot] * dDistance;
+
+			// Check attribute map for walls, and if you hit a wall, 
+			// set the timer so you will die off next time around.
+			int16_t sHeight = m_pRealm->GetHeight((int16_t) dNewX, (int16_t) dNewZ);
+			// If it hits a wall taller than itself, then it will rotate in the
+			// predetermined direction until it is free to move.
+			if ((int16_t) m_dY < sHeight)
 			{
-				// Update position using wind direction and velocity
-				dSeconds = ((double) lThisTime - (double) m_lPrevTime) / 1000.0;
-				// Apply internal velocity.
-				dDistance	= ms_dWindVelocity * dSeconds;
-				dNewX	= m_dX + COSQ[(int16_t) m_sRot] * dDistance;
-				dNewZ	= m_dZ - SINQ[(int16_t) m_sRot] * dDistance;
-
-				// Check attribute map for walls, and if you hit a wall, 
-				// set the timer so you will die off next time around.
-				int16_t sHeight = m_pRealm->GetHeight((int16_t) dNewX, (int16_t) dNewZ);
-				// If it hits a wall taller than itself, then it will rotate in the
-				// predetermined direction until it is free to move.
-				if ((int16_t) m_dY < sHeight)
-				{
-					if (m_bTurnRight)
-						m_sRot = rspMod360(m_sRot - 20);
-					else
-						m_sRot = rspMod360(m_sRot + 20);
-				}
+				if (m_bTurnRight)
+					m_sRot = rspMod360(m_sRot - 20);
 				else
-				// else it is ok, so update its new position
-				{
-					m_dX = dNewX;
-					m_dZ = dNewZ;
-				}
+					m_sRot = rspMod360(m_sRot + 20);
 			}
 			else
+			// else it is ok, so update its new position
 			{
-				// Update our smashatorium location.
-				m_smash.m_sphere.sphere.X = m_dX;
-				m_smash.m_sphere.sphere.Y = m_dY;
-				m_smash.m_sphere.sphere.Z = m_dZ;
-				// Update the smash.
-				m_pRealm->m_smashatorium.Update(&m_smash);
+				m_dX = dNewX;
+				m_dZ = dNewZ;
 			}
+		}
+		else
+		{
+			// Update our smashatorium location.
+			m_smash.m_sphere.sphere.X = m_dX;
+			m_smash.m_sphere.sphere.Y = m_dY;
+			m_smash.m_sphere.sphere.Z = m_dZ;
+			// Update the smash.
+			if (pdefer)
+				pdefer->AddSmashUpdate(&m_smash);
+			else
+				m_pRealm->m_smashatorium.Update(&m_smash);
+		}
 
-			m_lPrevTime = lThisTime;
+		m_lPrevTime = lThisTime;
+	}
+	else
+	{
+		// If its done smoking, then delete it
+		if (m_eFireAnim == Smoke || m_eFireAnim == SmallSmoke)
+		{
+			if (pdefer)
+				pdefer->AddDelete(this);
+			else
+				delete this;
 		}
+		// Else change the fire to smoke
 		else
 		{
-			// If its done smoking, then delete it
-			if (m_eFireAnim == Smoke || m_eFireAnim == SmallSmoke)
-			{
+			if (pdefer)
+				pdefer->AddCall(this, DeferSmokeout);
+			else if (Smokeout() != SUCCESS)
 				delete this;
-			}
-			// Else change the fire to smoke
-			else
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tell everything we're touching to burn.
+////////////////////////////////////////////////////////////////////////////////
+void CFire::Burn(void)
+{
+	CSmash* pSmashed = NULL;
+	GameMessage msg;
+	msg.msg_Burn.eType = typeBurn;
+	msg.msg_Burn.sPriority = 0;
+	msg.msg_Burn.sDamage = 10;
+	msg.msg_Burn.u16ShooterID = m_u16ShooterID;
+	m_pRealm->m_smashatorium.QuickCheckReset(&m_smash, m_u32CollideIncludeBits,
+														  m_u32CollideDontcareBits, 
+														  m_u32CollideExcludeBits);
+	while (m_pRealm->m_smashatorium.QuickCheckNext(&pSmashed))
+		{
+		// Default to the standard case where credit is given to the
+		// shooter.
+		msg.msg_Burn.u16ShooterID	= m_u16ShooterID;
+
+		if ((m_bIsBurningDude) && (pSmashed->m_pThing->GetClassID() != CDudeID))
+			UnlockAchievement(ACHIEVEMENT_TOUCH_SOMEONE_WHILE_BURNING);
+
+		// If the fire starter ID is set . . .
+		if (m_u16FireStarterID != CIdBank::IdNil)
 			{
-				if (Smokeout() != SUCCESS)
-					delete this;
+			// If this is the shooter . . .
+			if (pSmashed->m_pThing->GetInstanceID() == m_u16ShooterID)
+				{
+				// The shooter is damaged by his own fire with credit
+				// given to the fire starter.
+				msg.msg_Burn.u16ShooterID	= m_u16FireStarterID;
+				}
 			}
+
+		// Burn.
+		SendThingMessage(&msg, pSmashed->m_pThing);				
 		}
-	}
 }
 
 
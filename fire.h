@@ -107,6 +107,13 @@ class CFire : public CThing
 
 	typedef RChannel<CAlphaAnim> ChannelAA;
 
+	// Things Step() puts off when it's called from UpdateParallel().
+	typedef enum
+	{
+		DeferBurn,							// Tell everything we're touching to burn.
+		DeferSmokeout						// Change to smoke (or go away).
+	} DeferCode;
+
 	//---------------------------------------------------------------------------
 	// Variables
 	//---------------------------------------------------------------------------
@@ -157,6 +164,9 @@ class CFire : public CThing
 
 		CSmash		m_smash;					// Collision class
 
+		bool		m_bStepped;					// true, if UpdateParallel() already did
+													// this update's Step().
+
 		// Tracks file counter so we know when to load/save "common" data 
 		static int16_t ms_sFileCount;
 		static int16_t ms_sLargeRadius;
@@ -189,6 +199,7 @@ class CFire : public CThing
 			m_smash.m_bits = 0;
 			m_lStartTime = 0;
 			m_u16FireStarterID = CIdBank::IdNil;
+			m_bStepped = false;
 			}
 
 	public:
@@ -217,7 +228,7 @@ class CFire : public CThing
 			CThing** ppNew)										// Out: Pointer to new object
 			{
 			int16_t sResult = 0;
-			*ppNew = new CFire(pRealm);
+			*ppNew = new (pRealm, CFireID) CFire(pRealm);
 			if (*ppNew == 0)
 				{
 				sResult = -1;
@@ -266,6 +277,14 @@ class CFire : public CThing
 		// Update object
 		void Update(void);
 
+		// Do this update's Step() ahead of Update() (may be on another thread)
+		void UpdateParallel(
+			CDeferList*	pdefer);						// In:  Where to put side effects.
+
+		// Do something Step() put off
+		void DoDeferred(
+			int32_t	lCode);							// In:  DeferCode.
+
 		// Render object
 		void Render(void);
 
@@ -346,6 +365,14 @@ class CFire : public CThing
 		// Process Game Messages
 		CFire::CFireState ProcessMessages(void);
 
+		// Burn, smolder, drift and die.  With pdefer, anything that isn't
+		// just our own state goes in pdefer instead of happening now.
+		void Step(
+			CDeferList*	pdefer);						// In:  Where to put side effects or NULL.
+
+		// Tell everything we're touching to burn.
+		void Burn(void);
+
 		// Initialize the fire for large or small objects
 		int16_t Init(void);
 
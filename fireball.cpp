@@ -805,18 +805,15 @@ void CFireball::Update(void)
 							m_smash.m_sphere.sphere.Z = m_dZ;
 
 							// Check for collisions
-							CSmash* pSmashed = NULL;
 							GameMessage msg;
 							msg.msg_Burn.eType = typeBurn;
 							msg.msg_Burn.sPriority = 0;
 							msg.msg_Burn.sDamage = 10;
 							msg.msg_Burn.u16ShooterID = m_u16ShooterID;
-							m_pRealm->m_smashatorium.QuickCheckReset(&m_smash, m_u32CollideIncludeBits,
-																				  m_u32CollideDontcareBits, 
-																				  m_u32CollideExcludeBits);
-							while (m_pRealm->m_smashatorium.QuickCheckNext(&pSmashed))
-								if (pSmashed->m_pThing->GetInstanceID() != m_u16ShooterID)
-									SendThingMessage(&msg, pSmashed->m_pThing);				
+							m_pRealm->SendMessageInRadius(&msg, &m_smash, m_u32CollideIncludeBits,
+																	m_u32CollideDontcareBits, 
+																	m_u32CollideExcludeBits,
+																	m_u16ShooterID);
 						}
 					}
 
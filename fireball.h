@@ -179,7 +179,7 @@ class CFireball : public CWeapon
 			CThing** ppNew)										// Out: Pointer to new object
 			{
 			int16_t sResult = 0;
-			*ppNew = new CFireball(pRealm);
+			*ppNew = new (pRealm, CFireballID) CFireball(pRealm);
 			if (*ppNew == 0)
 				{
 				sResult = -1;
@@ -251,7 +251,7 @@ class CFireball : public CWeapon
 				sX, sY, sZ, 
 				0,
 				500, 
-				m_idParent
+				CIdBank::GetIdFromHandle(m_hParent)
 				);
 			}
 
@@ -491,7 +491,7 @@ class CFirestream : public CWeapon
 				sX, sY, sZ, 
 				0,
 				500, 
-				m_idParent
+				CIdBank::GetIdFromHandle(m_hParent)
 				);
 			}
 
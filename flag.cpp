@@ -396,6 +396,7 @@ void CFlag::Update(void)
 					{
 						((CDude*) pSmashed->m_pThing)->m_sprite.AddChild(&m_sprite);
 						m_u16IdParent = pSmashed->m_pThing->GetInstanceID();
+						m_hCarrier = m_pRealm->m_idbank.GetHandle(m_u16IdParent);
 						m_pRealm->m_scene.RemoveSprite(&m_sprite);
 						m_state = State_Patrol;
 						//m_u32IncludeBits = CSmash::Flagbase;
@@ -442,7 +443,7 @@ void CFlag::Update(void)
 								msg.msg_PutMeDown.sPriority = 0;
 								msg.msg_PutMeDown.u16FlagInstanceID = GetInstanceID();
 
-								if (m_pRealm->m_idbank.GetThingByID((CThing**)&pParent, m_u16IdParent) == 0)
+								if (m_u16IdParent != CIdBank::IdNil && m_pRealm->m_idbank.GetThingByHandle((CThing**)&pParent, m_hCarrier) == 0)
 								{
 									SendThingMessage(&msg, pParent);
 								}
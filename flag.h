@@ -69,6 +69,8 @@ class CFlag : public CThing3d
 		int16_t			m_sSavedX;							// Save the position of the flagbase
 		int16_t			m_sSavedY;							// Save the position of the flagbase
 		int16_t			m_sSavedZ;							// Save the position of the flagbase
+		CIdBank::Handle	m_hCarrier;					// Dude carrying us, while
+																// m_u16IdParent is set.
 
 		// Tracks file counter so we know when to load/save "common" data 
 		static int16_t ms_sFileCount;
@@ -95,6 +97,7 @@ class CFlag : public CThing3d
 			m_sSavedX = 0;
 			m_sSavedY = 0;
 			m_sSavedZ = 0;
+			m_hCarrier = CIdBank::HandleNil;
 			}
 
 	public:
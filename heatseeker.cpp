@@ -631,7 +631,7 @@ void CHeatseeker::Render(void)
 		m_sprite.m_sInFlags = 0;
 
 	// If we're not a child of someone else...
-	if (m_idParent == CIdBank::IdNil)
+	if (m_hParent == CIdBank::HandleNil)
 	{
 		// Map from 3d to 2d coords
 		Map3Dto2D((int16_t) m_dX, (int16_t) m_dY, (int16_t) m_dZ, &m_sprite.m_sX2, &m_sprite.m_sY2);
@@ -681,7 +681,7 @@ void CHeatseeker::Render(void)
 	}
 	else
 	{
-		// m_idParent is setting our transform relative to its position
+		// m_hParent is setting our transform relative to its position
 		// and we are drawn by the scene with the parent.
 	}
 }
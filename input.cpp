@@ -245,6 +245,11 @@
 
 #define MAX_CONSEQ_CHEAT_KEY_LAG	2000	// In ms.
 
+// Inputs that only show up in the one GetLocalInput() they happened in, so
+// they must be held until a fixed step takes them.  Fire is held, too, so a
+// tap between steps isn't missed.
+#define INPUT_ONE_SHOT_MASK	(INPUT_REVIVE | INPUT_SUICIDE | INPUT_FIRE | INPUT_WEAPONS_MASK | INPUT_WEAPON_NEXT | INPUT_WEAPON_PREV | INPUT_EXECUTE)
+
 // Tweak characters of a string so they are tough to find in the exe.
 // Use CHAR_UNTWEAK() to get a specific char back.
 #define STR_TWEAK(c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14, c15, c16, c17, c18, c19)	\
@@ -295,6 +300,12 @@ UINPUT m_aInputs[INPUT_MAX_DUDES];
 // Last input for the local dude.
 UINPUT	ms_inputLastLocal	= 0;
 
+// Fixed step input.  See LatchLocalInput().
+static UINPUT	ms_inputStepHeld		= INPUT_IDLE;	// Latest input, less relative rotation
+																// and one-shot inputs.
+static UINPUT	ms_inputStepLatched	= 0;				// One-shot inputs no step has taken.
+static int16_t	ms_sStepRot				= 0;				// Relative rotation no step has taken.
+
 // Global input settings
 CInputSettings	g_InputSettings;
 
@@ -570,6 +581,11 @@ extern void ClearLocalInput(void)
 	// Reset last local input to nothing.
 	ms_inputLastLocal	= INPUT_IDLE;
 
+	// Nothing waiting for a step.
+	ms_inputStepHeld		= INPUT_IDLE;
+	ms_inputStepLatched	= 0;
+	ms_sStepRot				= 0;
+
 	// If mouse use is specified (be nice about background state) . . .
 	if (g_InputSettings.m_sUseMouse != FALSE && rspIsBackground() == FALSE)
 		{
@@ -1329,6 +1345,63 @@ extern UINPUT GetLocalInput(				// Returns local input.
 	}
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// Hold local input for fixed steps.
+//
+////////////////////////////////////////////////////////////////////////////////
+extern void LatchLocalInput(
+	UINPUT input)								// In:  Input from GetLocalInput().
+	{
+	// One-shots wait for a step.  The weapon is a number, not bits, so the
+	// latest one wins.
+	if (input & INPUT_WEAPONS_MASK)
+		ms_inputStepLatched	&= ~(UINPUT)INPUT_WEAPONS_MASK;
+	ms_inputStepLatched	|= input & INPUT_ONE_SHOT_MASK;
+
+	if (input & INPUT_ROT_IS_ABS)
+		{
+		// Absolute rotation is good until the next one.
+		ms_inputStepHeld	= input & ~(UINPUT)(INPUT_ONE_SHOT_MASK & ~INPUT_FIRE);
+		ms_sStepRot			= 0;
+		}
+	else
+		{
+		// Relative rotation adds up until the steps take it.  More than a
+		// full turn either way gets us nowhere new.
+		ms_inputStepHeld	= input & ~(UINPUT)((INPUT_ONE_SHOT_MASK & ~INPUT_FIRE) | INPUT_ROT_MASK);
+		ms_sStepRot			+= (int16_t)(input & INPUT_ROT_MASK) - 360;
+		if (ms_sStepRot > 360)
+			ms_sStepRot	= 360;
+		else if (ms_sStepRot < -360)
+			ms_sStepRot	= -360;
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Get local input for the next fixed step.
+//
+////////////////////////////////////////////////////////////////////////////////
+extern UINPUT TakeLocalStepInput(		// Returns input for this step.
+	int16_t sStepsLeft)						// In:  Steps left this frame, counting this one.
+	{
+	UINPUT	input	= ms_inputStepHeld | ms_inputStepLatched;
+	ms_inputStepLatched	= 0;
+
+	if ((input & INPUT_ROT_IS_ABS) == 0)
+		{
+		// This step's even share of the rotation.
+		int16_t	sRot	= ms_sStepRot / MAX(sStepsLeft, (int16_t)1);
+		ms_sStepRot		-= sRot;
+		input				|= (U32)(360 + sRot);
+		}
+
+	return input;
+	}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
 ////////////////////////////////////////////////////////////////////////////////
@@ -337,6 +337,23 @@ extern UINPUT GetLocalInput(				// Returns local input structure.
 													// harder to hack.
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// Fixed step local input.  When the simulation takes zero or more fixed steps
+// per frame instead of one update per GetLocalInput(), pass each frame's
+// GetLocalInput() to LatchLocalInput() and get each step's input from
+// TakeLocalStepInput().  One-shot inputs (weapon switches, fire taps, etc.)
+// are held until a step takes them, and relative rotation adds up across
+// frames and is split evenly across the steps that take it.
+//
+////////////////////////////////////////////////////////////////////////////////
+extern void LatchLocalInput(
+	UINPUT input);								// In:  Input from GetLocalInput().
+
+extern UINPUT TakeLocalStepInput(		// Returns input for this step.
+	int16_t sStepsLeft);						// In:  Steps left this frame, counting this one.
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Get input for specified dude
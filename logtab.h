@@ -470,6 +470,32 @@ class CLogTab
 			int16_t sEntry;
 			} Cell;
 
+		// A compiled input cell.  Every operand is reduced to a single unsigned
+		// range check (value - lLow <= ulSpan), optionally inverted for "not".
+		typedef struct
+			{
+			int16_t sVar;											// Index of input var
+			int16_t sInvert;										// 1 to invert result, 0 otherwise
+			int32_t lLow;											// Lowest value that passes
+			uint32_t ulSpan;										// Highest passing value minus lowest
+			} Test;
+
+		// A compiled output cell
+		typedef struct
+			{
+			int16_t sVar;											// Index of output var
+			int16_t sEntry;										// Value to set
+			} Output;
+
+		// A compiled row, which refers to a run of tests and a run of outputs
+		typedef struct
+			{
+			int16_t sFirstTest;									// Index of first test
+			int16_t sNumTests;										// Number of tests
+			int16_t sFirstOutput;									// Index of first output
+			int16_t sNumOutputs;									// Number of outputs
+			} Row;
+
 	//------------------------------------------------------------------------------
 	// Variables
 	//------------------------------------------------------------------------------
@@ -483,6 +509,12 @@ class CLogTab
 
 		Cell m_cellTable[MaxRows][MaxVars];					// Table of input and output cells
 
+		// Compiled form of m_cellTable, built by Compile() after loading.  Don't
+		// care cells are dropped so Evaluate() only visits cells that matter.
+		Row m_arowCompiled[MaxRows];							// Compiled rows
+		Test m_atestCompiled[MaxRows * MaxVars];			// Compiled input cells
+		Output m_aoutCompiled[MaxRows * MaxVars];			// Compiled output cells
+
 		bool m_bLogFileError;
 		FILE* m_fpLog;
 		int16_t m_sLogLastRow;
@@ -543,6 +575,11 @@ class CLogTab
 			RFile* pFile);											// In:  RFile to save to
 
 	private:
+		////////////////////////////////////////////////////////////////////////////////
+		// Build the compiled form of the table from m_cellTable
+		////////////////////////////////////////////////////////////////////////////////
+		void Compile(void);
+
 		////////////////////////////////////////////////////////////////////////////////
 		// Free vars associated with this table
 		////////////////////////////////////////////////////////////////////////////////
@@ -596,85 +633,40 @@ int16_t CLogTab<usertype>::Evaluate(
 	for (int16_t s = 0; s < m_sInVars; s++)
 		sVals[s] = -1;
 
-	// Scan table looking for a row that matches all the way across
+	// Scan compiled table looking for a row that matches all the way across.
+	// Vars are still only asked for their values when a row first needs them,
+	// and in the same order as the table's columns, since some vars (such as
+	// ones that select a target) have side effects.
 	char acBuf[256];
 	bool bRowMatched = false;
 	for (int16_t sRow = 0; sRow < m_sRows; sRow++)
 		{
-		// Optimistically default to matching cell (it's faster)
-		bool bCellMatched = true;
-		int16_t sVar;
-		for (sVar = 0; bCellMatched && (sVar < m_sInVars); sVar++)
+		const Row* prow = &m_arowCompiled[sRow];
+		const Test* ptest = &m_atestCompiled[prow->sFirstTest];
+		const Test* ptestEnd = ptest + prow->sNumTests;
+		for ( ; ptest < ptestEnd; ptest++)
 			{
-			// Get the entry from the table
-			int16_t sEntry = m_cellTable[sRow][sVar].sEntry;
-
-			// Evaluate entry as per operand type
-			switch(m_cellTable[sRow][sVar].operand)
-				{
-				case Equal:
-					// If value isn't cached, then ask var for it now
-					if (sVals[sVar] == -1)
-						sVals[sVar] = m_apVars[sVar]->GetVal(user);
-
-					// If value doesn't match entry, it fails
-					if (sVals[sVar] != sEntry)
-						bCellMatched = false;
-					break;
-
-				case Not:
-					// If value isn't cached, then ask var for it now
-					if (sVals[sVar] == -1)
-						sVals[sVar] = m_apVars[sVar]->GetVal(user);
-
-					// If value doesn't match entry, it fails
-					if (sVals[sVar] == sEntry)
-						bCellMatched = false;
-					break;
-
-				case Less:
-					// If value isn't cached, then ask var for it now
-					if (sVals[sVar] == -1)
-						sVals[sVar] = m_apVars[sVar]->GetVal(user);
-
-					// If value is not less than entry, it fails
-					if (sVals[sVar] >= sEntry)
-						bCellMatched = false;
-					break;
-
-				case Greater:
-					// If value isn't cached, then ask var for it now
-					if (sVals[sVar] == -1)
-						sVals[sVar] = m_apVars[sVar]->GetVal(user);
-
-					// If value is not greater than entry, it fails
-					if (sVals[sVar] <= sEntry)
-						bCellMatched = false;
-					break;
-
-				case DontCare:
-					// Don't need to do anything
-					break;
-
-				default:
-					TRACE("CLogTab::Evaluate(): Unknown operand!\n");
-					break;
-				}
+			// If value isn't cached, then ask var for it now
+			int16_t sVar = ptest->sVar;
+			if (sVals[sVar] == -1)
+				sVals[sVar] = m_apVars[sVar]->GetVal(user);
+
+			// If value is outside the passing range (or inside it, for "not"), it fails
+			int16_t sPass = ((uint32_t)((int32_t)sVals[sVar] - ptest->lLow) <= ptest->ulSpan) ? 1 : 0;
+			if (sPass == ptest->sInvert)
+				break;
 			}
 
-		// If we reached the last input var, then this is row is a complete match!
-		if (sVar == m_sInVars && bCellMatched)
+		// If we got through all the tests, then this row is a complete match!
+		if (ptest == ptestEnd)
 			{
 			// Set flag
 			bRowMatched = true;
 
 			// Set output vars as indicated by table entries
-			for (int16_t sVar = 0; sVar < m_sOutVars; sVar++)
-				{
-				// If operand is NOT don't care, then set var to specified entry
-				if (m_cellTable[sRow][m_sInVars + sVar].operand != DontCare)
-					m_apVars[m_sInVars + sVar]->SetVal(user, m_cellTable[sRow][m_sInVars + sVar].sEntry);
-				}
+			const Output* pout = &m_aoutCompiled[prow->sFirstOutput];
+			for (int16_t s = 0; s < prow->sNumOutputs; s++, pout++)
+				m_apVars[pout->sVar]->SetVal(user, pout->sEntry);
 
 			// If we're logging and this isn't the same row as we logged last time...
 			if (bLog && (sRow != m_sLogLastRow))
@@ -751,6 +743,89 @@ int16_t CLogTab<usertype>::Evaluate(
 	}
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Build the compiled form of the table from m_cellTable.  Each row becomes a
+// packed run of tests (don't care inputs are skipped entirely) followed by a
+// packed run of outputs (don't care outputs are skipped as well).
+////////////////////////////////////////////////////////////////////////////////
+template <class usertype>
+void CLogTab<usertype>::Compile(void)
+	{
+	int16_t sNumTests = 0;
+	int16_t sNumOutputs = 0;
+	for (int16_t sRow = 0; sRow < m_sRows; sRow++)
+		{
+		Row* prow = &m_arowCompiled[sRow];
+		prow->sFirstTest = sNumTests;
+		prow->sFirstOutput = sNumOutputs;
+
+		int16_t sVar;
+		for (sVar = 0; sVar < m_sInVars; sVar++)
+			{
+			int32_t lEntry = m_cellTable[sRow][sVar].sEntry;
+			int32_t lLow;
+			int32_t lHigh;
+			int16_t sInvert = 0;
+			switch(m_cellTable[sRow][sVar].operand)
+				{
+				case Equal:
+					lLow = lEntry;
+					lHigh = lEntry;
+					break;
+
+				case Not:
+					lLow = lEntry;
+					lHigh = lEntry;
+					sInvert = 1;
+					break;
+
+				case Less:
+					lLow = INT16_MIN;
+					lHigh = lEntry - 1;
+					break;
+
+				case Greater:
+					lLow = lEntry + 1;
+					lHigh = INT16_MAX;
+					break;
+
+				case DontCare:
+					continue;
+
+				default:
+					TRACE("CLogTab::Compile(): Unknown operand!\n");
+					continue;
+				}
+
+			Test* ptest = &m_atestCompiled[sNumTests++];
+			ptest->sVar = sVar;
+			ptest->sInvert = sInvert;
+			// An empty range (such as "> 32767") can never pass, so point it at a
+			// value no var can return.
+			if (lHigh < lLow)
+				{
+				lLow = (int32_t)INT16_MAX + 1;
+				lHigh = lLow;
+				}
+			ptest->lLow = lLow;
+			ptest->ulSpan = (uint32_t)(lHigh - lLow);
+			}
+		prow->sNumTests = sNumTests - prow->sFirstTest;
+
+		for (sVar = m_sInVars; sVar < m_sTotalVars; sVar++)
+			{
+			if (m_cellTable[sRow][sVar].operand != DontCare)
+				{
+				Output* pout = &m_aoutCompiled[sNumOutputs++];
+				pout->sVar = sVar;
+				pout->sEntry = m_cellTable[sRow][sVar].sEntry;
+				}
+			}
+		prow->sNumOutputs = sNumOutputs - prow->sFirstOutput;
+		}
+	}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Dump contents of logic table to file.
 ////////////////////////////////////////////////////////////////////////////////
@@ -1061,6 +1136,10 @@ int16_t CLogTab<usertype>::Load(						// Returns 0 if successfull, non-zero othe
 				TRACE("CLogTab::Load(): Table has no rows following initial column headings!\n");
 				rspMsgBox(LOGTAB_MSG, "Table has no rows following initial column headings.\n");
 				}
+
+			// Build the compiled form used by Evaluate()
+			if (sResult == 0)
+				Compile();
 			}
 		}
 
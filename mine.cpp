@@ -468,7 +468,7 @@ void CMine::Update(void)
 
 					// If we have a parent . . .
 					CThing*	pthing	= NULL;	// Initialized for safety.
-					if (m_pRealm->m_idbank.GetThingByID(&pthing, m_idParent) == 0)
+					if (m_pRealm->m_idbank.GetThingByHandle(&pthing, m_hParent) == 0)
 						{
 						// Add in its position.
 						sX	+= pthing->GetX();
@@ -501,7 +501,7 @@ void CNapalm::Render(void)
 	}
 
 	// If we're not a child of someone else...
-	if (m_idParent == CIdBank::IdNil)
+	if (m_hParent == CIdBank::HandleNil)
 	{
 		// Map from 3d to 2d coords
 		Map3Dto2D((int16_t) m_dX, (int16_t) m_dY, (int16_t) m_dZ, &m_sprite.m_sX2, &m_sprite.m_sY2);
@@ -523,7 +523,7 @@ void CNapalm::Render(void)
 	}
 	else
 	{
-		// m_idParent is setting our transform relative to its position
+		// m_hParent is setting our transform relative to its position
 		// and we are drawn by the scene with the parent.
 	}
 }
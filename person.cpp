@@ -595,6 +595,12 @@ void CPerson::Update(void)
 
 	if (!m_sSuspend)
 	{
+		// If the AI scheduler says this isn't our turn, do nothing.  The time
+		// that elapses will be made up for on our next turn since m_lPrevTime
+		// isn't touched.
+		if (IsLogicUpdateDue() == false)
+			return;
+
 		int32_t lThisTime = m_pRealm->m_time.GetGameTime();
 
 		// See if its time to reevaluate the states
@@ -1894,7 +1900,7 @@ SampleMaster::SoundInstance CPerson::PlaySoundShooting(void)
 	m_siPlaying = 0;
 	SampleMasterID*	psmid	= &g_smidNil;
 
-	if (++m_usCommentCounter % 10 == 0 && m_idDude != CIdBank::IdNil)
+	if (++m_usCommentCounter % 10 == 0 && m_hDude != CIdBank::HandleNil)
 	{
 		switch (GetRandom() % 4)
 		{
@@ -1976,17 +1982,17 @@ SampleMaster::SoundInstance CPerson::PlaySoundRandom(void)
 		n = 10;
 	else
 		n = 20;
-	if (++m_usCommentCounter % n == 0 && m_idDude != CIdBank::IdNil)
+	if (++m_usCommentCounter % n == 0 && m_hDude != CIdBank::HandleNil)
 //#else
 	//if (++m_usCommentCounter % 10 == 0 && m_idDude != CIdBank::IdNil)
 //#endif
 	{
 		// Make sure the dude you are tracking is not dead before making any
 		// stupid comments about him, like "where did he go?", "Get that guy"
-		if (m_idDude != CIdBank::IdNil)
+		if (m_hDude != CIdBank::HandleNil)
 		{
 			CDude* pdude;
-			if (m_pRealm->m_idbank.GetThingByID((CThing**) &pdude, m_idDude) == 0)
+			if (m_pRealm->m_idbank.GetThingByHandle((CThing**) &pdude, m_hDude) == 0)
 			{
 				if (pdude && pdude->m_state != State_Dead)
 				{
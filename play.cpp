@@ -339,6 +339,8 @@
 #include "game.h"
 #include "update.h"
 #include "realm.h"
+#include "RealmSnapshot.h"
+#include "RealmTelemetry.h"
 #include "camera.h"
 #include "grip.h"
 #include "thing.h"
@@ -389,6 +391,10 @@
 #define DEMO_MAX_LAG							(DEMO_TIME_PER_FRAME / 2)
 #define DEMO_MAX_DEAD_TIME					5000
 
+// Most fixed steps the simulation takes in one frame to catch up with real
+// time.  Any more than that and the time is dropped.
+#define FIXED_STEP_MAX_STEPS				4
+
 #define DEMO_MULTIALPHA_FILE				"2d/school.mlp"
 
 #define DISP_INFO_INTERVAL					1000	// NEVER EVER MAKE THIS LESS THAN 1!!!!
@@ -781,6 +787,10 @@ class CPlayInfo
 		bool IsMP(void)
 			{ return (m_pclient) ? true : false; }
 
+		// Whether the simulation takes fixed steps (see CPlayRealm::CoreLoopRender()).
+		bool IsFixedStep(void)
+			{ return (GetInputMode() == INPUT_MODE_LIVE) && !IsMP() && (g_GameSettings.m_sFixedStepTime > 0); }
+
 		bool IsServer(void)
 			{ return (m_pserver) ? true : false; }
 
@@ -2577,9 +2587,13 @@ class CPlayStatus : public CPlay
 								{
 								m_print.print(
 									m_rectInfo.sX, m_rectInfo.sY,
-									"FPS: %ld Video H/W Update: %ld%% %s", 
+									"FPS: %ld Video H/W Update: %ld%% AI: %hd/%hd 3D: %ld/%ld %s", 
 									m_lFramePerSecond,
 									(pinfo->m_lSumUpdateDisplayTimes * 100) / m_lSumFrameTimes,
+									pinfo->Realm()->m_sAIUpdatedLast,
+									pinfo->Realm()->m_sAIUpdatedLast + pinfo->Realm()->m_sAIDeferredLast,
+									(long)pinfo->Realm()->m_scene.m_lPixelsWritten,
+									(long)pinfo->Realm()->m_scene.m_lPixelsTested,
 									m_szFileDescriptor);
 
 								// Reset.
@@ -3132,7 +3146,14 @@ class CPlayInput : public CPlay
 					if (!pinfo->IsMP())
 						{
 						// Set controls for the one-and-only dude now (allow cheats).
-						SetInput(0, GetLocalInput(prealm, pinfo->Camera(), pinfo->m_idLocalDude, pie));
+						UINPUT	input	= GetLocalInput(prealm, pinfo->Camera(), pinfo->m_idLocalDude, pie);
+
+						// If taking fixed steps, there may be no step this frame or several,
+						// so each step gets its input when it's taken.
+						if (pinfo->IsFixedStep())
+							LatchLocalInput(input);
+						else
+							SetInput(0, input);
 						}
 
 					//==============================================================================
@@ -3667,6 +3688,9 @@ class CPlayRealm : public CPlay
 		double			m_dCurrentFilmScale;
 		int16_t				m_sCurrentGripZoneRadius;
 		int32_t				m_lNumSeqSkippedFrames;
+		CRealmSnapshot	m_snapRealm;						// Realm as it was just after loading.
+		bool				m_bRestoreRealm;					// true to restart from m_snapRealm.
+		CRealmTelemetry	m_telemetry;						// Per frame trace of the realm (if enabled).
 
 
 	//------------------------------------------------------------------------------
@@ -3678,6 +3702,7 @@ class CPlayRealm : public CPlay
 		////////////////////////////////////////////////////////////////////////////////
 		CPlayRealm(void)
 			{
+			m_bRestoreRealm	= false;
 			}
 
 
@@ -3700,6 +3725,31 @@ class CPlayRealm : public CPlay
 			// Note whether multiplayer.
 			pinfo->Realm()->m_flags.bMultiplayer = pinfo->IsMP();
 
+			// Peers don't exchange these settings, so only use the AI scheduler,
+			// flow fields and batched updates when there's no one to get out of
+			// sync with.
+			pinfo->Realm()->m_sAIUpdateBuckets = pinfo->IsMP() ? 1 : g_GameSettings.m_sAIUpdateBuckets;
+			pinfo->Realm()->m_bFlowFieldNav = pinfo->IsMP() ? false : (g_GameSettings.m_sFlowFieldNav != FALSE);
+			pinfo->Realm()->m_bBatchUpdate = pinfo->IsMP() ? false : (g_GameSettings.m_sBatchUpdate != FALSE);
+
+			// Coalescing broadcasts changes how many messages get delivered, so
+			// demos only play back right without it (and recorded ones were
+			// recorded without it), and peers must all agree on it.
+			pinfo->Realm()->m_bCoalesceMsgs = !pinfo->IsMP() && (GetInputMode() == INPUT_MODE_LIVE);
+
+			// The parallel update phase comes out the same no matter how many
+			// threads run it, but fires and chunks act ahead of their usual turn
+			// while it runs, so demos and peers only stay in sync without it.
+			pinfo->Realm()->SetUpdateThreads((!pinfo->IsMP() && (GetInputMode() == INPUT_MODE_LIVE)) ? g_GameSettings.m_sUpdateThreads : 0);
+
+			// The render cache only affects drawing, so it's fine anywhere, too.
+			pinfo->Realm()->m_scene.m_rendercache.SetBudget((int32_t)g_GameSettings.m_sRenderCacheKB * 1024);
+			pinfo->Realm()->m_scene.m_bImpostors = (g_GameSettings.m_sImpostors != FALSE) && (g_GameSettings.m_sRenderCacheKB > 0);
+
+			// Trace the realm every frame if asked to.
+			if (g_GameSettings.m_szTelemetryFile[0] != '\0')
+				m_telemetry.Open(g_GameSettings.m_szTelemetryFile);
+
 			// Array of LevelPersist to carry players' ammo, health, kevlar, current
 			// weapon, etc. from level to level.  Using CDudes in this manner was 
 			// another idea, but when I tried carrying them from level to level, many, 
@@ -3750,6 +3800,10 @@ class CPlayRealm : public CPlay
 				g_resmgrRes.Purge();
 				g_resmgrShell.Purge();
 
+				// Restarting from the snapshot would skip the preloads that
+				// would have put things back in the caches.
+				m_snapRealm.Reset();
+
 				// Clear the flag.
 				pinfo->ClearPurgeSaks();
 				}
@@ -3757,14 +3811,35 @@ class CPlayRealm : public CPlay
 			// Reset time here so that objects can use it when they are loaded
 			prealm->m_time.Reset();
 
+			// If we're restarting the same realm, the snapshot taken when it was
+			// loaded gets it back without going to the disk.
+			bool	bRestore	= m_bRestoreRealm && m_snapRealm.IsValid();
+			m_bRestoreRealm	= false;
+
 			// If there's already a realm error, then don't bother with this
 			if (!pinfo->m_bBadRealmMP)
 				{
 				// Check if specified file exists
-				if (prealm->DoesFileExist((char*)pinfo->RealmName()))
+				if (bRestore || prealm->DoesFileExist((char*)pinfo->RealmName()))
 					{
-					// Load realm (false indicates NOT edit mode)
-					if (prealm->Load((char*)pinfo->RealmName(), false) == 0)
+					int16_t	sLoadResult;
+					if (bRestore)
+						{
+						sLoadResult	= m_snapRealm.Restore(prealm);
+						}
+					else
+						{
+						// Load realm (false indicates NOT edit mode)
+						sLoadResult	= prealm->Load((char*)pinfo->RealmName(), false);
+
+						// Only single player games restart, so only they need
+						// the snapshot.  If it can't be taken, restarting just
+						// loads the realm again.
+						if (sLoadResult == 0 && !pinfo->IsMP())
+							m_snapRealm.Take(prealm);
+						}
+
+					if (sLoadResult == 0)
 						{
 						// Startup the realm
 						if (prealm->Startup() == 0)
@@ -3911,6 +3986,13 @@ class CPlayRealm : public CPlay
 					// Get realm pointer
 					CRealm* prealm = pinfo->Realm();
 
+					// In non-network mode, the simulation can optionally take fixed steps,
+					// as many as real time calls for, and let the scene interpolate the
+					// frames in between.
+					int32_t	lStepTime	= g_GameSettings.m_sFixedStepTime;
+					bool		bFixedStep	= pinfo->IsFixedStep();
+					prealm->m_scene.m_bInterpolate	= bFixedStep;
+
 					// Adjust realm time.  How we do it depends on the mode we're in.
 					if (GetInputMode() == INPUT_MODE_LIVE)
 						{
@@ -3919,6 +4001,10 @@ class CPlayRealm : public CPlay
 							// In multiplayer mode, time moves in hardwired increments
 							prealm->m_time.Update(pinfo->FrameTime());
 							}
+						else if (bFixedStep)
+							{
+							// In fixed step mode, time moves one step per update below
+							}
 						else
 							{
 							// In non-network mode, time flows freely
@@ -3931,12 +4017,36 @@ class CPlayRealm : public CPlay
 						prealm->m_time.Update(DEMO_TIME_PER_FRAME);
 						}
 					
+					if (bFixedStep)
+						{
+						int16_t	sSteps	= prealm->m_time.GetDueSteps(lStepTime, FIXED_STEP_MAX_STEPS);
+						int16_t	sStep;
+						for (sStep = 0; sStep < sSteps; sStep++)
+							{
+							prealm->m_time.Step(lStepTime);
+
+							// Give the dude his share of what was input since the last step.
+							SetInput(0, TakeLocalStepInput(sSteps - sStep));
+
+							// Update Realm
+							prealm->Update();
 
-					// Update Realm
-					prealm->Update();
+							// Prepare Realm for rendering (Snap()).  Done every step so the
+							// scene sees each step's positions.
+							prealm->m_scene.StepTaken();
+							prealm->Render();
+							}
+
+						prealm->m_scene.SetStepFraction(prealm->m_time.GetStepFraction(lStepTime));
+						}
+					else
+						{
+						// Update Realm
+						prealm->Update();
 
-					// Prepare Realm for rendering (Snap()).
-					prealm->Render();
+						// Prepare Realm for rendering (Snap()).
+						prealm->Render();
+						}
 
 					// In demo mode (record or playback) we don't draw the results of the frame if
 					// we're falling behind.  However, we always draw when doing a demo-mode-movie .
@@ -3966,6 +4076,17 @@ class CPlayRealm : public CPlay
 						// Update grip/camera
 						int16_t	sX, sY;
 						prealm->Map3Dto2D(pdudeLocal->GetX(), pdudeLocal->GetY(), pdudeLocal->GetZ(), &sX, &sY);
+
+						// If interpolating, follow the dude where he's drawn, not where he is.
+						CSprite*	psprDude	= pdudeLocal->GetSprite();
+						if (bFixedStep && psprDude != NULL)
+							{
+							int16_t	sDrawX2, sDrawY2;
+							prealm->m_scene.GetDrawPos(psprDude, &sDrawX2, &sDrawY2);
+							sX	+= sDrawX2 - psprDude->m_sX2;
+							sY	+= sDrawY2 - psprDude->m_sY2;
+							}
+
 						pinfo->Grip()->TrackTarget(sX, sY, 30);
 
 						// Set coordinates for the "ear"
@@ -3980,6 +4101,8 @@ class CPlayRealm : public CPlay
 					pinfo->Camera()->Snap();
 					g_bSceneDontBlit = false;
 
+					m_telemetry.Sample(prealm);
+
 					// If in MP mode, clear the flag
 					if (pinfo->IsMP())
 						pinfo->m_bDoRealmFrame = false;
@@ -4047,6 +4170,9 @@ class CPlayRealm : public CPlay
 				// If we're not simply restarting the level . . .
 				if (pinfo->IsRestartingRealm() == false)
 					{
+					// The next realm needs loading.
+					m_snapRealm.Reset();
+
 					// Update players' stockpiles.
 					CListNode<CThing>*	plnDude		= prealm->m_aclassHeads[CThing::CDudeID].m_pnNext;
 					CListNode<CThing>*	plnDudeTail	= &(prealm->m_aclassTails[CThing::CDudeID]);
@@ -4062,6 +4188,8 @@ class CPlayRealm : public CPlay
 				// Shutdown realm
 				prealm->Shutdown();
 				}
+
+			m_bRestoreRealm	= pinfo->IsRestartingRealm();
 			}
 
 
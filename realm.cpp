@@ -343,6 +343,8 @@
 #include "score.h"
 #include <time.h>
 #include "MemFileFest.h"
+#include "FlowField.h"
+#include "Thing3d.h"
 
 //#define RSP_PROFILE_ON
 
@@ -372,6 +374,53 @@
 
 #define MAX_SMASH_DIAMETER				20
 
+// Distance from a CDude within which AI agents always run their logic.
+#define AI_NEAR_DISTANCE				500
+
+// Most updates an idle AI agent can be deferred for.  Elapsed time grows with
+// the number of buckets so keep this small enough that movement stays sane.
+#define AI_MAX_UPDATE_BUCKETS			8
+
+// Number of flow field cells built per update.  Spreads the cost of a new
+// field over a handful of updates.
+#define FLOWFIELD_CELLS_PER_UPDATE	2048
+
+// Classes that are updated in their own pass, in this order, after everything
+// else when batched updates are on.  These are things that get spawned in
+// bulk by characters and weapons and only need their spawners to have run
+// before them, not any particular order among themselves.  To try another
+// class, add it here and compare with batched updates on and off.
+static CThing::ClassIDType ms_aidBatchUpdate[]	=
+	{
+	CThing::CRocketID,
+	CThing::CHeatseekerID,
+	CThing::CGrenadeID,
+	CThing::CDynamiteID,
+	CThing::CFirebombID,
+	CThing::CFirefragID,
+	CThing::CNapalmID,
+	CThing::CFireballID,
+	CThing::CFirestreamID,
+	CThing::CDeathWadID,
+	CThing::CExplodeID,
+	CThing::CFireID,
+	CThing::CChunkID,
+	CThing::CAnimThingID,
+	};
+
+// Classes whose UpdateParallel() is called across the worker threads ahead
+// of the main update pass.  A class belongs here only if its
+// UpdateParallel() follows the rules in thing.h.
+static CThing::ClassIDType ms_aidParallelUpdate[]	=
+	{
+	CThing::CFireID,
+	CThing::CChunkID,
+	};
+
+// Fewest things worth handing to the worker threads.  Below this the phase
+// just runs on the calling thread.
+#define PARALLEL_UPDATE_MIN_THINGS	64
+
 #define REALM_DIALOG_FILE				"res/editor/realm.gui"
 
 #define TIMER_MIN_EDIT_ID				201
@@ -397,6 +446,10 @@ int16_t CRealm::ms_sFileCount;
 // an extra 32K of uncompressable space to the exe.
 int16_t CRealm::ms_asAttribToLayer[CRealm::LayerAttribMask + 1];
 
+// Classes that get their own pass during batched updates.  Filled in from
+// ms_aidBatchUpdate at run time.
+bool CRealm::ms_abBatchUpdate[CThing::TotalIDs];
+
 // Names of layers.  Use Layer enum values to index.
 char* CRealm::ms_apszLayerNames[TotalLayers]	=
 	{
@@ -581,6 +634,15 @@ CRealm::CRealm()
 	g_lExpValue = g_lExpTime - lTime; 
 
 	CreateLayerMap();
+
+	// Nothing gathered for the parallel phase yet.
+	m_papthingParallel	= NULL;
+	m_lMaxParallel			= 0;
+
+	// Mark the classes that get their own pass during batched updates.
+	int16_t	sBatch;
+	for (sBatch = 0; sBatch < NUM_ELEMENTS(ms_aidBatchUpdate); sBatch++)
+		ms_abBatchUpdate[ms_aidBatchUpdate[sBatch]] = true;
 	
 	// Setup render object (it's constructor was automatically called)
 	m_scene.SetLayers(TotalLayers);
@@ -625,6 +687,8 @@ CRealm::CRealm()
 		m_aclassTails[i].m_pnPrev = &(m_aclassHeads[i]);
 		m_aclassTails[i].m_powner = NULL;
 		m_asClassNumThings[i] = 0;
+		m_alClassAllocs[i] = 0;
+		m_alClassAllocsLast[i] = 0;
 		}
 
 	m_sNumThings = 0;
@@ -651,6 +715,20 @@ CRealm::CRealm()
 
 	m_bPressedEndLevelKey = false;
 
+	// AI scheduler is off until someone turns it on.
+	m_sAIUpdateBuckets	= 1;
+	m_dAINearDistanceSQ	= AI_NEAR_DISTANCE * AI_NEAR_DISTANCE;
+
+	// Update everything in creation order until someone says otherwise.
+	m_bBatchUpdate			= false;
+
+	// No flow fields until someone turns them on.
+	m_bFlowFieldNav		= false;
+	m_sNumFlowFields		= 0;
+
+	// Deliver every broadcast until someone says otherwise.
+	m_bCoalesceMsgs		= false;
+
 	// Initialize.
 	Init();
 	}
@@ -667,6 +745,13 @@ CRealm::~CRealm()
 	// Double-check to be sure there's nothing left
 	if (m_everythingHead.m_pnNext != &m_everythingTail)
 		TRACE("CRealm::~CRealm(): There are still %d CThing's in this realm!\n", m_sNumThings);
+
+	m_workers.Stop();
+	if (m_papthingParallel != NULL)
+		{
+		free(m_papthingParallel);
+		m_papthingParallel	= NULL;
+		}
 	}
 
 
@@ -706,6 +791,13 @@ void CRealm::Init(void)		// Returns nothing.  Cannot fail.
 		m_asPylonUIDs[i] = 0; // clear the Pylon UIDs!
 	m_sNumPylons = 0;
 	m_ucNextPylonID = 1;
+
+	// Reset AI scheduler.
+	m_ulNumUpdates		= 0;
+	m_sAIUpdated		= 0;
+	m_sAIDeferred		= 0;
+	m_sAIUpdatedLast	= 0;
+	m_sAIDeferredLast	= 0;
 	}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -730,6 +822,9 @@ void CRealm::Clear()
 	// Clear out any sprites that didn't already remove themselves
 	m_scene.RemoveAllSprites();
 
+	// Flow fields were built for this realm's terrain.
+	FreeFlowFields();
+
 	// Clear out any residue IDs.  Shouldn't need to, but . . .
 	m_idbank.Reset();
 
@@ -847,7 +942,8 @@ int16_t CRealm::Load(										// Returns 0 if successfull, non-zero otherwise
 ////////////////////////////////////////////////////////////////////////////////
 int16_t CRealm::Load(										// Returns 0 if successfull, non-zero otherwise
 	RFile* pFile,											// In:  File to load from
-	bool bEditMode)										// In:  Use true for edit mode, false otherwise
+	bool bEditMode,										// In:  Use true for edit mode, false otherwise
+	bool bPreload)											// In:  false to skip class preloads
 	{
 	int16_t sResult = 0;
 	
@@ -931,7 +1027,7 @@ int16_t CRealm::Load(										// Returns 0 if successfull, non-zero otherwise
 					// call it to give that class a chance to preload stuff.  The intention
 					// is to give classes whose objects don't exist at the start of a level
 					// a chance to preload resources now rather than during gameplay.
-					for (int16_t sPre = 0; sPre < CThing::TotalIDs; sPre++)
+					for (int16_t sPre = 0; (sPre < CThing::TotalIDs) && bPreload; sPre++)
 						{
 						CThing::FuncPreload func = CThing::ms_aClassInfo[sPre].funcPreload;
 						if (func != 0)
@@ -1432,16 +1528,116 @@ void CRealm::Update(void)
 	// Entering update loop.
 	m_bUpdating	= true;
 
-	// Do this for everything.
+	// Start this update's AI stats from scratch.
+	m_sAIUpdated	= 0;
+	m_sAIDeferred	= 0;
+
+	// Let the parallel classes get a head start on the worker threads.
+	if (m_workers.GetNumThreads() > 0)
+	{
+		rspStartProfile("Realm Update Parallel");
+
+		int32_t	lNumParallel	= 0;
+		int16_t	sParallel;
+		for (sParallel = 0; sParallel < NUM_ELEMENTS(ms_aidParallelUpdate); sParallel++)
+			lNumParallel	+= m_asClassNumThings[ms_aidParallelUpdate[sParallel]];
+
+		if (lNumParallel > m_lMaxParallel)
+		{
+			CThing**	papthing	= (CThing**)realloc(m_papthingParallel, lNumParallel * sizeof(CThing*));
+			if (papthing != NULL)
+			{
+				m_papthingParallel	= papthing;
+				m_lMaxParallel			= lNumParallel;
+			}
+		}
+
+		// If we couldn't get room, everyone just moves in their Update().
+		if (lNumParallel <= m_lMaxParallel)
+		{
+			int32_t	lThing	= 0;
+			for (sParallel = 0; sParallel < NUM_ELEMENTS(ms_aidParallelUpdate); sParallel++)
+			{
+				CListNode<CThing>*	pnode	= m_aclassHeads[ms_aidParallelUpdate[sParallel]].m_pnNext;
+				while (pnode->m_powner != NULL)
+				{
+					m_papthingParallel[lThing++]	= pnode->m_powner;
+					pnode	= pnode->m_pnNext;
+				}
+			}
+
+			if (lNumParallel >= PARALLEL_UPDATE_MIN_THINGS)
+				m_workers.Run(UpdateParallelWork, this, lNumParallel);
+			else
+				UpdateParallelWork(this, 0, 0, lNumParallel);
+
+			// Now apply what they put off, in gathered order.
+			int16_t	sPiece;
+			for (sPiece = 0; sPiece <= m_workers.GetNumThreads(); sPiece++)
+				m_adeferParallel[sPiece].Apply(this);
+		}
+
+		rspEndProfile("Realm Update Parallel");
+	}
+
+	// Do this for everything (except batched classes, if batching).
 	CThing* pthing;
 	m_pNext = m_everythingHead.m_pnNext;
 	while (m_pNext->m_powner != NULL)
 	{
 		pthing = m_pNext->m_powner;
 		m_pNext = m_pNext->m_pnNext;
-		pthing->Update();
+		if (m_bBatchUpdate == false || ms_abBatchUpdate[pthing->GetClassID()] == false)
+			pthing->Update();
 	}
 
+	// Then each batched class gets its own pass.  Things spawned during the
+	// main pass or by an earlier batch are picked up by their class's pass.
+	// AddThing() and RemoveThing() keep m_pNext valid here just like above.
+	if (m_bBatchUpdate == true)
+	{
+		rspStartProfile("Realm Update Batched");
+
+		int16_t sBatch;
+		for (sBatch = 0; sBatch < NUM_ELEMENTS(ms_aidBatchUpdate); sBatch++)
+		{
+			m_pNext = m_aclassHeads[ms_aidBatchUpdate[sBatch]].m_pnNext;
+			while (m_pNext->m_powner != NULL)
+			{
+				pthing = m_pNext->m_powner;
+				m_pNext = m_pNext->m_pnNext;
+				pthing->Update();
+			}
+		}
+
+		rspEndProfile("Realm Update Batched");
+	}
+
+	// Spend this update's budget on any flow fields that are still building.
+	if (m_bFlowFieldNav == true)
+		{
+		int32_t	lBudget	= FLOWFIELD_CELLS_PER_UPDATE;
+		int16_t	sField;
+		for (sField = 0; sField < m_sNumFlowFields && lBudget > 0; sField++)
+			{
+			if (m_apFlowFields[sField]->IsComplete() == false)
+				lBudget	-= m_apFlowFields[sField]->Build(lBudget);
+			}
+		}
+
+	// Keep the AI stats around for display and advance to the next bucket.
+	m_sAIUpdatedLast	= m_sAIUpdated;
+	m_sAIDeferredLast	= m_sAIDeferred;
+	m_ulNumUpdates++;
+
+	// Keep the allocation counts around, too, and start over.
+	int16_t	sClass;
+	for (sClass = 0; sClass < CThing::TotalIDs; sClass++)
+		{
+		m_alClassAllocsLast[sClass]	= m_alClassAllocs[sClass];
+		m_alClassAllocs[sClass]			= 0;
+		}
+
 	// Update the display timer
 	m_lThisTime = m_time.GetGameTime();
 	m_lElapsedTime = m_lThisTime - m_lPrevTime;
@@ -1480,6 +1676,214 @@ void CRealm::Render(void)
 	m_bUpdating	= false;
 	}
 
+
+////////////////////////////////////////////////////////////////////////////////
+// Determine whether an AI agent should run its logic during this update.
+// Idle agents that are far from every CDude are split into m_sAIUpdateBuckets
+// groups by instance ID and only the group matching the update count runs.
+// Since the update count, IDs and positions are identical on every machine,
+// so is the result.
+////////////////////////////////////////////////////////////////////////////////
+bool CRealm::IsAIUpdateDue(			// Returns true, if the agent should run now.
+	U16		u16InstanceID,				// In:  Agent's instance ID (selects its bucket).
+	bool		bIdle,						// In:  true, if the agent is idle and can wait.
+	double	dX,							// In:  Agent's X position.
+	double	dZ)							// In:  Agent's Z position.
+	{
+	bool	bDue	= true;
+
+	int16_t	sBuckets	= MIN(m_sAIUpdateBuckets, (int16_t)AI_MAX_UPDATE_BUCKETS);
+	if (bIdle == true && sBuckets > 1)
+		{
+		// If it's not this agent's turn, see if any CDude is close enough to
+		// care.  Only bother checking when it would make a difference.
+		if ( (m_ulNumUpdates + u16InstanceID) % sBuckets != 0)
+			{
+			bDue	= false;
+
+			CListNode<CThing>* pNext = m_aclassHeads[CThing::CDudeID].m_pnNext;
+			while (pNext->m_powner != NULL && bDue == false)
+				{
+				double	dDeltaX	= pNext->m_powner->GetX() - dX;
+				double	dDeltaZ	= pNext->m_powner->GetZ() - dZ;
+				if (dDeltaX * dDeltaX + dDeltaZ * dDeltaZ < m_dAINearDistanceSQ)
+					{
+					bDue	= true;
+					}
+
+				pNext = pNext->m_pnNext;
+				}
+			}
+		}
+
+	if (bDue == true)
+		m_sAIUpdated++;
+	else
+		m_sAIDeferred++;
+
+	return bDue;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Send a message to every thing whose CSmash overlaps the specified CSmash.
+//
+// Messages that only need to arrive once per update (like a yell for help)
+// can be coalesced: a thing that already got one of the same type during this
+// update is skipped before we bother with the (relatively expensive) line of
+// sight check.  This keeps a crowd yelling at once from flooding everyone's
+// message queues with duplicates.  Coalescing changes how many messages get
+// delivered, so it's only done when m_bCoalesceMsgs is set.
+////////////////////////////////////////////////////////////////////////////////
+int16_t CRealm::SendMessageInRadius(	// Returns number of things messaged.
+	GameMessage*	pmsg,						// In:  Message to send.
+	CSmash*			psmash,					// In:  Area to send within.  Its thing is skipped.
+	CSmash::Bits	include,					// In:  Bits that must be 1 to get the message.
+	CSmash::Bits	dontcare,				// In:  Bits that you don't care about.
+	CSmash::Bits	exclude,					// In:  Bits that must be 0 to get the message.
+	U16				u16ExceptID,			// In:  Instance ID to skip, if any.
+	bool				bLineOfSight,			// In:  true to skip things the terrain hides
+													// from the center of the area.
+	bool				bCoalesce)				// In:  true to skip things that already got a
+													// coalesced message of the same type this update.
+	{
+	int16_t	sNumSent	= 0;
+	int16_t	sType		= pmsg->msg_Generic.eType;
+	uint32_t	ulStamp	= m_ulNumUpdates + 1;
+	CThing*	pthingSender	= psmash->m_pThing;
+	ASSERT(pthingSender != NULL);
+
+	if (m_bCoalesceMsgs == false)
+		bCoalesce	= false;
+
+	CSmash*	psmashed	= NULL;
+	m_smashatorium.QuickCheckReset(psmash, include, dontcare, exclude);
+	while (m_smashatorium.QuickCheckNext(&psmashed) == true)
+		{
+		CThing*	pthing	= psmashed->m_pThing;
+		ASSERT(pthing != NULL);
+		if (pthing == pthingSender || pthing->GetInstanceID() == u16ExceptID)
+			continue;
+
+		if (bCoalesce == true && pthing->m_ulCoalescedMsgStamp == ulStamp && pthing->m_sCoalescedMsgType == sType)
+			continue;
+
+		if (bLineOfSight == true)
+			{
+			if (IsPathClear(
+					(int16_t)psmash->m_sphere.sphere.X,		// In:  Starting X.
+					(int16_t)psmash->m_sphere.sphere.Y,		// In:  Starting Y.
+					(int16_t)psmash->m_sphere.sphere.Z,		// In:  Starting Z.
+					3.0,												// In:  Rate at which to scan ('crawl') path.
+					(int16_t)psmashed->m_sphere.sphere.X,	// In:  Destination X.
+					(int16_t)psmashed->m_sphere.sphere.Z,	// In:  Destination Z.
+					0,													// In:  Max traverser can step up.
+					NULL,												// Out: If not NULL, last clear point on path.
+					NULL,												// Out: If not NULL, last clear point on path.
+					NULL,												// Out: If not NULL, last clear point on path.
+					true) == false)								// In:  Edge of the realm blocks the path.
+				continue;
+			}
+
+		if (pthingSender->SendThingMessage(pmsg, pthing) == SUCCESS)
+			{
+			sNumSent++;
+			if (bCoalesce == true)
+				{
+				pthing->m_sCoalescedMsgType	= sType;
+				pthing->m_ulCoalescedMsgStamp	= ulStamp;
+				}
+			}
+		}
+
+	return sNumSent;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Get the flow field leading to the specified goal, creating it if this is the
+// first request for it.  Fields are only ever added in the order they're first
+// requested and built in that order, so every machine ends up with the same
+// fields in the same state.
+////////////////////////////////////////////////////////////////////////////////
+CFlowField* CRealm::GetFlowField(	// Returns field or NULL, if none available.
+	int16_t	sGoalX,						// In:  Goal's X position.
+	int16_t	sGoalZ)						// In:  Goal's Z position.
+	{
+	CFlowField*	pfield	= NULL;
+
+	int16_t	sField;
+	for (sField = 0; sField < m_sNumFlowFields && pfield == NULL; sField++)
+		{
+		if (m_apFlowFields[sField]->IsGoal(sGoalX, sGoalZ) == true)
+			pfield	= m_apFlowFields[sField];
+		}
+
+	if (pfield == NULL && m_sNumFlowFields < MaxFlowFields && m_pTerrainMap != NULL)
+		{
+		pfield	= new CFlowField;
+		if (pfield->Setup(this, sGoalX, sGoalZ, CThing3d::MaxStepUpThreshold) == 0)
+			{
+			m_apFlowFields[m_sNumFlowFields++]	= pfield;
+			}
+		else
+			{
+			delete pfield;
+			pfield	= NULL;
+			}
+		}
+
+	return pfield;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Start the specified number of worker threads for the parallel update phase.
+////////////////////////////////////////////////////////////////////////////////
+int16_t CRealm::SetUpdateThreads(		// Returns 0 on success.
+	int16_t	sNumThreads)					// In:  Number of threads.
+	{
+	int16_t	sResult	= 0;
+
+	if (sNumThreads != m_workers.GetNumThreads())
+		{
+		sResult	= m_workers.Start(sNumThreads);
+		}
+
+	return sResult;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Call UpdateParallel() for the specified range of gathered things.  Called
+// by the worker threads.
+// (static).
+////////////////////////////////////////////////////////////////////////////////
+void CRealm::UpdateParallelWork(	// Returns nothing.
+	void*		pvRealm,					// In:  Realm (this).
+	int16_t	sPiece,					// In:  Piece, which picks the defer list.
+	int32_t	lFirst,					// In:  First thing.
+	int32_t	lEnd)						// In:  One past the last thing.
+	{
+	CRealm*		prealm	= (CRealm*)pvRealm;
+	CThing**		papthing	= prealm->m_papthingParallel;
+	CDeferList*	pdefer	= &prealm->m_adeferParallel[sPiece];
+	int32_t	l;
+	for (l = lFirst; l < lEnd; l++)
+		papthing[l]->UpdateParallel(pdefer);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Free all flow fields.
+////////////////////////////////////////////////////////////////////////////////
+void CRealm::FreeFlowFields(void)
+	{
+	int16_t	sField;
+	for (sField = 0; sField < m_sNumFlowFields; sField++)
+		{
+		delete m_apFlowFields[sField];
+		m_apFlowFields[sField]	= NULL;
+		}
+
+	m_sNumFlowFields	= 0;
+	}
+
 // This old way probably doesn't make sense any more since we're going to allow
 // for multiple views of a realm.  I don't think we'd want to tell each object
 // to render itself for each different view -- not unless the enter concept of
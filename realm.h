@@ -327,6 +327,9 @@
 #include "yatime.h"
 #include "IdBank.h"
 #include "smash.h"
+#include "ThingPool.h"
+#include "WorkerPool.h"
+#include "DeferList.h"
 #include "trigger.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -425,6 +428,7 @@
 #define REALM_NONSTL 1
 
 class CNavigationNet;
+class CFlowField;
 
 class CRealm
 	{
@@ -438,7 +442,8 @@ class CRealm
 			{
 			FileID = 0x44434241,									// File ID
 			FileVersion = 49,										// File version
-			Num2dPaths	= 3										// Number of 2D res paths
+			Num2dPaths	= 3,										// Number of 2D res paths
+			MaxFlowFields	= 64									// Max flow fields at once
 			};
 
 		enum	// Macros.
@@ -568,6 +573,10 @@ class CRealm
 		// 2D resource paths.
 		static char* ms_apsz2dResPaths[Num2dPaths];
 
+		// true for each class that gets its own pass when m_bBatchUpdate is
+		// set.  Filled in from the batch table in realm.cpp.
+		static bool ms_abBatchUpdate[CThing::TotalIDs];
+
 
 	//---------------------------------------------------------------------------
 	// Non-static variables
@@ -595,6 +604,11 @@ class CRealm
 		CListNode<CThing> m_aclassTails[CThing::TotalIDs];
 		int16_t m_asClassNumThings[CThing::TotalIDs];
 
+		// Number of CThings of each class constructed so far this update and
+		// during the last update.  Useful for spotting churn.
+		int32_t m_alClassAllocs[CThing::TotalIDs];
+		int32_t m_alClassAllocsLast[CThing::TotalIDs];
+
 		// Pointer to the attribute map.  The CHood is expected to set these
 		// as soon as it can so that other obects can use it.  This is really
 		// just a shortcut to the attribute map since so many objects need to use
@@ -628,6 +642,15 @@ class CRealm
 		// CSmashitorium to be included in collision detection for this CRealm.
 		CSmashatorium	m_smashatorium;
 
+		// Pool of message nodes shared by every CThing's message queue.  Must
+		// outlive the CThings, which it does since they're destroyed by Clear().
+		CMsgPool		m_msgpool;
+
+		// Pools of memory for short lived CThings, one per class.  Only classes
+		// that ask for it (see CThing::operator new) use their pool.  Must
+		// outlive the CThings for the same reason as m_msgpool.
+		CThingPool	m_athingpools[CThing::TotalIDs];
+
 		// Number of Suspend() calls that have occurred without corresponding 
 		// Resume() calls.
 		// If 0, we are not suspended.
@@ -686,6 +709,55 @@ class CRealm
 		bool	m_bPressedEndLevelKey;	// True if the player pressed the key or controller button bound to "End Map"
 										// Different from the hardcoded F1 key
 
+		// AI scheduler.  Agents that are idle (guarding, walking around, etc.)
+		// and farther than m_dAINearDistanceSQ from every CDude only run their
+		// logic once every m_sAIUpdateBuckets updates, staggered by instance ID
+		// so the work is spread evenly across updates.  Agents that are near a
+		// CDude, engaged or have messages waiting always run.  The decision is
+		// based solely on simulation state so it comes out the same on every
+		// machine.  See IsAIUpdateDue().
+		int16_t		m_sAIUpdateBuckets;		// Number of buckets.  1 or less runs everyone every update.
+		double		m_dAINearDistanceSQ;		// Squared distance to a CDude within which agents always run.
+		uint32_t		m_ulNumUpdates;			// Number of Update()s since the last Clear().
+		int16_t		m_sAIUpdated;				// Agents that ran their logic so far this update.
+		int16_t		m_sAIDeferred;				// Agents that were deferred so far this update.
+		int16_t		m_sAIUpdatedLast;			// Agents that ran their logic during the last update.
+		int16_t		m_sAIDeferredLast;		// Agents that were deferred during the last update.
+
+		// Batched updates.  When m_bBatchUpdate is set, classes listed in the
+		// batch table in realm.cpp (projectiles and effects, mostly) are skipped
+		// during the main pass over everything and instead updated afterwards,
+		// one class at a time, in the table's order.  Everything else updates
+		// in creation order just like always.
+		bool			m_bBatchUpdate;			// true to use batched updates.
+
+		// Broadcast coalescing.  When m_bCoalesceMsgs is set,
+		// SendMessageInRadius() delivers coalesced messages to each thing at
+		// most once per update.
+		bool			m_bCoalesceMsgs;			// true to coalesce broadcasts.
+
+		// Parallel updates.  When worker threads are started (see
+		// SetUpdateThreads()), things of the classes listed in the parallel
+		// table in realm.cpp have their UpdateParallel() called across the
+		// threads before the main pass.  Side effects they defer go in their
+		// piece's list, and the lists are applied in piece order (which is the
+		// order the things were gathered in) before the main pass, so the
+		// outcome is the same with any number of threads.  It is not the same as
+		// not running the phase at all, though, since things in the table act
+		// before everyone else instead of in their usual turn.
+		CWorkerPool	m_workers;					// Threads for the parallel phase.
+		CThing**		m_papthingParallel;		// Things gathered for the parallel phase.
+		int32_t		m_lMaxParallel;			// Size of m_papthingParallel.
+		CDeferList	m_adeferParallel[CWorkerPool::MaxThreads + 1];	// Side effects per piece.
+
+		// Flow fields.  When m_bFlowFieldNav is set, crowds that are panicking,
+		// walking or marching toward the same bouy share one CFlowField instead
+		// of each steering on its own.  Fields are created on demand by
+		// GetFlowField() and built a little at a time during Update().
+		bool			m_bFlowFieldNav;			// true to let crowds use flow fields.
+		CFlowField*	m_apFlowFields[MaxFlowFields];	// Fields created so far.
+		int16_t		m_sNumFlowFields;			// Number of fields in m_apFlowFields.
+
 	//---------------------------------------------------------------------------
 	// Non-static functions
 	//---------------------------------------------------------------------------
@@ -789,6 +861,7 @@ class CRealm
 
 			m_sNumThings++;
 			m_asClassNumThings[id]++;
+			m_alClassAllocs[id]++;
 
 			// If in the update loop...
 			if (m_bUpdating == true)
@@ -799,6 +872,12 @@ class CRealm
 					// Set next to the newly added thing
 					m_pNext = &(pThing->m_everything);
 					}
+				// If we're walking this class's list and the next is its end...
+				else if (m_pNext == &(m_aclassTails[id]))
+					{
+					// Set next to the newly added thing
+					m_pNext = &(pThing->m_nodeClass);
+					}
 				}
 			}
 
@@ -843,6 +922,11 @@ class CRealm
 					// This is save b/c the end is always available and will never be removed
 					m_pNext = pThing->m_everything.m_pnNext;
 					}
+				// Same goes for when we're walking its class's list.
+				else if (m_pNext == &(pThing->m_nodeClass))
+					{
+					m_pNext = pThing->m_nodeClass.m_pnNext;
+					}
 				}
 
 			pThing->m_everything.Remove();
@@ -873,7 +957,9 @@ class CRealm
 		// Load
 		int16_t Load(													// Returns 0 if successfull, non-zero otherwise
 			RFile* pFile,											// In:  File to load from
-			bool bEditMode);										// In:  Use true for edit mode, false otherwise
+			bool bEditMode,										// In:  Use true for edit mode, false otherwise
+			bool bPreload = true);								// In:  false to skip class preloads (they
+																		// already happened for this realm)
 
 		// Save
 		int16_t Save(													// Returns 0 if successfull, non-zero otherwise
@@ -903,6 +989,42 @@ class CRealm
 		// Render
 		void Render(void);
 
+		// Determine whether an AI agent should run its logic during this
+		// update (see m_sAIUpdateBuckets).  Also tallies the per-update stats.
+		bool IsAIUpdateDue(					// Returns true, if the agent should run now.
+			U16		u16InstanceID,				// In:  Agent's instance ID (selects its bucket).
+			bool		bIdle,						// In:  true, if the agent is idle and can wait.
+			double	dX,							// In:  Agent's X position.
+			double	dZ);							// In:  Agent's Z position.
+
+		// Send a message to every thing whose CSmash overlaps the specified
+		// CSmash, finding them with a single pass over the collision grid.
+		int16_t SendMessageInRadius(			// Returns number of things messaged.
+			GameMessage*	pmsg,					// In:  Message to send.
+			CSmash*			psmash,				// In:  Area to send within.  Its thing is skipped.
+			CSmash::Bits	include,				// In:  Bits that must be 1 to get the message.
+			CSmash::Bits	dontcare,			// In:  Bits that you don't care about.
+			CSmash::Bits	exclude,				// In:  Bits that must be 0 to get the message.
+			U16				u16ExceptID	= CIdBank::IdNil,	// In:  Instance ID to skip, if any.
+			bool				bLineOfSight	= false,		// In:  true to skip things the terrain hides
+																	// from the center of the area.
+			bool				bCoalesce		= false);	// In:  true to skip things that already got a
+																	// coalesced message of the same type this update.
+
+		// Get the flow field leading to the specified goal, creating it if this
+		// is the first request for it.  The field may not be complete yet.
+		CFlowField* GetFlowField(			// Returns field or NULL, if none available.
+			int16_t	sGoalX,						// In:  Goal's X position.
+			int16_t	sGoalZ);						// In:  Goal's Z position.
+
+		// Free all flow fields.
+		void FreeFlowFields(void);
+
+		// Start the specified number of worker threads for the parallel update
+		// phase.  0 turns the phase off.
+		int16_t SetUpdateThreads(			// Returns 0 on success.
+			int16_t	sNumThreads);				// In:  Number of threads.
+
 		// Edit-mode update
 		void EditUpdate(void);
 
@@ -1119,6 +1241,14 @@ class CRealm
 	//---------------------------------------------------------------------------
 	protected:
 
+		// Call UpdateParallel() for the specified range of gathered things.
+		// A CWorkerPool::WorkFunc.
+		static void UpdateParallelWork(	// Returns nothing.
+			void*		pvRealm,					// In:  Realm (this).
+			int16_t	sPiece,					// In:  Piece, which picks the defer list.
+			int32_t	lFirst,					// In:  First thing.
+			int32_t	lEnd);					// In:  One past the last thing.
+
 	};
 
 
@@ -324,6 +324,10 @@
 #include "alphablitforpostal.h"
 #include "reality.h"
 
+//#define RSP_PROFILE_ON
+
+#include "ORANGE/Debug/profile.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Macros/types/etc.
@@ -357,6 +361,9 @@ bool	g_bSceneDontBlit;
 #define FONT_BACK_COLOR				0
 #define FONT_SHADOW_COLOR			0
 
+// Farthest a sprite can move in one step and still be interpolated.
+#define INTERPOLATE_MAX_JUMP		48
+
 const double	c_dMaxScale		= 10.0;
 const double	c_dMinScale		= 0.2;
 
@@ -393,6 +400,20 @@ CScene::CScene()
 
 	// Default to something (anything)
 	m_bXRayAll = false;
+
+	// Draw sprites where they are until someone says otherwise.
+	m_bInterpolate	= false;
+	m_lStep			= 0;
+	m_sStepFrac		= 0;
+
+	m_lNumResorts	= 0;
+	m_lNumSorts		= 0;
+
+	m_lPixelsTested	= 0;
+	m_lPixelsWritten	= 0;
+	m_lTrisHidden		= 0;
+
+	m_bImpostors	= false;
 	}
 
 
@@ -413,6 +434,9 @@ void CScene::Clear(void)
 	// Clear all sprites from all layers
 	RemoveAllSprites();
 
+	// Forget what they looked like
+	m_rendercache.Flush();
+
 	// Delete the layers
  	delete []m_pLayers;
  	m_pLayers = 0;
@@ -441,11 +465,15 @@ void CScene::RemoveSprites(
 	Layer* pLayer = &(m_pLayers[sLayer]);
 
 	// Go through layer's collection of sprites
-	for (msetSprites::iterator i = pLayer->m_sprites.begin(); i != pLayer->m_sprites.end(); i++)
+	for (vSprites::iterator i = pLayer->m_sprites.begin(); i != pLayer->m_sprites.end(); i++)
 		{
 		// Get pointer to sprite
 		CSprite* pSprite = *i;
 
+		// Skip slots emptied since the last sort
+		if (pSprite == NULL)
+			continue;
+
 		// Clear inserted flag
 		pSprite->m_sPrivFlags &= ~CSprite::PrivInserted;
 
@@ -455,11 +483,9 @@ void CScene::RemoveSprites(
 		}
 
 	// Clear the sprite container
-#if _MSC_VER >= 1020
 	pLayer->m_sprites.clear();
-#else
-	pLayer->m_sprites.erase(pLayer->m_sprites.begin(), pLayer->m_sprites.end());
-#endif
+	pLayer->m_lNumEmpty = 0;
+	pLayer->m_bSorted = true;
 	}
 
 
@@ -489,46 +515,241 @@ void CScene::UpdateSprite(
 	{
 	ASSERT(pSprite != NULL);
 
+	// Keep track of where the sprite was at its last two steps.
+	if (pSprite->m_lStep != m_lStep)
+		{
+		pSprite->m_sPrevX2	= pSprite->m_sStepX2;
+		pSprite->m_sPrevY2	= pSprite->m_sStepY2;
+		pSprite->m_lPrevStep	= pSprite->m_lStep;
+		pSprite->m_lStep		= m_lStep;
+		}
+
+	pSprite->m_sStepX2	= pSprite->m_sX2;
+	pSprite->m_sStepY2	= pSprite->m_sY2;
+
 	// Check if it's already in the scene
 	if (pSprite->m_sPrivFlags & CSprite::PrivInserted)
 		{
-		// Check if layer has changed
-		if (pSprite->m_sLayer != pSprite->m_sSavedLayer)
+		// Things that move change priority nearly every frame, but usually not
+		// by enough to pass anyone.  If the layer is in order and the sprite
+		// still sorts after the previous sprite and before the next one (by the
+		// priorities they were sorted with), sorting it again would put it
+		// right back where it is.
+		bool bInOrder = false;
+		Layer* pLayer = &(m_pLayers[pSprite->m_sSavedLayer]);
+		if (	pSprite->m_sLayer == pSprite->m_sSavedLayer
+			&&	pSprite->m_sPriority != pSprite->m_sSavedPriority
+			&&	pLayer->m_bSorted == true)
 			{
-			// Erase from old layer
-			m_pLayers[pSprite->m_sSavedLayer].m_sprites.erase(pSprite->m_iter);
+			int32_t lIndex = pSprite->m_lIndex;
+			bInOrder = (lIndex + 1 == (int32_t)pLayer->m_sprites.size() || pLayer->m_sprites[lIndex + 1]->m_sSavedPriority > pSprite->m_sPriority)
+				&&	(lIndex == 0 || pLayer->m_sprites[lIndex - 1]->m_sSavedPriority <= pSprite->m_sPriority);
+			}
 
-			// Add to specified layer and save iterator for fast access later on
+		if (bInOrder == true)
+			{
+			pSprite->m_sSavedPriority = pSprite->m_sPriority;
+			}
+		// Otherwise, if its layer or priority has changed, it goes on the end
+		// of its (possibly new) layer to be sorted into place.
+		else if (pSprite->m_sLayer != pSprite->m_sSavedLayer || pSprite->m_sPriority != pSprite->m_sSavedPriority)
+			{
 			ASSERT(pSprite->m_sLayer < m_sNumLayers);
 			ASSERT(pSprite->m_sLayer >= 0);
-			pSprite->m_iter = m_pLayers[pSprite->m_sLayer].m_sprites.insert(pSprite);
+			AppendSprite(pSprite);
 			pSprite->m_sSavedLayer = pSprite->m_sLayer;
-			}
-
-		// Check if priority has changed
-		if (pSprite->m_sPriority != pSprite->m_sSavedPriority)
-			{
-			// For now, just erase it and then re-insert it.  There is definitely
-			// a faster way to do this, but since we'll likely be revamping the
-			// entire draw-order logic, I'll leave it like this.
-			m_pLayers[pSprite->m_sSavedLayer].m_sprites.erase(pSprite->m_iter);
-			pSprite->m_iter = m_pLayers[pSprite->m_sLayer].m_sprites.insert(pSprite);
 			pSprite->m_sSavedPriority = pSprite->m_sPriority;
 			}
 		}
 	else
 		{
-		// Add to specified layer and save iterator for fast access later on
+		// Add to specified layer and save index for fast access later on
 		ASSERT(pSprite->m_sLayer < m_sNumLayers);
 		ASSERT(pSprite->m_sLayer >= 0);
-		pSprite->m_iter = m_pLayers[pSprite->m_sLayer].m_sprites.insert(pSprite);
+		pSprite->m_sPrivFlags |= CSprite::PrivInserted;
+		pSprite->m_lIndex = -1;
+		AppendSprite(pSprite);
  
 		// Save layer and priority so we can detect changes to them
 		pSprite->m_sSavedLayer = pSprite->m_sLayer;
 		pSprite->m_sSavedPriority = pSprite->m_sPriority;
 
-		// Set inserted flag
-		pSprite->m_sPrivFlags |= CSprite::PrivInserted;
+		// Nowhere to come from yet.
+		pSprite->m_sPrevX2	= pSprite->m_sX2;
+		pSprite->m_sPrevY2	= pSprite->m_sY2;
+		pSprite->m_lPrevStep	= m_lStep;
+		}
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Add sprite to the end of its layer, emptying its old slot (if any).  The
+// sprite's m_lIndex must be -1 if it isn't in a layer yet, and otherwise
+// m_sSavedLayer must still say which layer it's in.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::AppendSprite(
+	CSprite* pSprite)										// In:  Sprite to append
+	{
+	Layer* pLayer = &(m_pLayers[pSprite->m_sLayer]);
+
+	if (pSprite->m_lIndex >= 0)
+		{
+		Layer* pOldLayer = &(m_pLayers[pSprite->m_sSavedLayer]);
+		pOldLayer->m_bSorted = false;
+
+		// If it's already last in the right layer, it's as good as appended.
+		if (pOldLayer == pLayer && pSprite->m_lIndex == (int32_t)pLayer->m_sprites.size() - 1)
+			return;
+
+		// Empty its old slot.  Anything empty gets squeezed out by the next sort.
+		pOldLayer->m_sprites[pSprite->m_lIndex] = NULL;
+		pOldLayer->m_lNumEmpty++;
+		}
+
+	// Layers that aren't being drawn aren't being sorted either, so squeeze
+	// this one here before it grows, once half its slots are empty.
+	if (pLayer->m_lNumEmpty * 2 > (int32_t)pLayer->m_sprites.size())
+		CompactLayer(pLayer);
+
+	pSprite->m_lIndex = (int32_t)pLayer->m_sprites.size();
+	pLayer->m_sprites.push_back(pSprite);
+	pLayer->m_bSorted = false;
+	m_lNumResorts++;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Put the layer's sprites in draw order (back to front by priority) and
+// squeeze out empty slots.  This is a stable radix sort, two passes of eight
+// bits each, so sprites with the same priority keep their order (see Layer).
+////////////////////////////////////////////////////////////////////////////////
+void CScene::SortLayer(
+	Layer* pLayer)											// In:  Layer to sort
+	{
+	vSprites& sprites = pLayer->m_sprites;
+	vSprites& temp = pLayer->m_spritesSort;
+
+	// Squeeze out the empty slots and count both digits of each key at the
+	// same time.  Flipping the sign bit makes signed priorities sort as
+	// unsigned keys.
+	int32_t alCountLo[256];
+	int32_t alCountHi[256];
+	memset(alCountLo, 0, sizeof(alCountLo));
+	memset(alCountHi, 0, sizeof(alCountHi));
+
+	int32_t lNum = 0;
+	int32_t lSize = (int32_t)sprites.size();
+	int32_t l;
+	for (l = 0; l < lSize; l++)
+		{
+		CSprite* pSprite = sprites[l];
+		if (pSprite != NULL)
+			{
+			uint16_t u16Key = (uint16_t)pSprite->m_sPriority ^ 0x8000;
+			alCountLo[u16Key & 0xff]++;
+			alCountHi[u16Key >> 8]++;
+			sprites[lNum++] = pSprite;
+			}
+		}
+	sprites.resize(lNum);
+	pLayer->m_lNumEmpty = 0;
+	temp.resize(lNum);
+
+	// Turn the counts into starting positions.
+	int32_t lPosLo = 0;
+	int32_t lPosHi = 0;
+	for (l = 0; l < 256; l++)
+		{
+		int32_t lCount = alCountLo[l];
+		alCountLo[l] = lPosLo;
+		lPosLo += lCount;
+
+		lCount = alCountHi[l];
+		alCountHi[l] = lPosHi;
+		lPosHi += lCount;
+		}
+
+	// Low digit into the scratch array, then high digit back.
+	for (l = 0; l < lNum; l++)
+		{
+		CSprite* pSprite = sprites[l];
+		temp[alCountLo[((uint16_t)pSprite->m_sPriority ^ 0x8000) & 0xff]++] = pSprite;
+		}
+
+	for (l = 0; l < lNum; l++)
+		{
+		CSprite* pSprite = temp[l];
+		int32_t lIndex = alCountHi[((uint16_t)pSprite->m_sPriority ^ 0x8000) >> 8]++;
+		sprites[lIndex] = pSprite;
+		pSprite->m_lIndex = lIndex;
+		}
+
+	pLayer->m_bSorted = true;
+	m_lNumSorts++;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Squeeze out the layer's empty slots without changing its order.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::CompactLayer(
+	Layer* pLayer)											// In:  Layer to compact
+	{
+	vSprites& sprites = pLayer->m_sprites;
+
+	int32_t lNum = 0;
+	int32_t lSize = (int32_t)sprites.size();
+	int32_t l;
+	for (l = 0; l < lSize; l++)
+		{
+		CSprite* pSprite = sprites[l];
+		if (pSprite != NULL)
+			{
+			sprites[lNum] = pSprite;
+			pSprite->m_lIndex = lNum;
+			lNum++;
+			}
+		}
+	sprites.resize(lNum);
+	pLayer->m_lNumEmpty = 0;
+	}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Get where a top level sprite should be drawn this frame.  We draw a step
+// behind, so with one step between the sprite's last two positions we go from
+// the previous one toward the latest as the step fraction grows.  If it took
+// several steps to get there (the simulation was catching up), we cover the
+// same time, which is only the last part of the way.  Sprites that jumped
+// farther than anything walks or flies (e.g., warped) are just drawn where
+// they are.
+////////////////////////////////////////////////////////////////////////////////
+void CScene::GetDrawPos(								// Returns nothing.
+	CSprite* pSprite,										// In:  Sprite.
+	int16_t* psX2,											// Out: 2d x coord.
+	int16_t* psY2)											// Out: 2d y coord.
+	{
+	*psX2	= pSprite->m_sX2;
+	*psY2	= pSprite->m_sY2;
+
+	// Only if it was updated at the latest step and hasn't been moved since.
+	if (	m_bInterpolate == true
+		&&	pSprite->m_lStep == m_lStep
+		&&	pSprite->m_lPrevStep != m_lStep
+		&&	pSprite->m_sX2 == pSprite->m_sStepX2
+		&&	pSprite->m_sY2 == pSprite->m_sStepY2)
+		{
+		int32_t	lSteps	= m_lStep - pSprite->m_lPrevStep;
+		int32_t	lDX		= pSprite->m_sStepX2 - pSprite->m_sPrevX2;
+		int32_t	lDY		= pSprite->m_sStepY2 - pSprite->m_sPrevY2;
+		if (	lDX <= INTERPOLATE_MAX_JUMP * lSteps && lDX >= -INTERPOLATE_MAX_JUMP * lSteps
+			&&	lDY <= INTERPOLATE_MAX_JUMP * lSteps && lDY >= -INTERPOLATE_MAX_JUMP * lSteps)
+			{
+			// How far back from the latest position to draw, in 256ths.
+			int32_t	lBack	= (256 - m_sStepFrac) / lSteps;
+			*psX2	= (int16_t)(pSprite->m_sStepX2 - (lDX * lBack) / 256);
+			*psY2	= (int16_t)(pSprite->m_sStepY2 - (lDY * lBack) / 256);
+			}
 		}
 	}
 
@@ -547,9 +768,13 @@ void CScene::RemoveSprite(
 	// such as when someone else has called Clear() or some similar function.
 	if(pSprite->m_sPrivFlags & CSprite::PrivInserted)
 		{
-		// Erase sprite from layer.  Knowing the iterator makes this very fast.
+		// Empty its slot in the layer.  Knowing the index makes this very fast,
+		// and leaves everyone else where they are, so it's safe while the
+		// layer is being drawn.
 		ASSERT(pSprite->m_sSavedLayer < m_sNumLayers);
-		m_pLayers[pSprite->m_sSavedLayer].m_sprites.erase(pSprite->m_iter);
+		m_pLayers[pSprite->m_sSavedLayer].m_sprites[pSprite->m_lIndex] = NULL;
+		m_pLayers[pSprite->m_sSavedLayer].m_lNumEmpty++;
+		m_pLayers[pSprite->m_sSavedLayer].m_bSorted = false;
 
 		// Clear inserted flag
 		pSprite->m_sPrivFlags &= ~CSprite::PrivInserted;
@@ -600,7 +825,8 @@ CScene::Render3D(
 // 0) Clear the Z buffer.
 //	1) Transform the bounding sphere to screen coordinates.
 // 2) Ignore the sprite if the bounding sphere indicates the sprite is entirely
-// offscreen.
+// offscreen (unless some of its children aren't, in which case it's just not
+// drawn).
 // 3) Center the Render() on the bounding sphere to get maximum Z buffer room
 // on X/Z plane.
 // 4) Render into a clip image if the bounding sphere indicates the sprite is
@@ -608,7 +834,8 @@ CScene::Render3D(
 // buffer with clipping.
 //
 // For a non-top level 3D sprite:
-// 1) Combine all parent transforms with this sprite's transform.
+// 1) Use all parent transforms combined with this sprite's transform (see
+// Cull3D(), which must've been called for the tree).
 // 2) Transform the bounding sphere to screen coordinates.
 // 3) Center the Render() on the top-level parent's bounding sphere so it matches 
 // the parents' position(s).
@@ -626,16 +853,10 @@ CScene::Render3D(
 	RAlpha*		plight,			// Light to render with.
 	RRect*		prcDstClip)		// Dst clip rect.
 	{
-	// This transform is the product of the parent and the
-	// child's transform used to determine the position of
-	// a child object absolutely.
-	RTransform	transChildAbs;
 	RTransform*	ptransRender;	// The transform used.
 
 	int16_t		sCurX;
 	int16_t		sCurY;
-	RP3d		pt3dSrcCenter, pt3dSrcRadius;		// Center and point on outside of bounding
-															// sphere in "Randy" coords.
 	int16_t		sClipLeft;			// Amount clipped off left edge of dest region.
 	int16_t		sClipTop;			// Amount clipped off top edge of dest region.
 	int16_t		sClipRight;			// Amount clipped off right edge of dest region.
@@ -664,16 +885,11 @@ CScene::Render3D(
 	ASSERT(ps3Cur->m_ptrans != NULL);
 	ASSERT(ps3Cur->m_psphere != NULL);
 
-	// If there's a parent . . .
-	if (ps3Cur->m_psprParent != NULL)
+	// If there's a 3D parent . . .
+	if (ps3Cur->m_psprParent != NULL && ps3Cur->m_psprParent->m_type == CSprite::Standard3d)
 		{
-		// NOTE: This does NOT work for more than 1 level of child depth.
-		// To make that work, we must put a transform in the CSprite3.
-		// Apply child and parent to transChildAbs.
-		transChildAbs.Mul( ((CSprite3*)ps3Cur->m_psprParent)->m_ptrans->T, ps3Cur->m_ptrans->T);
-
-		// Use transChildAbs.
-		ptransRender	= &transChildAbs;
+		// Use this and all its parents' transforms combined (see Cull3D()).
+		ptransRender	= &ps3Cur->m_transAbs;
 		}
 	else
 		{
@@ -709,19 +925,13 @@ CScene::Render3D(
 	//	|															|
 	//	|____________________________________________|
 
-	// Get the bounding info.
-	// Setup src pts.
-
-	// Get current sphere.
-	pt3dSrcCenter	= *(ps3Cur->m_psphere);
-	pt3dSrcRadius.x	= pt3dSrcCenter.x + pt3dSrcCenter.w;
-	pt3dSrcRadius.y	= pt3dSrcCenter.y + pt3dSrcCenter.w;
-	pt3dSrcRadius.z	= pt3dSrcCenter.z + pt3dSrcCenter.w;
-	pt3dSrcRadius.w	= 1;
-	pt3dSrcCenter.w	= 1;
-
-	// Let the pipeline know of the bounding sphere.
-	m_pipeline.BoundingSphereToScreen(pt3dSrcCenter, pt3dSrcRadius, *ptransRender);
+	// Let the pipeline know of the bounding sphere Cull3D() already put on
+	// the screen.
+	m_pipeline.SetScreenSphere(
+		ps3Cur->m_sScreenCenX,
+		ps3Cur->m_sScreenCenY,
+		ps3Cur->m_sScreenCenZ,
+		ps3Cur->m_sScreenRadius);
 
 	// Check screen location:
 	// Get radius of sphere of points (SphOP).
@@ -748,17 +958,18 @@ if (g_bSceneDontBlit == false)
 	sClipTop		= prcDstClip->sY - (sCenterY - sRadius);
 	sClipRight	= (sCenterX + sRadius) - (prcDstClip->sX + prcDstClip->sW);
 	sClipBottom	= (sCenterY + sRadius) - (prcDstClip->sY + prcDstClip->sH);
-	// If on screen at all . . .
-	if (sClipLeft < sDiameter && sClipTop < sDiameter && sClipRight < sDiameter && sClipBottom < sDiameter)
+	bool	bOnScreen	= (sClipLeft < sDiameter && sClipTop < sDiameter && sClipRight < sDiameter && sClipBottom < sDiameter);
+	// If on screen at all (or has children that are, since they're placed
+	// where this is rendered) . . .
+	if (bOnScreen == true || (ps3Cur->m_psprHeadChild != NULL && ps3Cur->m_bTreeOnScreen == true) )
 		{
-		// Transform pts through *ptransRender, view, and finally screen transforms.
-		m_pipeline.Transform(
-			ps3Cur->m_psop,		// Sea of 3D points to form
-										// mesh around.
-			*ptransRender);		// The transformation.
+		// Sprites that don't share the Z buffer with any others (no parent and
+		// no children) can come from the render cache and clear the Z buffer
+		// only if they actually get rendered (below).
+		bool	bAlone	= (ps3Cur->m_psprParent == NULL && ps3Cur->m_psprHeadChild == NULL);
 
-		// If there's no parent . . .
-		if (ps3Cur->m_psprParent == NULL)
+		// If there's no parent but there are children . . .
+		if (ps3Cur->m_psprParent == NULL && bAlone == false)
 			{
 			// Clear Z buffer for new 3D tree.
 			m_pipeline.m_pZB->Clear();
@@ -861,132 +1072,247 @@ if (g_bSceneDontBlit == false)
 		// we do a += (see above (search for sLightOffset) ).
 		sLightOffset += ps3Cur->m_sBrightness + gsGlobalLightingAdjustment - sDirectRenderZ;
 
+		// No overdraw unless we actually render it below.
+		ps3Cur->m_lPixelsTested		= 0;
+		ps3Cur->m_lPixelsWritten	= 0;
+		ps3Cur->m_lTrisHidden		= 0;
+
+		// If only here to set things up for the children . . .
+		if (bOnScreen == false)
+			{
+			// Nothing to draw.
+			}
 		// Make sure we don't overrun the Z buffer . . .
 		// Note that m_pipeline.m_sCen? are in image coords (i.e., (0, 0) is
 		// the upper, left hand corner and (SCREEN_DIAMETER_FOR_3D, 
 		// SCREEN_DIAMETER_FOR_3D) is the lower, right hand corner).
-		if (	m_pipeline.m_sCenX - sRadius >= -sRenderOffX
+		else if (	m_pipeline.m_sCenX - sRadius >= -sRenderOffX
 			&&	m_pipeline.m_sCenX + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffX
 			&&	m_pipeline.m_sCenY - sRadius >= -sRenderOffY
 			&&	m_pipeline.m_sCenY + sRadius < SCREEN_DIAMETER_FOR_3D - sRenderOffY)
 			{
-			// If fog enabled . . .
-			if (g_GameSettings.m_s3dFog != FALSE)
-				{
-				// Render with textures and fog.
-				m_pipeline.Render(
-					pimRender,						// Dst image.
-					sRenderX,						// 2D Dst coord.
-					sRenderY,						// 2D Dst coord.
-					ps3Cur->m_pmesh,				// Src mesh.
-					m_pipeline.m_pZB,				// Z buffer (use its own for now).
-					ps3Cur->m_ptex,				// Textures.
-					sLightOffset,					// Fog offset.  Fogool?
-					plight,							// Ambient lighting schtuff.
-					sRenderOffX,					// Offset render/z-buffer to center of sphere of points.
-					sRenderOffY);					// Offset render/z-buffer to center of sphere of points.
-				}
-			else
+			RImage*	pimCached	= NULL;
+			bool		bStore		= false;
+			REAL		fSopBlend	= ps3Cur->m_fSopBlend;
+			// If this one might be in the cache . . .
+			if (bAlone == true && m_rendercache.IsOn() == true)
 				{
-				// Render with textures, no fog.
-				m_pipeline.Render(
-					pimRender,						// Dst image.
-					sRenderX,						// 2D Dst coord.
-					sRenderY,						// 2D Dst coord.
-					ps3Cur->m_pmesh,				// Src mesh.
-					m_pipeline.m_pZB,				// Z buffer (use its own for now).
-					ps3Cur->m_ptex,				// Textures.
-					sRenderOffX,					// Offset render/z-buffer to center of sphere of points.
-					sRenderOffY);					// Offset render/z-buffer to center of sphere of points.
+				// Round the blend so in-between poses come up again.
+				if (ps3Cur->m_psopNext != NULL)
+					fSopBlend	= CRenderCache::QuantizeBlend(fSopBlend);
+
+				CRenderCache::Key	key;
+				CRenderCache::Clear(&key);
+				key.psop				= ps3Cur->m_psop;
+				key.psopNext		= ps3Cur->m_psopNext;
+				key.fSopBlend		= fSopBlend;
+				key.pmesh			= ps3Cur->m_pmesh;
+				key.ptex				= ps3Cur->m_ptex;
+				key.plight			= plight;
+				memcpy(key.aT, ptransRender->T, sizeof(key.aT) );
+				key.sphere			= *(ps3Cur->m_psphere);
+				key.sLightOffset	= sLightOffset;
+				key.sFog				= g_GameSettings.m_s3dFog;
+
+				pimCached	= m_rendercache.Find(
+					&key,
+					(ps3Cur->m_sInFlags & CSprite::InImpostor) != 0,
+					&bStore);
 				}
 
-			// If we rendered into an intermediate buffer b/c of clipping . . .
-			if (bIndirectRender == true)
+			// If it's already been drawn this way . . .
+			if (pimCached != NULL)
 				{
-				// Get it into destination.
-				rspBlitT(
-					0,																// Transparent index.
-					pimRender,													// Src.
-					pimDst,														// Dst.
-					m_pipeline.m_sCenX - sRadius + sRenderOffX,	// Src.
-					m_pipeline.m_sCenY - sRadius + sRenderOffY,	// Src.
-					sBlitX,														// Dst.
-					sBlitY,														// Dst.
-					m_pipeline.m_sW,											// Both.
-					m_pipeline.m_sH,											// Both.
-					prcDstClip,													// Dst.
-					NULL);														// Src.
-
-				m_pipeline.ClearClipBuffer();
+				// Determine which BLiT to use based on image type
+				if (pimCached->m_type == RImage::FSPR8)
+					{
+					rspBlit(pimCached, pimDst, sBlitX, sBlitY, prcDstClip);
+					}
+				else
+					{
+					rspBlitT(
+						0,								// Transparent index.
+						pimCached,					// Src.
+						pimDst,						// Dst.
+						0,								// Src.
+						0,								// Src.
+						sBlitX,						// Dst.
+						sBlitY,						// Dst.
+						pimCached->m_sWidth,		// Both.
+						pimCached->m_sHeight,	// Both.
+						prcDstClip,					// Dst.
+						NULL);						// Src.
+					}
 				}
 			else
 				{
-				// Already in pimDst.
-				}
+				// If it's going in the cache, it has to be rendered on its own.
+				if (bStore == true && bIndirectRender == false)
+					{
+					ASSERT(m_pipeline.m_pimClipBuf != NULL);
+					pimRender			= m_pipeline.m_pimClipBuf;
+					bIndirectRender	= true;
+					sRenderX				= sIndirectRenderX;
+					sRenderY				= sIndirectRenderY;
+					}
+
+				// Transform pts through *ptransRender, view, and finally screen transforms.
+				m_pipeline.Transform(
+					ps3Cur->m_psop,		// Sea of 3D points to form
+												// mesh around.
+					*ptransRender,			// The transformation.
+					ps3Cur->m_psopNext,	// Sea of 3D points to blend toward.
+					fSopBlend);				// How far to blend.
+
+				// If this is a 3D tree all by itself . . .
+				if (bAlone == true)
+					{
+					// Clear Z buffer for it.
+					m_pipeline.m_pZB->Clear();
+					}
+
+				// Note the Z buffer's counts so we can tell what this sprite adds.
+				int32_t	lPixelsTested	= m_pipeline.m_pZB->m_lPixelsTested;
+				int32_t	lPixelsWritten	= m_pipeline.m_pZB->m_lPixelsWritten;
+				int32_t	lTrisHidden		= m_pipeline.m_pZB->m_lTrisHidden;
+
+				// If fog enabled . . .
+				if (g_GameSettings.m_s3dFog != FALSE)
+					{
+					// Render with textures and fog.
+					m_pipeline.Render(
+						pimRender,						// Dst image.
+						sRenderX,						// 2D Dst coord.
+						sRenderY,						// 2D Dst coord.
+						ps3Cur->m_pmesh,				// Src mesh.
+						m_pipeline.m_pZB,				// Z buffer (use its own for now).
+						ps3Cur->m_ptex,				// Textures.
+						sLightOffset,					// Fog offset.  Fogool?
+						plight,							// Ambient lighting schtuff.
+						sRenderOffX,					// Offset render/z-buffer to center of sphere of points.
+						sRenderOffY);					// Offset render/z-buffer to center of sphere of points.
+					}
+				else
+					{
+					// Render with textures, no fog.
+					m_pipeline.Render(
+						pimRender,						// Dst image.
+						sRenderX,						// 2D Dst coord.
+						sRenderY,						// 2D Dst coord.
+						ps3Cur->m_pmesh,				// Src mesh.
+						m_pipeline.m_pZB,				// Z buffer (use its own for now).
+						ps3Cur->m_ptex,				// Textures.
+						sRenderOffX,					// Offset render/z-buffer to center of sphere of points.
+						sRenderOffY);					// Offset render/z-buffer to center of sphere of points.
+					}
+
+				// Store this sprite's overdraw and add it to the scene's.
+				ps3Cur->m_lPixelsTested		= m_pipeline.m_pZB->m_lPixelsTested - lPixelsTested;
+				ps3Cur->m_lPixelsWritten	= m_pipeline.m_pZB->m_lPixelsWritten - lPixelsWritten;
+				ps3Cur->m_lTrisHidden		= m_pipeline.m_pZB->m_lTrisHidden - lTrisHidden;
+				m_lPixelsTested	+= ps3Cur->m_lPixelsTested;
+				m_lPixelsWritten	+= ps3Cur->m_lPixelsWritten;
+				m_lTrisHidden		+= ps3Cur->m_lTrisHidden;
+
+				// If we rendered into an intermediate buffer b/c of clipping . . .
+				if (bIndirectRender == true)
+					{
+					// If it's going in the cache . . .
+					if (bStore == true)
+						{
+						m_rendercache.Store(
+							pimRender,
+							m_pipeline.m_sCenX - sRadius + sRenderOffX,
+							m_pipeline.m_sCenY - sRadius + sRenderOffY,
+							m_pipeline.m_sW,
+							m_pipeline.m_sH);
+						}
+
+					// Get it into destination.
+					rspBlitT(
+						0,																// Transparent index.
+						pimRender,													// Src.
+						pimDst,														// Dst.
+						m_pipeline.m_sCenX - sRadius + sRenderOffX,	// Src.
+						m_pipeline.m_sCenY - sRadius + sRenderOffY,	// Src.
+						sBlitX,														// Dst.
+						sBlitY,														// Dst.
+						m_pipeline.m_sW,											// Both.
+						m_pipeline.m_sH,											// Both.
+						prcDstClip,													// Dst.
+						NULL);														// Src.
+
+					m_pipeline.ClearClipBuffer();
+					}
+				else
+					{
+					// Already in pimDst.
+					}
 #if 0	// Set to 1 to see origin target, center of points X, 
 		// rect for bounding cube, and rect for clip image.
-			// Draw bounds.
-			rspRect(
-				1, 
-				RSP_WHITE_INDEX,
-				pimDst,
-				sCenterX - sRadius,
-				sCenterY - sRadius,
-				sDiameter, 
-				sDiameter,
-				prcDstClip);
-
-			// Draw target at hotspot on screen.
-			#define HOTSPOT_TARGET_LENGTH		5
-			rspLine(
-				RSP_WHITE_INDEX, 
-				pimDst, 
-				sCurX - HOTSPOT_TARGET_LENGTH / 2, 
-				sCurY, 
-				sCurX + HOTSPOT_TARGET_LENGTH / 2 + 1, 
-				sCurY);
+				// Draw bounds.
+				rspRect(
+					1, 
+					RSP_WHITE_INDEX,
+					pimDst,
+					sCenterX - sRadius,
+					sCenterY - sRadius,
+					sDiameter, 
+					sDiameter,
+					prcDstClip);
+
+				// Draw target at hotspot on screen.
+				#define HOTSPOT_TARGET_LENGTH		5
+				rspLine(
+					RSP_WHITE_INDEX, 
+					pimDst, 
+					sCurX - HOTSPOT_TARGET_LENGTH / 2, 
+					sCurY, 
+					sCurX + HOTSPOT_TARGET_LENGTH / 2 + 1, 
+					sCurY);
 //				prcDstClip);
-			rspLine(RSP_WHITE_INDEX, 
-				pimDst, 
-				sCurX, 
-				sCurY - HOTSPOT_TARGET_LENGTH / 2, 
-				sCurX, 
-				sCurY + HOTSPOT_TARGET_LENGTH / 2 + 1);
+				rspLine(RSP_WHITE_INDEX, 
+					pimDst, 
+					sCurX, 
+					sCurY - HOTSPOT_TARGET_LENGTH / 2, 
+					sCurX, 
+					sCurY + HOTSPOT_TARGET_LENGTH / 2 + 1);
 //				prcDstClip);
 
-			// Draw origin with X.
-			#define ORIGIN_TARGET_LENGTH	6
-			rspLine(
-				251/*Yellow*/, 
-				pimDst, 
-				sCenterX - ORIGIN_TARGET_LENGTH / 2, 
-				sCenterY - ORIGIN_TARGET_LENGTH / 2,
-				sCenterX + ORIGIN_TARGET_LENGTH / 2 + 1, 
-				sCenterY + ORIGIN_TARGET_LENGTH / 2 + 1);
+				// Draw origin with X.
+				#define ORIGIN_TARGET_LENGTH	6
+				rspLine(
+					251/*Yellow*/, 
+					pimDst, 
+					sCenterX - ORIGIN_TARGET_LENGTH / 2, 
+					sCenterY - ORIGIN_TARGET_LENGTH / 2,
+					sCenterX + ORIGIN_TARGET_LENGTH / 2 + 1, 
+					sCenterY + ORIGIN_TARGET_LENGTH / 2 + 1);
 //				prcDstClip);
-			rspLine(
-				251/*Yellow*/, 
-				pimDst, 
-				sCenterX + ORIGIN_TARGET_LENGTH / 2, 
-				sCenterY - ORIGIN_TARGET_LENGTH / 2,
-				sCenterX - ORIGIN_TARGET_LENGTH / 2 - 1, 
-				sCenterY + ORIGIN_TARGET_LENGTH / 2 + 1);
+				rspLine(
+					251/*Yellow*/, 
+					pimDst, 
+					sCenterX + ORIGIN_TARGET_LENGTH / 2, 
+					sCenterY - ORIGIN_TARGET_LENGTH / 2,
+					sCenterX - ORIGIN_TARGET_LENGTH / 2 - 1, 
+					sCenterY + ORIGIN_TARGET_LENGTH / 2 + 1);
 //				prcDstClip);
 
-			// Draw image.
-			rspRect(1, RSP_WHITE_INDEX, pimDst, 
-				sCenterX - (short)(SCREEN_DIAMETER_FOR_3D / 2), 
-				sCenterY - (short)(SCREEN_DIAMETER_FOR_3D / 2), 
-				m_pipeline.m_pimClipBuf->m_sWidth, 
-				m_pipeline.m_pimClipBuf->m_sHeight,
-				prcDstClip);
+				// Draw image.
+				rspRect(1, RSP_WHITE_INDEX, pimDst, 
+					sCenterX - (short)(SCREEN_DIAMETER_FOR_3D / 2), 
+					sCenterY - (short)(SCREEN_DIAMETER_FOR_3D / 2), 
+					m_pipeline.m_pimClipBuf->m_sWidth, 
+					m_pipeline.m_pimClipBuf->m_sHeight,
+					prcDstClip);
 
-			// Note whether clipping.
-			if (bIndirectRender == true)
-				{
-				rspLine(251/*Yellow*/, pimDst, sCenterX, sCenterY, 1, 1);
-				}
+				// Note whether clipping.
+				if (bIndirectRender == true)
+					{
+					rspLine(251/*Yellow*/, pimDst, sCenterX, sCenterY, 1, 1);
+					}
 #endif
+				}
 			}
 		else
 			{
@@ -1030,6 +1356,95 @@ if (g_bSceneDontBlit == false)
 	ps3Cur->m_sRadius	= sRadius;
 	}
 
+////////////////////////////////////////////////////////////////////////////////
+// Get the absolute transform of every 3D sprite in a 3D tree and find out
+// which parts of the tree are on screen.
+//
+// Each child's m_transAbs is its parent's absolute transform times its own,
+// so this works for any depth of children.  A sprite is on screen if its
+// bounding sphere is, by the same test Render3D() uses, and a tree is if any
+// of its sprites are.  Trees that aren't needn't be Render3D()'d at all, so
+// this also sets the collision circle Render3D() would have.
+//
+////////////////////////////////////////////////////////////////////////////////
+bool									// Returns true if any of the tree is on screen.
+CScene::Cull3D(
+	int16_t			sDstX,			// Destination 2D x coord.
+	int16_t			sDstY,			// Destination 2D y coord.
+	CSprite3*	ps3Cur,			// Top of 3D tree (or subtree).
+	RTransform*	ptransParent,	// Parent's absolute transform or NULL if top.
+	RRect*		prcDstClip)		// Dst clip rect.
+	{
+	ASSERT(ps3Cur->m_ptrans != NULL);
+	ASSERT(ps3Cur->m_psphere != NULL);
+
+	RTransform*	ptransAbs	= ps3Cur->m_ptrans;
+	// If there's a 3D parent . . .
+	if (ptransParent != NULL)
+		{
+		ps3Cur->m_transAbs.Mul(ptransParent->T, ps3Cur->m_ptrans->T);
+		ptransAbs	= &ps3Cur->m_transAbs;
+		}
+
+	// Get the bounding sphere on screen just as Render3D() does.
+	RP3d	pt3dSrcCenter	= *(ps3Cur->m_psphere);
+	RP3d	pt3dSrcRadius;
+	pt3dSrcRadius.x	= pt3dSrcCenter.x + pt3dSrcCenter.w;
+	pt3dSrcRadius.y	= pt3dSrcCenter.y + pt3dSrcCenter.w;
+	pt3dSrcRadius.z	= pt3dSrcCenter.z + pt3dSrcCenter.w;
+	pt3dSrcRadius.w	= 1;
+	pt3dSrcCenter.w	= 1;
+
+	m_pipeline.BoundingSphereToScreen(pt3dSrcCenter, pt3dSrcRadius, *ptransAbs);
+
+	// Keep it so Render3D() needn't do it again.
+	ps3Cur->m_sScreenCenX	= m_pipeline.m_sCenX;
+	ps3Cur->m_sScreenCenY	= m_pipeline.m_sCenY;
+	ps3Cur->m_sScreenCenZ	= m_pipeline.m_sCenZ;
+	ps3Cur->m_sScreenRadius	= m_pipeline.m_sW / 2;
+
+	int16_t	sDiameter	= MAX(m_pipeline.m_sW, m_pipeline.m_sH);
+	int16_t	sRadius		= sDiameter / 2;
+
+	int16_t	sCenterX		= ps3Cur->m_sX2 + sDstX + (m_pipeline.m_sCenX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2));
+	int16_t	sCenterY		= ps3Cur->m_sY2 + sDstY + (m_pipeline.m_sCenY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2));
+	int16_t	sClipLeft	= prcDstClip->sX - (sCenterX - sRadius);
+	int16_t	sClipTop		= prcDstClip->sY - (sCenterY - sRadius);
+	int16_t	sClipRight	= (sCenterX + sRadius) - (prcDstClip->sX + prcDstClip->sW);
+	int16_t	sClipBottom	= (sCenterY + sRadius) - (prcDstClip->sY + prcDstClip->sH);
+
+	bool	bTreeOnScreen	= (sClipLeft < sDiameter && sClipTop < sDiameter && sClipRight < sDiameter && sClipBottom < sDiameter);
+
+	// Store the collision circle (see Render3D()).
+	ps3Cur->m_sCenX	= ps3Cur->m_sX2 + m_pipeline.m_sCenX - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
+	ps3Cur->m_sCenY	= ps3Cur->m_sY2 + m_pipeline.m_sCenY - (int16_t)(SCREEN_DIAMETER_FOR_3D / 2);
+	ps3Cur->m_sRadius	= sRadius;
+
+	// Do all the 3D children that'll be rendered . . .
+	CSprite*	psprite	= ps3Cur->m_psprHeadChild;
+	while (psprite != NULL)
+		{
+		if (psprite->m_type == CSprite::Standard3d && !(psprite->m_sInFlags & CSprite::InHidden))
+			{
+			if (Cull3D(
+				sDstX + ps3Cur->m_sX2,
+				sDstY + ps3Cur->m_sY2,
+				(CSprite3*)psprite,
+				ptransAbs,
+				prcDstClip) == true)
+				{
+				bTreeOnScreen	= true;
+				}
+			}
+
+		psprite	= psprite->m_psprNext;
+		}
+
+	ps3Cur->m_bTreeOnScreen	= bTreeOnScreen;
+
+	return bTreeOnScreen;
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Line function until we have one that can clip to other than the dest image.
 ////////////////////////////////////////////////////////////////////////////////
@@ -1515,15 +1930,29 @@ void CScene::Render(			// Returns nothing.
 					}
 
 				case CSprite::Standard3d:	// *** g_bSceneDontBlit is checked inside Render3D() 10/03/99 ***
-					Render3D(					// Returns happy thoughts.
-						pimDst,					// Destination image.
-						sDstX,					// Destination 2D x coord.
-						sDstY,					// Destination 2D y coord.
-						(CSprite3*)pSprite,	// Tree of 3D sprites to render.
-						phood,					// Da hood, homey.
-						prcDstClip);			// Dst clip rect.
+					{
+					CSprite3*	ps3	= (CSprite3*)pSprite;
+					// If this is the top of a 3D tree . . .
+					if (ps3->m_psprParent == NULL || ps3->m_psprParent->m_type != CSprite::Standard3d)
+						{
+						// Get the whole tree's transforms and see what's on screen.
+						Cull3D(sDstX, sDstY, ps3, NULL, prcDstClip);
+						}
+
+					// If it or any of its 3D children are on screen . . .
+					if (ps3->m_bTreeOnScreen == true)
+						{
+						Render3D(					// Returns happy thoughts.
+							pimDst,					// Destination image.
+							sDstX,					// Destination 2D x coord.
+							sDstY,					// Destination 2D y coord.
+							ps3,						// Tree of 3D sprites to render.
+							phood,					// Da hood, homey.
+							prcDstClip);			// Dst clip rect.
+						}
 
 					break;	// CSprite::Standard3d.
+					}
 
 				case CSprite::Line2d:
 					{
@@ -1649,6 +2078,17 @@ void CScene::Render(
 
 	CSprite*	psprXRayee	= NULL;	// XRayee when not NULL.
 
+	// Start the overdraw counts over so they're for this render only.
+	m_lPixelsTested	= 0;
+	m_lPixelsWritten	= 0;
+	m_lTrisHidden		= 0;
+	if (m_pipeline.m_pZB != NULL)
+		{
+		m_pipeline.m_pZB->m_lPixelsTested	= 0;
+		m_pipeline.m_pZB->m_lPixelsWritten	= 0;
+		m_pipeline.m_pZB->m_lTrisHidden		= 0;
+		}
+
 	// Go through all the layers, back to front
 	for (int16_t sLayer = 0; sLayer < m_sNumLayers; sLayer++)
 		{
@@ -1659,11 +2099,28 @@ void CScene::Render(
 		if (!(pLayer->m_bHidden))
 			{
 
-			// Go through all the sprites stored in this layer
-			for (msetSprites::iterator iSprite = pLayer->m_sprites.begin(); iSprite != pLayer->m_sprites.end(); )
+			// Put the sprites in order if anything has changed.
+			if (pLayer->m_bSorted == false)
+				{
+				rspStartProfile("Scene Sort");
+				SortLayer(pLayer);
+				rspEndProfile("Scene Sort");
+				}
+
+			// Go through all the sprites stored in this layer.  Sprites may be
+			// removed along the way, but not added, so indexing stays valid.
+			int32_t lNumSprites = (int32_t)pLayer->m_sprites.size();
+			for (int32_t lSprite = 0; lSprite < lNumSprites; lSprite++)
 				{
-				// Get pointer to sprite (more readable than iterator dereference and may optimize better)
-				CSprite* pSprite = *iSprite;
+				CSprite* pSprite = pLayer->m_sprites[lSprite];
+				if (pSprite == NULL)
+					continue;
+
+				// Temporarily move it to where it's drawn this frame, if interpolating.
+				int16_t	sX2	= pSprite->m_sX2;
+				int16_t	sY2	= pSprite->m_sY2;
+				if (m_bInterpolate == true)
+					GetDrawPos(pSprite, &pSprite->m_sX2, &pSprite->m_sY2);
 
 				Render(				// Returns nothing.
 					pimDst,			// Destination image.
@@ -1674,8 +2131,8 @@ void CScene::Render(
 					&rDstClip,		// Dst clip rect.
 					psprXRayee);	// XRayee, if not NULL.
 
-				// Move to next item before deleting this one.
-				iSprite++;
+				pSprite->m_sX2	= sX2;
+				pSprite->m_sY2	= sY2;
 
 				// If this sprite wanted to be deleted after use . . .
 				if (pSprite->m_sInFlags & CSprite::InDeleteOnRender)
@@ -1741,6 +2198,8 @@ void CScene::SetupPipeline(						// Returns nothing.
 	// Re-init (Renit) the pipeline.
 	m_pipeline.m_tView.Make1();	// Identity.
 	m_pipeline.m_tScreen.Make1();	// Identity.
+	// Anything cached was drawn through the old ones.
+	m_rendercache.Flush();
 	m_transNoZView.Make1();			// Identity.
 	m_transNoZScreen.Make1();		// Identity.
 
@@ -1937,6 +2396,13 @@ void CScene::DeadRender3D(					// Returns nothing.
 			rcClip.sH	= pimDst->m_sHeight;
 			}
 
+		// If this is the top of a 3D tree . . .
+		if (ps3->m_psprParent == NULL || ps3->m_psprParent->m_type != CSprite::Standard3d)
+			{
+			// Get the whole tree's transforms.
+			Cull3D(sDstX, sDstY, ps3, NULL, prcDstClip);
+			}
+
 #if 1
 		// Render.
 		Render3D(
@@ -179,6 +179,7 @@
 #include "RSPiX.h"
 #include "hood.h"
 #include "sprites.h"
+#include "RenderCache.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -199,14 +200,29 @@ extern	bool	g_bSceneDontBlit;
 
 // Define a layer, which is a sorted collection of sprites (this must be
 // a class so that the member object's constructor gets called!)
+//
+// The sprites are kept in a flat array that is only put in order when the
+// layer is drawn.  A sprite that is added or changes priority has its slot
+// emptied (set to NULL) and goes on the end, so a stable sort by priority
+// leaves sprites with the same priority in the order they were last added or
+// changed, the same as a multiset would.
+//
+// Empty slots are squeezed out when the layer is sorted, or when a sprite is
+// appended and half the slots are empty, so layers that aren't drawn (hidden
+// ones) don't keep growing.
 class Layer
 	{
 	public:
-		msetSprites m_sprites;							// Sprites in this layer
+		vSprites m_sprites;								// Sprites in this layer (may contain NULLs)
+		vSprites m_spritesSort;							// Scratch space for sorting
+		int32_t m_lNumEmpty;								// Number of NULLs in m_sprites
+		bool m_bSorted;									// Whether m_sprites is in draw order
 		bool m_bHidden;									// Whether this layer is hidden
 
 	Layer()
 		{
+		m_lNumEmpty = 0;
+		m_bSorted = true;
 		m_bHidden = false;
 		}
 
@@ -258,6 +274,38 @@ class CScene
 		// can scale 3D objects differently on a per realm basis.
 		double		m_dScale3d;
 
+		// Fixed step interpolation.  When m_bInterpolate is set, top level sprites
+		// are drawn partway between where they were at their last two simulation
+		// steps, a step behind where they are now, so motion stays smooth when
+		// frames are drawn more often than the simulation steps.  Whoever runs
+		// the simulation must call StepTaken() once per step and
+		// SetStepFraction() before each frame is drawn.
+		bool			m_bInterpolate;	// true to interpolate.
+		int32_t		m_lStep;				// Number of steps taken.
+		int16_t		m_sStepFrac;		// How far into the next step we are, in 256ths.
+
+		// Number of times UpdateSprite() has had to move a sprite to the end
+		// of a layer and number of times a layer has been sorted (for
+		// profiling).
+		int32_t		m_lNumResorts;
+		int32_t		m_lNumSorts;
+
+		// Totals of the 3D sprites' overdraw counts (see CSprite3) for the
+		// last Render() of an area (for profiling).
+		int32_t		m_lPixelsTested;
+		int32_t		m_lPixelsWritten;
+		int32_t		m_lTrisHidden;
+
+		// Images of 3D sprites that don't share a Z buffer with any others,
+		// so ones drawn the same way again can just be blitted.  Off until
+		// someone sets its budget.  Flushed by SetupPipeline() and Clear().
+		CRenderCache	m_rendercache;
+
+		// When true, things that allow it are drawn facing one of a few fixed
+		// directions and flagged CSprite::InImpostor, so Render3D() bakes them
+		// into the render cache the first time rather than the second.
+		bool			m_bImpostors;
+
 	//---------------------------------------------------------------------------
 	// Functions
 	//---------------------------------------------------------------------------
@@ -282,6 +330,25 @@ class CScene
 		void SetLayers(											// Returns 0 if successfull, non-zero otherwise
 			int16_t sNumLayers);									// In:  Number of layers
 
+		// Note that the simulation has taken another step.
+		void StepTaken(void)
+			{
+			m_lStep++;
+			}
+
+		// Set how far into the next step we are, in 256ths of a step.
+		void SetStepFraction(
+			int16_t sStepFrac)									// In:  0 to 255.
+			{
+			m_sStepFrac	= sStepFrac;
+			}
+
+		// Get where a top level sprite should be drawn this frame.
+		void GetDrawPos(										// Returns nothing.
+			CSprite* pSprite,										// In:  Sprite.
+			int16_t* psX2,											// Out: 2d x coord.
+			int16_t* psY2);										// Out: 2d y coord.
+
 		// Update existing sprite or add new sprite
 		void UpdateSprite(
 			CSprite* pSprite);									// In:  Sprite to add
@@ -290,6 +357,21 @@ class CScene
 		void RemoveSprite(
 			CSprite* pSprite);									// In:  Sprite to remove
 
+	protected:
+		// Add sprite to the end of its layer, emptying its old slot (if any).
+		void AppendSprite(
+			CSprite* pSprite);									// In:  Sprite to append
+
+		// Put the layer's sprites in draw order and squeeze out empty slots.
+		void SortLayer(
+			Layer* pLayer);										// In:  Layer to sort
+
+		// Squeeze out the layer's empty slots without changing its order.
+		void CompactLayer(
+			Layer* pLayer);										// In:  Layer to compact
+
+	public:
+
 		// Render specified area of scene into specified image
 		void Render(
 			int16_t sSrcX,											// In:  Source (scene) x coord
@@ -338,6 +420,7 @@ class CScene
 			CHood*					phood,			// Da hood, homey.
 			RRect*					prcDstClip);	// Dst clip rect.
 
+		// Cull3D() must've been called for ps3Cur's tree first.
 		void									// Returns nothing.
 		Render3D(
 			RImage*		pimDst,			// Destination image.
@@ -357,6 +440,16 @@ class CScene
 			CHood*		phood,			// Da hood, homey.
 			RRect*		prcDstClip);	// Dst clip rect.
 
+		// Get the absolute transform of every 3D sprite in a 3D tree, however
+		// deep, and find out which parts of the tree are on screen (see
+		// CSprite3::m_bTreeOnScreen) before any of it is Render3D()'d.
+		bool Cull3D(							// Returns true if any of the tree is on screen.
+			int16_t			sDstX,			// Destination 2D x coord.
+			int16_t			sDstY,			// Destination 2D y coord.
+			CSprite3*	ps3Cur,			// Top of 3D tree (or subtree).
+			RTransform*	ptransParent,	// Parent's absolute transform or NULL if top.
+			RRect*		prcDstClip);	// Dst clip rect.
+
 		// Setup render pipeline.  Use this function to setup or alter the pipeline.
 		// This function DOES a Make1() and then multiplies by the supplied transform,
 		// if any.  Any transforms that need to be applied after this setup can be
@@ -645,7 +645,7 @@ void CSentry::Update(void)
 				lSqDistanceToDude = CDoofus::SQDistanceToDude();
 
 				if (bShootThisTime && 
-				    m_idDude != CIdBank::IdNil && 
+				    m_hDude != CIdBank::HandleNil && 
 				    lSqDistanceToDude < m_lSqDistRange &&
 					 lThisTime > m_lTimer &&
 					 m_sNumRounds > 0)
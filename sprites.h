@@ -62,36 +62,15 @@
 // NOTE: While I wanted this to be within the CScene namespace, putting it there
 // created a circular dependancy between CScene and CSprite since they both
 // needed to use this.  It's now at global scope, which I hate, but it works.
-// Define a container of sprites.  A multiset allows for duplicates keys, which
-// is necessary because our sorting function might think of two sprites as being
-// the "same" as far as sorting goes.
+// Define a container of sprites.  Each layer keeps its sprites in one of
+// these and sorts it by priority when it's drawn (see CScene::SortLayer()).
 class CSprite;	// Forward declaration
 
 class CThing;	// Another handy forward.
 
-// This is the function object used to sort the set of sprites.
-// It is a template NOT because we want to use it with other types
-// (after all, how many types will have a m_sZ member?!) but because
-// making it a template causes it to be "evaluated" by the compiler
-// AFTER the CSprite class is fully defined!  In other words, it's a
-// trick!
-template <class T>
-	struct SpriteLess : binary_function<T*, T*, bool>
-		{
-		bool operator()(const T* a, const T* b) const
-			{
-			return a->m_sPriority < b->m_sPriority;
-			}
-		};
-
 #if _MSC_VER >= 1020 || __MWERKS__ >= 0x1100
-	#if __MWERKS__ >= 0x1100
-		ITERATOR_TRAITS(const CSprite*);
-	#endif
-	typedef multiset<CSprite*, SpriteLess<CSprite>, allocator<CSprite*> > msetSprites;
 	typedef vector<CSprite*, allocator<CSprite*> > vSprites;
 #else
-	typedef multiset<CSprite*, SpriteLess<CSprite> > msetSprites;
 	typedef vector<CSprite*> vSprites;
 #endif
 
@@ -117,8 +96,11 @@ class CSprite
 															// BLiT'ing/rendering (currently only supported
 															// for 3D objects).
 			InDeleteOnRender	= 0x0040,			// After rendering object, delete it.	
-			InBlitOpaque		= 0x0080				// Blit sprite opaque (currently only supported
+			InBlitOpaque		= 0x0080,			// Blit sprite opaque (currently only supported
 															// for 2D uncompressed, non-alpha objects).
+			InImpostor			= 0x0100				// Bake the first time it's rendered and reuse
+															// that (currently only supported for 3D
+															// objects, see CScene::m_bImpostors).
 			};
 
 		// Define bit usage within "m_sOutFlags"
@@ -159,12 +141,21 @@ class CSprite
 		CSprite*	m_psprNext;			// Next sibling sprite.
 		CSprite*	m_psprParent;		// Parent sprite.
 
+		// Where this sprite was at the last two simulation steps it was
+		// updated in (see CScene::m_bInterpolate).  Maintained by the scene.
+		int16_t	m_sStepX2;			// 2d x coord at latest step.
+		int16_t	m_sStepY2;			// 2d y coord at latest step.
+		int16_t	m_sPrevX2;			// 2d x coord at previous step.
+		int16_t	m_sPrevY2;			// 2d y coord at previous step.
+		int32_t	m_lStep;				// Scene's step count at latest step.
+		int32_t	m_lPrevStep;		// Scene's step count at previous step.
+
 	protected:
 		Type m_type;												// Sprite's type
 		int16_t m_sPrivFlags;										// Sprite's private flags
 		int16_t m_sSavedLayer;										// Sprite's saved layer (used to detect changes)
 		int16_t m_sSavedPriority;									// Sprite's saved priority (used to detect changes)
-		msetSprites::iterator m_iter;							// Sprite's iterator into layer's container
+		int32_t m_lIndex;											// Sprite's index into layer's container
 
 	public:
 		CSprite()
@@ -176,6 +167,13 @@ class CSprite
 			m_sX2		= 0;		// Any sprite's 2D dest x coord.
 			m_sY2		= 0;		// Any sprite's 2D dest y coord.
 
+			m_sStepX2	= 0;
+			m_sStepY2	= 0;
+			m_sPrevX2	= 0;
+			m_sPrevY2	= 0;
+			m_lStep		= 0;
+			m_lPrevStep	= 0;
+
 			m_pszText			= NULL;
 
 			m_psprHeadChild	= NULL;
@@ -344,6 +342,8 @@ class CSprite3 : public CSprite
 			{
 			m_pmesh			= NULL;	// Mesh.                  
 			m_psop			= NULL;	// Sea Of Points.         
+			m_psopNext		= NULL;	// Sea Of Points to blend toward.
+			m_fSopBlend		= 0;		// How far to blend toward m_psopNext.
 			m_ptrans			= NULL;	// Transform.             
 			m_ptex			= NULL;	// Texture.
 			m_psphere		= NULL;	// Bounding sphere.
@@ -362,6 +362,14 @@ class CSprite3 : public CSprite
 												// sphere.                                   
 			m_sRenderOffY			= 0;	// Offset to Render() to account for bounding
 												// sphere.                                   
+			m_bTreeOnScreen		= true;	// This or a 3D child is on screen.
+			m_sScreenCenX			= 0;	// Bounding sphere on screen.
+			m_sScreenCenY			= 0;	// Bounding sphere on screen.
+			m_sScreenCenZ			= 0;	// Bounding sphere on screen.
+			m_sScreenRadius		= 0;	// Bounding sphere on screen.
+			m_lPixelsTested		= 0;	// Overdraw from the last Render3D().
+			m_lPixelsWritten		= 0;	// Overdraw from the last Render3D().
+			m_lTrisHidden			= 0;	// Overdraw from the last Render3D().
 										
 			m_type			= Standard3d;
 			}
@@ -369,6 +377,8 @@ class CSprite3 : public CSprite
 	public:
 		RMesh*		m_pmesh;		// Mesh.
 		RSop*			m_psop;		// Sea Of Points.
+		RSop*			m_psopNext;	// Sea Of Points to blend toward or NULL.
+		REAL			m_fSopBlend;	// How far (0 to 1) to blend toward m_psopNext.
 		RTransform*	m_ptrans;	// Transform.
 		RTexture*	m_ptex;		// Texture.
 		RP3d*			m_psphere;	// Bounding sphere def.
@@ -394,6 +404,24 @@ class CSprite3 : public CSprite
 											// sphere.
 		bool			m_bIndirect;	// Indicates an indirect Render() (into the
 											// clip buffer).
+
+		RTransform	m_transAbs;		// m_ptrans combined with all of its 3D parents'.
+											// Autoset by CScene::Cull3D() for children of
+											// 3D sprites.
+		bool			m_bTreeOnScreen;	// true if this sprite or any of its 3D
+											// children are on screen.  Autoset by
+											// CScene::Cull3D().
+		int16_t		m_sScreenCenX;		// m_psphere through m_transAbs or m_ptrans
+		int16_t		m_sScreenCenY;		// and the scene's pipeline, as
+		int16_t		m_sScreenCenZ;		// RPipeLine::BoundingSphereToScreen() puts
+		int16_t		m_sScreenRadius;	// it.  Autoset by CScene::Cull3D().
+
+		int32_t		m_lPixelsTested;	// Pixels compared against the Z buffer the
+											// last time CScene::Render3D() rendered
+											// this sprite (0 if it wasn't drawn or was
+											// blitted from the cache).
+		int32_t		m_lPixelsWritten;	// How many of those passed.
+		int32_t		m_lTrisHidden;		// Triangles the Z buffer's tiles skipped.
 	};
 
 
@@ -392,6 +392,9 @@ CThing::CThing(
 	// Save realm
 	m_pRealm = pRealm;
 
+	// Messages come out of the realm's pool
+	m_MessageQueue.SetPool(&pRealm->m_msgpool);
+
 	m_everything.m_powner = this;
 	m_everything.m_pnNext = NULL;
 	m_everything.m_pnPrev = NULL;
@@ -408,6 +411,10 @@ CThing::CThing(
 
 	// Clear editor's RHot*.
 	m_phot				= NULL;
+
+	// Hasn't received any broadcasts.
+	m_sCoalescedMsgType		= 0;
+	m_ulCoalescedMsgStamp	= 0;
 	}
 
 
@@ -424,6 +431,62 @@ CThing::~CThing()
 	m_pRealm->m_idbank.Release(m_u16InstanceId);
 	}
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// Get memory for a thing from the heap.
+// (static).
+//
+////////////////////////////////////////////////////////////////////////////////
+// static
+void* CThing::operator new(
+	size_t sizeThing)										// In:  Size of thing
+	{
+	return CThingPool::AllocHeap(sizeThing);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Get memory for a thing from the realm's pool for its class.
+// (static).
+//
+////////////////////////////////////////////////////////////////////////////////
+// static
+void* CThing::operator new(
+	size_t sizeThing,										// In:  Size of thing
+	CRealm* pRealm,										// In:  Realm whose pool to use
+	ClassIDType id)										// In:  Class ID
+	{
+	return pRealm->m_athingpools[id].Alloc(sizeThing);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Return a thing's memory to wherever it came from.
+// (static).
+//
+////////////////////////////////////////////////////////////////////////////////
+// static
+void CThing::operator delete(
+	void* pvThing)											// In:  Thing's memory
+	{
+	CThingPool::Free(pvThing);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Return a thing's memory if its constructor throws.
+// (static).
+//
+////////////////////////////////////////////////////////////////////////////////
+// static
+void CThing::operator delete(
+	void* pvThing,											// In:  Thing's memory
+	CRealm* pRealm,										// In:  Realm whose pool was used
+	ClassIDType id)										// In:  Class ID
+	{
+	CThingPool::Free(pvThing);
+	}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Call this for any GUIs besides the standard OK (ID 1) and Cancel (ID 2)
@@ -511,8 +574,9 @@ int16_t CThing::Load(										// Returns 0 if successfull, non-zero otherwise
 	CThing*	pthing;
 	if (m_pRealm->m_idbank.GetThingByID(&pthing, m_u16InstanceId) != 0)
 		{
-		// Reserve ID.
-		m_pRealm->m_idbank.Take(this, m_u16InstanceId);
+		// Reserve ID.  Things saved without one (IdNil) stay without one.
+		if (m_pRealm->m_idbank.Take(this, m_u16InstanceId) != 0)
+			m_u16InstanceId	= CIdBank::IdNil;
 		}
 	else
 		{
@@ -261,14 +261,13 @@
 
 #ifdef PATHS_IN_INCLUDES
 	#include "ORANGE/Channel/channel.h"
-	#include "ORANGE/CDT/PQueue.h"
 #else
 	#include "channel.h"
-	#include "pqueue.h"
 #endif
 
 #include "game.h"
 #include "message.h"
+#include "MessageQueue.h"
 #include "Anim3D.h"
 #include "SampleMaster.h"
 #include "sprites.h"
@@ -277,6 +276,7 @@
 // Forward declaration of class to avoid recursive depency of include files
 class CRealm;
 class CSmash;
+class CDeferList;
 
 // Template node class for linked lists
 template <class Owner>
@@ -499,8 +499,15 @@ class CThing
 	// Non-static variables
 	//---------------------------------------------------------------------------
 	public:
-		// Prioritized Message queue for Things to use to communicate with each other
-		RPQueue <GameMessage, int16_t> m_MessageQueue;
+		// Prioritized Message queue for Things to use to communicate with each other.
+		// Messages are stored in the realm's m_msgpool.
+		CMsgQueue m_MessageQueue;
+
+		// Type of the last coalesced broadcast this thing received and the realm
+		// update it was received in (plus 1, so 0 means never).  See
+		// CRealm::SendMessageInRadius().
+		int16_t	m_sCoalescedMsgType;
+		uint32_t	m_ulCoalescedMsgStamp;
 
 		// Pointer to the realm this object belongs to
 		CRealm* m_pRealm;
@@ -557,6 +564,30 @@ class CThing
 		// Destructor (must be virtual so derived class destructors are always called!)
 		virtual ~CThing();
 
+	//---------------------------------------------------------------------------
+	// Allocation.  Plain new gets memory from the heap.  Short lived classes
+	// can instead use new (pRealm, CXxxID) CXxx(pRealm) in their Construct()
+	// to get it from the realm's pool for their class (see ThingPool.h).
+	// Either way, delete returns it to the right place.
+	//---------------------------------------------------------------------------
+	public:
+		static void* operator new(
+			size_t sizeThing);									// In:  Size of thing
+
+		static void* operator new(
+			size_t sizeThing,										// In:  Size of thing
+			CRealm* pRealm,										// In:  Realm whose pool to use
+			ClassIDType id);										// In:  Class ID
+
+		static void operator delete(
+			void* pvThing);										// In:  Thing's memory
+
+		// Only called if the constructor throws.
+		static void operator delete(
+			void* pvThing,											// In:  Thing's memory
+			CRealm* pRealm,										// In:  Realm whose pool was used
+			ClassIDType id);										// In:  Class ID
+
 	//---------------------------------------------------------------------------
 	// CThing-only functions
 	//---------------------------------------------------------------------------
@@ -686,6 +717,25 @@ class CThing
 			{
 			}
 
+		// Advance object's own state ahead of Update().  Only called for classes
+		// in the realm's parallel update table and possibly on another thread,
+		// so this must only change this object's own members and only read
+		// realm state nothing else changes during the phase.  Everything else
+		// (messages, spawning, smash, scene, sound, deleting) either waits for
+		// Update(), which is still called in the usual order, or goes in pdefer,
+		// which the realm applies on the main thread before the main pass.
+		virtual void UpdateParallel(
+			CDeferList*	pdefer)	// In:  Where to put side effects.
+			{
+			}
+
+		// Do something asked for with CDeferList::AddCall().  Always called on
+		// the main thread.
+		virtual void DoDeferred(
+			int32_t	lCode)		// In:  Code passed to AddCall().
+			{
+			}
+
 		// Render object
 		virtual void Render(void)
 			{
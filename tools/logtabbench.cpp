@@ -0,0 +1,477 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// logtabbench.cpp
+// Project: Nostril (aka Postal)
+//
+// Usage:  logtabbench <table.lgk> [<table.lgk> ...]
+//
+// Loads logic tables (e.g., the game's res/logics/*.lgk) and runs each
+// against a few thousand synthetic agent states, once through the compiled
+// CLogTab::Evaluate() and once through a copy of the original cell by cell
+// evaluation.  Any state on which the two set different outputs, or ask for
+// different vars in a different order, is reported as a mismatch (and makes
+// the exit code non-zero).  Then both are timed.
+//
+// The game's vars (aivars.cpp) need a live CPerson, so this makes its own
+// stand-ins from the tables themselves:  every column heading becomes a var,
+// numeric if all its cells are numbers and string-based otherwise, with the
+// strings found in its cells.  A synthetic state gives each var one of the
+// values the tables test it against, or one to either side, so rows actually
+// get matched.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "RSPiX.h"
+#include "logtab.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_TABLES		64			// Most tables on the command line.
+#define MAX_BENCH_VARS	128		// Most distinct vars across all tables.
+#define MAX_STRINGS		64			// Most strings for a string-based var.
+#define MAX_VALUES		64			// Most distinct values a var is tested against.
+#define NUM_STATES		4096		// Synthetic agent states per table.
+#define MIN_BENCH_TIME	(CLOCKS_PER_SEC / 2)	// Time each run at least this long.
+
+////////////////////////////////////////////////////////////////////////////////
+// Types.
+////////////////////////////////////////////////////////////////////////////////
+
+// A synthetic agent.
+typedef struct
+	{
+	int16_t	asIn[MAX_BENCH_VARS];	// Value each var returns.
+	int16_t	asOut[MAX_BENCH_VARS];	// Last value each var was set to or -1.
+	uint32_t	ulGets;						// Hash of which vars were asked, in order.
+	} Agent;
+
+// A var made from a column heading.
+class CBenchVar : public CLogTabVar<Agent*>
+	{
+	public:
+		int16_t	m_sIndex;											// Index into Agent arrays.
+		char*		m_apszStrings[MAX_STRINGS];					// Strings, if string-based.
+		int16_t	m_asValues[MAX_VALUES];							// Values tables test against.
+		int16_t	m_sNumValues;										// Number of m_asValues.
+		bool		m_bNumeric;											// true until a non-number shows up.
+
+	public:
+		CBenchVar(const char* pszName, int16_t sIndex)
+			{
+			m_pszName		= strdup(pszName);
+			m_sIndex			= sIndex;
+			m_sNumValues	= 0;
+			m_bNumeric		= true;
+			m_papszStrings	= m_apszStrings;
+			m_sMaxVal		= 32767;
+			}
+
+		// Note a cell's text (without its operand).
+		void AddText(const char* pszText, bool bOutput)
+			{
+			if (bOutput == true)
+				m_bSettable	= true;
+
+			bool	bDigits	= (*pszText != '\0');
+			for (const char* p = pszText; *p != '\0'; p++)
+				{
+				if (!isdigit(*p))
+					bDigits	= false;
+				}
+
+			if (bDigits == false)
+				{
+				m_bNumeric	= false;
+				int16_t s;
+				for (s = 0; s < m_sNumStrings; s++)
+					{
+					if (rspStricmp((char*)pszText, m_apszStrings[s]) == 0)
+						break;
+					}
+				if (s == m_sNumStrings && m_sNumStrings < MAX_STRINGS)
+					m_apszStrings[m_sNumStrings++]	= strdup(pszText);
+				}
+			}
+
+		// Once all the text is in, stop being numeric if any strings were found.
+		void Finish(void)
+			{
+			if (m_bNumeric == false)
+				m_sMaxVal	= m_sNumStrings - 1;
+			else
+				m_sNumStrings	= 0;
+			}
+
+		// Note a value a table tests against.
+		void AddValue(int16_t sVal)
+			{
+			for (int16_t s = sVal - 1; s <= sVal + 1; s++)
+				{
+				if (s < 0 || s > m_sMaxVal || m_sNumValues >= MAX_VALUES)
+					continue;
+				int16_t i;
+				for (i = 0; i < m_sNumValues; i++)
+					{
+					if (m_asValues[i] == s)
+						break;
+					}
+				if (i == m_sNumValues)
+					m_asValues[m_sNumValues++]	= s;
+				}
+			}
+
+		int16_t GetVal(Agent* pagent)
+			{
+			pagent->ulGets	= pagent->ulGets * 31 + m_sIndex + 1;
+			return pagent->asIn[m_sIndex];
+			}
+
+		void SetVal(Agent* pagent, int16_t sVal)
+			{
+			pagent->asOut[m_sIndex]	= sVal;
+			}
+	};
+
+// A logic table that can also be evaluated the way it was before Compile().
+class CBenchTab : public CLogTab<Agent*>
+	{
+	public:
+		// Get the vars this table uses.
+		int16_t GetNumVars(void)
+			{ return m_sTotalVars; }
+		CBenchVar* GetVar(int16_t sVar)
+			{ return (CBenchVar*)m_apVars[sVar]; }
+
+		// Get a cell.
+		Cell* GetCell(int16_t sRow, int16_t sVar)
+			{ return &m_cellTable[sRow][sVar]; }
+		int16_t GetNumRows(void)
+			{ return m_sRows; }
+
+		// The original Evaluate(), minus logging.
+		void EvaluateOld(Agent* pagent)
+			{
+			int16_t sVals[MaxVars];
+			for (int16_t s = 0; s < m_sInVars; s++)
+				sVals[s] = -1;
+
+			for (int16_t sRow = 0; sRow < m_sRows; sRow++)
+				{
+				bool bCellMatched = true;
+				int16_t sVar;
+				for (sVar = 0; bCellMatched && (sVar < m_sInVars); sVar++)
+					{
+					int16_t sEntry = m_cellTable[sRow][sVar].sEntry;
+					switch(m_cellTable[sRow][sVar].operand)
+						{
+						case Equal:
+							if (sVals[sVar] == -1)
+								sVals[sVar] = m_apVars[sVar]->GetVal(pagent);
+							if (sVals[sVar] != sEntry)
+								bCellMatched = false;
+							break;
+
+						case Not:
+							if (sVals[sVar] == -1)
+								sVals[sVar] = m_apVars[sVar]->GetVal(pagent);
+							if (sVals[sVar] == sEntry)
+								bCellMatched = false;
+							break;
+
+						case Less:
+							if (sVals[sVar] == -1)
+								sVals[sVar] = m_apVars[sVar]->GetVal(pagent);
+							if (sVals[sVar] >= sEntry)
+								bCellMatched = false;
+							break;
+
+						case Greater:
+							if (sVals[sVar] == -1)
+								sVals[sVar] = m_apVars[sVar]->GetVal(pagent);
+							if (sVals[sVar] <= sEntry)
+								bCellMatched = false;
+							break;
+
+						default:
+							break;
+						}
+					}
+
+				if (bCellMatched && (sVar == m_sInVars))
+					{
+					for (sVar = m_sInVars; sVar < m_sTotalVars; sVar++)
+						{
+						if (m_cellTable[sRow][sVar].operand != DontCare)
+							m_apVars[sVar]->SetVal(pagent, m_cellTable[sRow][sVar].sEntry);
+						}
+					break;
+					}
+				}
+			}
+	};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables.
+////////////////////////////////////////////////////////////////////////////////
+
+static CBenchVar*	ms_apvars[MAX_BENCH_VARS];
+static int16_t		ms_sNumVars	= 0;
+
+static Agent		ms_aagents[NUM_STATES];
+
+////////////////////////////////////////////////////////////////////////////////
+// Find or add the var with the specified name.
+////////////////////////////////////////////////////////////////////////////////
+static CBenchVar* GetBenchVar(	// Returns var or NULL if there are too many.
+	const char* pszName)				// In:  Name.
+	{
+	for (int16_t s = 0; s < ms_sNumVars; s++)
+		{
+		if (rspStricmp((char*)pszName, ms_apvars[s]->GetName()) == 0)
+			return ms_apvars[s];
+		}
+
+	if (ms_sNumVars >= MAX_BENCH_VARS)
+		return NULL;
+
+	ms_apvars[ms_sNumVars]	= new CBenchVar(pszName, ms_sNumVars);
+	return ms_apvars[ms_sNumVars++];
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Make vars for the column headings of a table and note the text in its cells.
+////////////////////////////////////////////////////////////////////////////////
+static int16_t ScanTable(		// Returns 0 on success.
+	const char* pszFile)				// In:  Table file.
+	{
+	FILE*	fs	= fopen(pszFile, "rb");
+	if (fs == NULL)
+		{
+		fprintf(stderr, "%s: can't open.\n", pszFile);
+		return 1;
+		}
+
+	CBenchVar*	apvarCols[CLogTab<Agent*>::MaxVars];
+	bool			abOutput[CLogTab<Agent*>::MaxVars];
+	int16_t		sNumCols		= 0;
+	bool			bHeadings	= true;
+	char			szLine[1024];
+	while (fgets(szLine, sizeof(szLine), fs) != NULL)
+		{
+		char*	pszComment	= strstr(szLine, LOGTAB_COMMENT_TOKEN);
+		if (pszComment != NULL)
+			*pszComment	= '\0';
+
+		bool		bOutput	= false;
+		int16_t	sCol		= 0;
+		for (char* pszTok = strtok(szLine, " \t\r\n"); pszTok != NULL; pszTok = strtok(NULL, " \t\r\n") )
+			{
+			if (bHeadings == true)
+				{
+				if (strcmp(pszTok, LOGTAB_OUTPUT_SEPARATOR) == 0)
+					{
+					bOutput	= true;
+					}
+				else if (sNumCols < CLogTab<Agent*>::MaxVars)
+					{
+					apvarCols[sNumCols]	= GetBenchVar(pszTok);
+					if (apvarCols[sNumCols] == NULL)
+						{
+						fprintf(stderr, "%s: too many vars.\n", pszFile);
+						fclose(fs);
+						return 1;
+						}
+					abOutput[sNumCols++]	= bOutput;
+					}
+				}
+			else if (sCol < sNumCols)
+				{
+				// Skip the operand, if any.
+				if (strchr("=!<>*", *pszTok) != NULL)
+					pszTok++;
+				if (*pszTok != '\0')
+					apvarCols[sCol]->AddText(pszTok, abOutput[sCol]);
+				sCol++;
+				}
+			}
+
+		if (sCol > 0 || sNumCols > 0)
+			bHeadings	= false;
+		}
+
+	fclose(fs);
+	return 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Make synthetic agents for a table.
+////////////////////////////////////////////////////////////////////////////////
+static void MakeAgents(			// Returns nothing.
+	CBenchTab* ptab)					// In:  Table.
+	{
+	int16_t	sVar;
+	for (sVar = 0; sVar < ms_sNumVars; sVar++)
+		ms_apvars[sVar]->m_sNumValues	= 0;
+
+	for (int16_t sRow = 0; sRow < ptab->GetNumRows(); sRow++)
+		{
+		for (sVar = 0; sVar < ptab->GetNumVars(); sVar++)
+			{
+			CLogTab<Agent*>::Cell*	pcell	= ptab->GetCell(sRow, sVar);
+			if (pcell->operand != CLogTab<Agent*>::DontCare)
+				ptab->GetVar(sVar)->AddValue(pcell->sEntry);
+			}
+		}
+
+	// Same states every run.
+	srand(1997);
+	for (int32_t l = 0; l < NUM_STATES; l++)
+		{
+		for (sVar = 0; sVar < ms_sNumVars; sVar++)
+			{
+			CBenchVar*	pvar	= ms_apvars[sVar];
+			if (pvar->m_sNumValues > 0)
+				ms_aagents[l].asIn[sVar]	= pvar->m_asValues[rand() % pvar->m_sNumValues];
+			else
+				ms_aagents[l].asIn[sVar]	= 0;
+			}
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reset an agent's outputs.
+////////////////////////////////////////////////////////////////////////////////
+inline void ResetAgent(			// Returns nothing.
+	Agent* pagent)						// In:  Agent.
+	{
+	memset(pagent->asOut, 0xff, sizeof(pagent->asOut) );
+	pagent->ulGets	= 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time evaluating every agent with the compiled or old code.
+////////////////////////////////////////////////////////////////////////////////
+static double TimeTable(		// Returns nanoseconds per evaluation.
+	CBenchTab* ptab,					// In:  Table.
+	bool bOld)							// In:  true for EvaluateOld().
+	{
+	int32_t	lPasses	= 0;
+	clock_t	tStart	= clock();
+	clock_t	tNow;
+	do	{
+		for (int32_t l = 0; l < NUM_STATES; l++)
+			{
+			if (bOld == true)
+				ptab->EvaluateOld(&ms_aagents[l]);
+			else
+				ptab->Evaluate(&ms_aagents[l], false);
+			}
+		lPasses++;
+		tNow	= clock();
+		} while (tNow - tStart < MIN_BENCH_TIME);
+
+	return (double)(tNow - tStart) * 1e9 / CLOCKS_PER_SEC / ((double)lPasses * NUM_STATES);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main.
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+	{
+	if (argc < 2 || argc - 1 > MAX_TABLES)
+		{
+		fprintf(stderr, "Usage: %s <table.lgk> [<table.lgk> ...] (up to %d)\n", argv[0], MAX_TABLES);
+		return 2;
+		}
+
+	// Vars have to exist before any table that uses them is loaded.
+	int	i;
+	for (i = 1; i < argc; i++)
+		{
+		if (ScanTable(argv[i]) != 0)
+			return 2;
+		}
+	for (int16_t s = 0; s < ms_sNumVars; s++)
+		ms_apvars[s]->Finish();
+
+	int32_t	lMismatches	= 0;
+	double	dOldTotal	= 0;
+	double	dNewTotal	= 0;
+	for (i = 1; i < argc; i++)
+		{
+		CBenchTab*	ptab	= new CBenchTab;
+		RFile	file;
+		if (file.Open(argv[i], "rb", RFile::LittleEndian) != 0 || ptab->Load(&file) != 0)
+			{
+			fprintf(stderr, "%s: can't load.\n", argv[i]);
+			return 2;
+			}
+		file.Close();
+
+		MakeAgents(ptab);
+
+		int32_t	lMatched	= 0;
+		int32_t	lBad			= 0;
+		for (int32_t l = 0; l < NUM_STATES; l++)
+			{
+			Agent	agentOld	= ms_aagents[l];
+			Agent	agentNew	= ms_aagents[l];
+			ResetAgent(&agentOld);
+			ResetAgent(&agentNew);
+			ptab->EvaluateOld(&agentOld);
+			ptab->Evaluate(&agentNew, false);
+			if (memcmp(agentOld.asOut, agentNew.asOut, sizeof(agentOld.asOut) ) != 0 || agentOld.ulGets != agentNew.ulGets)
+				lBad++;
+			for (int16_t s = 0; s < ms_sNumVars; s++)
+				{
+				if (agentNew.asOut[s] != -1)
+					{
+					lMatched++;
+					break;
+					}
+				}
+			}
+
+		double	dOld	= TimeTable(ptab, true);
+		double	dNew	= TimeTable(ptab, false);
+		printf("%s: %hd rows, %hd vars, %ld of %d states matched a row, %ld mismatches, old %.1f ns, compiled %.1f ns\n",
+			argv[i], ptab->GetNumRows(), ptab->GetNumVars(), (long)lMatched, NUM_STATES, (long)lBad, dOld, dNew);
+
+		lMismatches	+= lBad;
+		dOldTotal	+= dOld;
+		dNewTotal	+= dNew;
+		delete ptab;
+		}
+
+	printf("%d tables, %ld mismatches, old %.1f ns, compiled %.1f ns per evaluation (average)\n",
+		argc - 1, (long)lMismatches, dOldTotal / (argc - 1), dNewTotal / (argc - 1) );
+
+	return (lMismatches == 0) ? 0 : 1;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,412 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// rasterbench.cpp
+// Project: Nostril (aka Postal)
+//
+// Usage:  rasterbench
+//
+// Draws sets of random triangles, from sub-pixel up to 80 pixels across,
+// through the current rasterizer (GREEN/3D/render.cpp) and through the
+// original one (refrender.cpp), each into its own image and z-buffer, and
+// compares the results byte for byte.  The fogged and the flat z-buffered
+// versions are checked, and so is the plain DrawTri() with no z-buffer.
+// Any set whose image or z-buffer differs is reported as a mismatch (and
+// makes the exit code non-zero).  Then each set is timed both ways,
+// clearing the z-buffer (if used) before each pass.
+//
+// Then it draws a run of small models, each a few hundred triangles in its
+// own corner of the z-buffer, clearing the z-buffer between them the way
+// the scene does between sprites.  The original filled all of it every time;
+// the current one only clears what was drawn to since the last clear (and
+// all of it when the clear value changes, which every 8th model does).  The
+// image and z-buffer are compared after each model, then the two clears are
+// timed for one model's worth of drawing.
+//
+// Triangles are kept to z slopes the scene's screen transform can give (it
+// maps a model's 30 unit z span to the z-buffer's 65536 and its 20 unit
+// diameter to 90 pixels, about 480 z per pixel edge on), and no two
+// corners are more than 32767 apart in z.  Past that, the rasterizer's
+// fixed point z steps overflow, and what the original draws for those isn't
+// worth matching.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "RSPiX.h"
+#include "refrender.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define BUF_SIZE				256		// Width and height of images and z-buffers.
+#define OFFSET_X				5			// 2D offset of the image in the z-buffer.
+#define OFFSET_Y				3			// 2D offset of the image in the z-buffer.
+#define FOG_SIZE				1024		// Fog table entries (z's upper byte is signed).
+#define Z_SLOPE				300		// Most z change per pixel across a triangle.
+#define MAX_Z_SPREAD			32000		// Most z difference between corners.
+#define NUM_SETS				5			// Sets of triangles.
+#define NUM_MODELS			40			// Models drawn between clears.
+#define MODEL_W				40			// Width of a model on screen.
+#define MODEL_H				60			// Height of a model on screen.
+#define MODEL_ODD_CLEAR		8			// Every this many models clear to another z.
+#define MODEL_ODD_Z			-20000	// That other z.
+#define NUM_KINDS				3			// Fogged, flat and plain.
+#define MIN_BENCH_TIME		(CLOCKS_PER_SEC / 2)	// Time each set at least this long.
+
+////////////////////////////////////////////////////////////////////////////////
+// Types.
+////////////////////////////////////////////////////////////////////////////////
+
+// Which rasterizer to use.
+typedef enum
+	{
+	KindFog,								// DrawTri_ZColorFog().
+	KindFlat,							// DrawTri_ZColor().
+	KindPlain							// DrawTri(), no z-buffer.
+	} Kind;
+
+// A triangle.
+typedef struct
+	{
+	RP3d	apt[3];
+	} Tri;
+
+// A set of same sized triangles.
+typedef struct
+	{
+	float		fSize;					// Most a corner is from the center.
+	int32_t	lNum;						// Number of triangles.
+	} Set;
+
+// Where one version draws.
+typedef struct
+	{
+	uint8_t*		pu8Image;			// Image, BUF_SIZE square.
+	RZBuffer*	pzb;					// Z-buffer, BUF_SIZE square.
+	} Target;
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables.
+////////////////////////////////////////////////////////////////////////////////
+
+static Set		ms_asets[NUM_SETS]	=
+	{
+		{ 1.5F, 200000 },
+		{ 3.0F, 200000 },
+		{ 6.0F, 200000 },
+		{ 20.0F, 50000 },
+		{ 80.0F, 10000 },
+	};
+
+static Set		ms_setModel	= { 3.0F, 600 };	// One model's triangles.
+
+static uint8_t	ms_au8Fog[FOG_SIZE];
+
+static const char*	ms_apszKinds[NUM_KINDS]	= { "fog", "flat", "plain" };
+
+////////////////////////////////////////////////////////////////////////////////
+// Make a set of triangles, all inside a rectangle of the image.
+////////////////////////////////////////////////////////////////////////////////
+static Tri* MakeTris(			// Returns new triangles.
+	Set*		pset,					// In:  Set to make.
+	int16_t	sSeed,				// In:  Seed for the triangles.
+	int16_t	sX,					// In:  Rectangle to keep them in.
+	int16_t	sY,					// In:  Rectangle to keep them in.
+	int16_t	sW,					// In:  Rectangle to keep them in.
+	int16_t	sH)					// In:  Rectangle to keep them in.
+	{
+	Tri*		ptris		= (Tri*)malloc(sizeof(Tri) * pset->lNum);
+	int16_t	sMargin	= int16_t(pset->fSize) + 2;
+	int16_t	sRangeX	= sW - 2 * sMargin;
+	int16_t	sRangeY	= sH - 2 * sMargin;
+	float		fZSpan	= pset->fSize * Z_SLOPE;
+	if (fZSpan > MAX_Z_SPREAD / 2)
+		fZSpan	= MAX_Z_SPREAD / 2;
+	int16_t	sZRange	= int16_t(30000 - fZSpan);
+
+	srand(sSeed);
+	for (int32_t l = 0; l < pset->lNum; l++)
+		{
+		float	fCenX	= float(sX + sMargin + rand() % sRangeX);
+		float	fCenY	= float(sY + sMargin + rand() % sRangeY);
+		float	fCenZ	= float(rand() % (2 * sZRange + 1) - sZRange);
+		for (int16_t s = 0; s < 3; s++)
+			{
+			RP3d&	pt	= ptris[l].apt[s];
+			pt.x	= fCenX + (rand() / float(RAND_MAX) - 0.5F) * 2 * pset->fSize;
+			pt.y	= fCenY + (rand() / float(RAND_MAX) - 0.5F) * 2 * pset->fSize;
+			pt.z	= fCenZ + (rand() / float(RAND_MAX) - 0.5F) * 2 * fZSpan;
+			pt.w	= 1.0F;
+			}
+		}
+
+	return ptris;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Fill a z-buffer, all of it, the way it originally was.
+////////////////////////////////////////////////////////////////////////////////
+static void RefClearZ(			// Returns nothing.
+	RZBuffer*	pzb,				// In:  Z-buffer to clear.
+	int16_t		sVal)				// In:  Value to clear to.
+	{
+	for (int32_t l = 0; l < pzb->m_lP * pzb->m_sH; l++)
+		pzb->m_pBuf[l]	= sVal;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Clear an image and, if it's used, its z-buffer.
+////////////////////////////////////////////////////////////////////////////////
+static void ClearTarget(		// Returns nothing.
+	Target*	ptarget,				// In:  What to clear.
+	bool		bRef,					// In:  true to clear the z-buffer the original way.
+	Kind		kind)					// In:  Which version will draw.
+	{
+	memset(ptarget->pu8Image, 0, BUF_SIZE * BUF_SIZE);
+	if (kind == KindPlain)
+		return;
+	if (bRef)
+		RefClearZ(ptarget->pzb, ZB_MIN_Z);
+	else
+		ptarget->pzb->Clear();
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Draw a set of triangles.
+////////////////////////////////////////////////////////////////////////////////
+static void DrawTris(			// Returns nothing.
+	Tri*		ptris,				// In:  Triangles.
+	int32_t	lNum,					// In:  Number of triangles.
+	Target*	ptarget,				// In:  Where to draw.
+	bool		bRef,					// In:  true for the original rasterizer.
+	Kind		kind)					// In:  Which version.
+	{
+	uint8_t*	pu8Dst	= ptarget->pu8Image + OFFSET_X + OFFSET_Y * BUF_SIZE;
+	uint8_t*	pu8Fog	= ms_au8Fog + FOG_SIZE / 2;
+
+	for (int32_t l = 0; l < lNum; l++)
+		{
+		RP3d*		apt		= ptris[l].apt;
+		uint8_t	u8Color	= uint8_t(l * 7);
+		if (bRef)
+			{
+			switch (kind)
+				{
+				case KindFog:
+					RefDrawTri_ZColorFog(pu8Dst, BUF_SIZE, &apt[0], &apt[1], &apt[2], ptarget->pzb, pu8Fog + (u8Color & 0x3F), OFFSET_X, OFFSET_Y);
+					break;
+				case KindFlat:
+					RefDrawTri_ZColor(pu8Dst, BUF_SIZE, &apt[0], &apt[1], &apt[2], ptarget->pzb, u8Color, OFFSET_X, OFFSET_Y);
+					break;
+				case KindPlain:
+					RefDrawTri(pu8Dst, BUF_SIZE, &apt[0], &apt[1], &apt[2], u8Color);
+					break;
+				}
+			}
+		else
+			{
+			switch (kind)
+				{
+				case KindFog:
+					DrawTri_ZColorFog(pu8Dst, BUF_SIZE, &apt[0], &apt[1], &apt[2], ptarget->pzb, pu8Fog + (u8Color & 0x3F), OFFSET_X, OFFSET_Y);
+					break;
+				case KindFlat:
+					DrawTri_ZColor(pu8Dst, BUF_SIZE, &apt[0], &apt[1], &apt[2], ptarget->pzb, u8Color, OFFSET_X, OFFSET_Y);
+					break;
+				case KindPlain:
+					DrawTri(pu8Dst, BUF_SIZE, &apt[0], &apt[1], &apt[2], u8Color);
+					break;
+				}
+			}
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time clearing and drawing a set of triangles.
+////////////////////////////////////////////////////////////////////////////////
+static double TimeTris(			// Returns milliseconds per pass.
+	Tri*		ptris,				// In:  Triangles.
+	int32_t	lNum,					// In:  Number of triangles.
+	Target*	ptarget,				// In:  Where to draw.
+	bool		bRef,					// In:  true for the original rasterizer.
+	Kind		kind)					// In:  Which version.
+	{
+	int32_t	lPasses	= 0;
+	clock_t	clkStart	= clock();
+	clock_t	clkTime;
+	do
+		{
+		ClearTarget(ptarget, bRef, kind);
+		DrawTris(ptris, lNum, ptarget, bRef, kind);
+		lPasses++;
+		clkTime	= clock() - clkStart;
+		} while (clkTime < MIN_BENCH_TIME);
+
+	return (double)clkTime * 1000.0 / CLOCKS_PER_SEC / lPasses;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Compare what the two versions drew.
+////////////////////////////////////////////////////////////////////////////////
+static bool Same(					// Returns true if identical.
+	Target*	ptargetRef,			// In:  Original's.
+	Target*	ptargetNew)			// In:  Current one's.
+	{
+	return memcmp(ptargetRef->pu8Image, ptargetNew->pu8Image, BUF_SIZE * BUF_SIZE) == 0
+		&& memcmp(ptargetRef->pzb->m_pBuf, ptargetNew->pzb->m_pBuf,
+			sizeof(int16_t) * ptargetRef->pzb->m_lP * ptargetRef->pzb->m_sH) == 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Draw a run of models, clearing the z-buffer between them both ways.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t CheckModels(	// Returns number of models that differed.
+	Target*	ptargetRef,			// In:  Original's.
+	Target*	ptargetNew)			// In:  Current one's.
+	{
+	int32_t	lMismatches	= 0;
+	int16_t	sRange		= BUF_SIZE - OFFSET_X;
+
+	memset(ptargetRef->pu8Image, 0, BUF_SIZE * BUF_SIZE);
+	memset(ptargetNew->pu8Image, 0, BUF_SIZE * BUF_SIZE);
+	for (int16_t s = 0; s < NUM_MODELS; s++)
+		{
+		int16_t	sVal	= (s % MODEL_ODD_CLEAR == MODEL_ODD_CLEAR - 1) ? MODEL_ODD_Z : ZB_MIN_Z;
+		RefClearZ(ptargetRef->pzb, sVal);
+		ptargetNew->pzb->Clear(sVal);
+
+		srand(1000 + s);
+		int16_t	sX		= int16_t(rand() % (sRange - MODEL_W + 1));
+		int16_t	sY		= int16_t(rand() % (sRange - MODEL_H + 1));
+		Tri*		ptris	= MakeTris(&ms_setModel, 1000 + s, sX, sY, MODEL_W, MODEL_H);
+		Kind		kind	= (s & 1) ? KindFlat : KindFog;
+		DrawTris(ptris, ms_setModel.lNum, ptargetRef, true, kind);
+		DrawTris(ptris, ms_setModel.lNum, ptargetNew, false, kind);
+		free(ptris);
+
+		if (Same(ptargetRef, ptargetNew) == false)
+			{
+			printf("Model %d at (%d, %d), cleared to %d: MISMATCH\n", (int)s, (int)sX, (int)sY, (int)sVal);
+			lMismatches++;
+			}
+		}
+
+	printf("%d models of %ld triangles, cleared between each: %ld mismatches\n",
+		NUM_MODELS, (long)ms_setModel.lNum, (long)lMismatches);
+
+	return lMismatches;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time a clear after a model's worth of drawing, both ways.
+////////////////////////////////////////////////////////////////////////////////
+static void TimeModelClears(	// Returns nothing.
+	RZBuffer*	pzb)				// In:  Z-buffer to clear.
+	{
+	int32_t	lPasses	= 0;
+	clock_t	clkStart	= clock();
+	clock_t	clkTime;
+	do
+		{
+		RefClearZ(pzb, ZB_MIN_Z);
+		lPasses++;
+		clkTime	= clock() - clkStart;
+		} while (clkTime < MIN_BENCH_TIME);
+	double	dRef	= (double)clkTime * 1000000.0 / CLOCKS_PER_SEC / lPasses;
+
+	lPasses	= 0;
+	clkStart	= clock();
+	do
+		{
+		pzb->Touch(OFFSET_X, OFFSET_Y, OFFSET_X + MODEL_W - 1, OFFSET_Y + MODEL_H - 1);
+		pzb->Clear();
+		lPasses++;
+		clkTime	= clock() - clkStart;
+		} while (clkTime < MIN_BENCH_TIME);
+	double	dNew	= (double)clkTime * 1000000.0 / CLOCKS_PER_SEC / lPasses;
+
+	printf("Clear after a %dx%d model: original %.2f us, current %.2f us\n",
+		MODEL_W, MODEL_H, dRef, dNew);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main.
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+	{
+	if (argc > 1)
+		{
+		fprintf(stderr, "Usage: %s\n", argv[0]);
+		return 2;
+		}
+
+	int16_t	s;
+	for (s = 0; s < FOG_SIZE; s++)
+		ms_au8Fog[s]	= uint8_t(s * 13);
+
+	Target	targetRef;
+	Target	targetNew;
+	targetRef.pu8Image	= (uint8_t*)malloc(BUF_SIZE * BUF_SIZE);
+	targetNew.pu8Image	= (uint8_t*)malloc(BUF_SIZE * BUF_SIZE);
+	targetRef.pzb			= new RZBuffer(BUF_SIZE, BUF_SIZE);
+	targetNew.pzb			= new RZBuffer(BUF_SIZE, BUF_SIZE);
+
+	int32_t	lMismatches	= 0;
+	for (s = 0; s < NUM_SETS; s++)
+		{
+		Set*	pset	= &ms_asets[s];
+		Tri*	ptris	= MakeTris(pset, s + 1, 0, 0, BUF_SIZE - OFFSET_X, BUF_SIZE - OFFSET_X);
+
+		for (int16_t sKind = 0; sKind < NUM_KINDS; sKind++)
+			{
+			Kind		kind	= Kind(sKind);
+			ClearTarget(&targetRef, true, kind);
+			ClearTarget(&targetNew, false, kind);
+			DrawTris(ptris, pset->lNum, &targetRef, true, kind);
+			DrawTris(ptris, pset->lNum, &targetNew, false, kind);
+			bool		bSame	= Same(&targetRef, &targetNew);
+
+			double	dRef	= TimeTris(ptris, pset->lNum, &targetRef, true, kind);
+			double	dNew	= TimeTris(ptris, pset->lNum, &targetNew, false, kind);
+			printf("%g pixel %s: %ld triangles, %s, original %.1f ms, current %.1f ms\n",
+				pset->fSize, ms_apszKinds[sKind], (long)pset->lNum,
+				bSame ? "identical" : "MISMATCH", dRef, dNew);
+
+			if (bSame == false)
+				lMismatches++;
+			}
+
+		free(ptris);
+		}
+
+	lMismatches	+= CheckModels(&targetRef, &targetNew);
+	TimeModelClears(targetNew.pzb);
+
+	printf("%ld mismatches\n", (long)lMismatches);
+
+	return (lMismatches == 0) ? 0 : 1;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
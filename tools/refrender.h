@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// refrender.h
+// Project: Nostril (aka Postal)
+//
+// The original rasterizer, for checking the current one against (see
+// refrender.cpp).  Same parameters as the GREEN/3D/render.h versions.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef REFRENDER_H
+#define REFRENDER_H
+
+extern	void	RefDrawTri_ZColorFog(uint8_t* pDst,int32_t lDstP,
+			RP3d* p1,RP3d* p2,RP3d* p3,
+			RZBuffer* pZB,uint8_t* pFog, 
+			int16_t sOffsetX = 0,		// In: 2D offset for pZB.
+			int16_t sOffsetY = 0); 	// In: 2D offset for pZB.
+
+extern	void	RefDrawTri_ZColor(uint8_t* pDst,int32_t lDstP,
+			RP3d* p1,RP3d* p2,RP3d* p3,
+			RZBuffer* pZB,uint8_t pFlatColor,
+			int16_t sOffsetX = 0,		// In: 2D offset for pZB.
+			int16_t sOffsetY = 0); 	// In: 2D offset for pZB.
+
+extern	void	RefDrawTri(uint8_t* pDstOffset,int32_t lDstP,
+			RP3d* p1,RP3d* p2,RP3d* p3,
+			uint8_t ucFlatColor);
+
+#endif	// REFRENDER_H
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// toolstubs.cpp
+// Project: Nostril (aka Postal)
+//
+// Console stand-ins for the few BLUE and CYAN calls that the RSPiX pieces
+// the tools link to make, so the tools don't need SDL or the rest of the
+// platform layer.  Also stand-ins for the image and BLiT calls the 3D
+// pipeline makes for its clip and shadow buffers, which the tools never
+// create (they render straight into their own buffers).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "RSPiX.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Print the message instead of showing a box.
+////////////////////////////////////////////////////////////////////////////////
+extern int16_t rspMsgBox(	// Returns RSP_MB_RET_OK.
+	uint16_t usFlags,			// Ignored.
+	char *pszTitle,			// Title for box.
+	char *pszFrmt,				// Format of string (sprintf flags).
+	...)							// Various crap to represent sprintf flags.
+	{
+	va_list	varp;
+	va_start(varp, pszFrmt);
+	fprintf(stderr, "%s: ", pszTitle);
+	vfprintf(stderr, pszFrmt, varp);
+	fprintf(stderr, "\n");
+	va_end(varp);
+
+	return RSP_MB_RET_OK;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tools don't take the game's command line options.
+////////////////////////////////////////////////////////////////////////////////
+extern int rspCommandLine(const char *cmd)
+	{
+	return 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Images the pipeline would make are never made.
+////////////////////////////////////////////////////////////////////////////////
+RImage::RImage()
+	{
+	m_type		= NOT_SUPPORTED;
+	m_sWidth		= 0;
+	m_sHeight	= 0;
+	m_lPitch		= 0;
+	m_pMem		= NULL;
+	m_pData		= NULL;
+	m_pPalette	= NULL;
+	}
+
+RImage::~RImage()
+	{
+	}
+
+int16_t RImage::CreateImage(	// Returns -1.
+	int16_t	sWidth,				// Ignored.
+	int16_t	sHeight,				// Ignored.
+	Type type,						// Ignored.
+	int32_t	lPitch,				// Ignored.
+	int16_t	sDepth)				// Ignored.
+	{
+	return -1;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Nothing to draw on, so nothing is drawn.
+////////////////////////////////////////////////////////////////////////////////
+extern int16_t rspRect(U32 color,RImage* pimDst,int16_t sX,int16_t sY,int16_t sW,int16_t sH,RRect* prClip)
+	{
+	return -1;
+	}
+
+extern void rspLine(uint8_t ucColor,RImage* pimDst,int16_t sX1,int16_t sY1,int16_t sX2,int16_t sY2,
+	const RRect* prClip)
+	{
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Palette matching is only done for fog and shading tables, which the tools
+// make themselves.
+////////////////////////////////////////////////////////////////////////////////
+extern uint8_t rspMatchColorRGB(int32_t r,int32_t g,int32_t b,int16_t sStart,int16_t sNum,
+	uint8_t* pr,uint8_t* pg,uint8_t* pb,int32_t linc)
+	{
+	return (uint8_t)sStart;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,464 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2016 RWS Inc, All Rights Reserved
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of version 2 of the GNU General Public License as published by
+// the Free Software Foundation
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+//
+// xformbench.cpp
+// Project: Nostril (aka Postal)
+//
+// Usage:  xformbench [<file.sop | file.anim> ...]
+//
+// Runs sops (e.g., the game's character animations) through
+// RPipeLine::Transform() and checks every point against what the original
+// per point RTransform::TransformInto() loop gives, with the scene's view and
+// screen transforms and the object turned through a full circle.  Each sop
+// is also blended halfway toward the next one, the way CAnim3D::GetSop()
+// hands them out.  Then both are timed.
+//
+// Unpacked sops must come out bit-identical.  Every sop is also run through
+// a CAnimPack in memory and checked packed, where the unpack is folded into
+// the transform so the rounding differs; those must be within a small
+// fraction of a pixel (x, y) and of a z-buffer step (z).  Any point outside
+// that is reported as a mismatch (and makes the exit code non-zero).
+//
+// With no files, a few synthetic character sized animations are used.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "RSPiX.h"
+#include "AnimPack.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_ANIMS				64			// Most animations checked in one run.
+#define NUM_ANGLES			24			// Object rotations checked per sop.
+#define SCREEN_SIZE			90			// Scene's 3D screen diameter at 1x.
+#define MODEL_DIAMETER		20.0		// Same as the scene's.
+#define MODEL_ZSPAN			30.0		// Same as the scene's.
+#define PACKED_MAX_XY		(1.0 / 64.0)	// Packed error allowed in pixels.
+#define PACKED_MAX_Z			0.5		// Packed error allowed in z-buffer units.
+#define SYNTH_ANIMS			3			// Synthetic animations.
+#define SYNTH_FRAMES			20			// Frames per synthetic animation.
+#define SYNTH_PTS				400		// Points per synthetic frame.
+#define MIN_BENCH_TIME		(CLOCKS_PER_SEC / 2)	// Time each run at least this long.
+
+////////////////////////////////////////////////////////////////////////////////
+// Types.
+////////////////////////////////////////////////////////////////////////////////
+
+// One animation's sops, unpacked and packed.
+typedef struct
+	{
+	const char*	pszName;				// File name or "synthetic".
+	ChanForm*	pchan;				// Unpacked sops.
+	CAnimPack*	ppack;				// Pack holding the packed copy.
+	ChanForm*	pchanPacked;		// Packed sops (in ppack).
+	} Anim;
+
+// How one check went.
+typedef struct
+	{
+	int32_t	lPts;					// Points checked.
+	int32_t	lBad;					// Points outside what's allowed.
+	double	dMaxXY;				// Worst x or y difference.
+	double	dMaxZ;				// Worst z difference.
+	} Result;
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables.
+////////////////////////////////////////////////////////////////////////////////
+
+static Anim			ms_aanims[MAX_ANIMS];
+static int16_t		ms_sNumAnims	= 0;
+
+static RPipeLine	ms_pipe;							// Pipeline being checked.
+static RP3d*		ms_pptsRef		= NULL;		// Reference output.
+static int32_t		ms_lMaxPts		= 0;			// Most points in any sop.
+
+////////////////////////////////////////////////////////////////////////////////
+// Set up the pipeline's view and screen transforms the way
+// CScene::SetupPipeline() does, under a tilted view like the hoods use.
+////////////////////////////////////////////////////////////////////////////////
+static void SetupPipe(void)		// Returns nothing.
+	{
+	ms_pipe.m_tView.Make1();
+	ms_pipe.m_tView.Rx(330);
+	ms_pipe.m_tView.Trans(MODEL_DIAMETER / 2, MODEL_DIAMETER / 2, 0.0);
+
+	ms_pipe.m_tScreen.Make1();
+	ms_pipe.m_tScreen.Scale(
+		SCREEN_SIZE / MODEL_DIAMETER,
+		SCREEN_SIZE / MODEL_DIAMETER,
+		REAL(65535.0 / MODEL_ZSPAN) );
+	ms_pipe.m_tScreen.Scale(1.0, -1.0, 1.0);
+	ms_pipe.m_tScreen.Trans(0.0, SCREEN_SIZE, 0.0);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Get an object transform like CThing3d::Render() makes.
+////////////////////////////////////////////////////////////////////////////////
+static void MakeObj(				// Returns nothing.
+	int16_t		sAngle,			// In:  Rotation about y.
+	RTransform&	tObj)				// Out: Object transform.
+	{
+	tObj.Make1();
+	tObj.Scale(1.0, 1.0, 1.0);
+	tObj.Ry(sAngle);
+	tObj.Rz(0);
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Transform the way RPipeLine::Transform() originally did.  If psopNext is
+// not NULL, the points are first blended fBlend of the way toward its points.
+////////////////////////////////////////////////////////////////////////////////
+static void TransformOld(		// Returns nothing.
+	RSop*			psop,				// In:  Sop to transform.
+	RTransform&	tObj,				// In:  Object transform.
+	RSop*			psopNext,		// In:  Sop to blend toward or NULL.
+	REAL			fBlend,			// In:  How far toward psopNext.
+	RP3d*			pptsDst)			// Out: Transformed points.
+	{
+	RTransform	tFull;
+	tFull.Make1();
+	tFull.Mul(ms_pipe.m_tView.T, tObj.T);
+	tFull.PreMulBy(ms_pipe.m_tScreen.T);
+
+	RP3d	pt;
+	RP3d	ptNext;
+	for (int32_t l = 0; l < psop->m_lNum; l++)
+		{
+		psop->GetPt(l, pt);
+		if (psopNext != NULL)
+			{
+			psopNext->GetPt(l, ptNext);
+			pt.x	= pt.x + (ptNext.x - pt.x) * fBlend;
+			pt.y	= pt.y + (ptNext.y - pt.y) * fBlend;
+			pt.z	= pt.z + (ptNext.z - pt.z) * fBlend;
+			pt.w	= pt.w + (ptNext.w - pt.w) * fBlend;
+			}
+		tFull.TransformInto(pt, pptsDst[l]);
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Compare the pipeline's last output with the reference.
+////////////////////////////////////////////////////////////////////////////////
+static void Compare(				// Returns nothing.
+	int32_t	lNum,					// In:  Number of points.
+	bool		bExact,				// In:  true, if they must be bit-identical.
+	Result*	presult)				// In/Out: Tally.
+	{
+	for (int32_t l = 0; l < lNum; l++)
+		{
+		RP3d&	ptRef	= ms_pptsRef[l];
+		RP3d&	ptNew	= RPipeLine::ms_pPts[l];
+		double	dXY	= fabs(ptNew.x - ptRef.x);
+		if (fabs(ptNew.y - ptRef.y) > dXY)
+			dXY	= fabs(ptNew.y - ptRef.y);
+		double	dZ		= fabs(ptNew.z - ptRef.z);
+
+		if (dXY > presult->dMaxXY)
+			presult->dMaxXY	= dXY;
+		if (dZ > presult->dMaxZ)
+			presult->dMaxZ	= dZ;
+
+		if (bExact)
+			{
+			if (memcmp(&ptNew, &ptRef, sizeof(RP3d) ) != 0)
+				presult->lBad++;
+			}
+		else if (dXY > PACKED_MAX_XY || dZ > PACKED_MAX_Z || ptNew.w != ptRef.w)
+			presult->lBad++;
+
+		presult->lPts++;
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Check every sop in a channel, at every angle, alone and blended.
+////////////////////////////////////////////////////////////////////////////////
+static void CheckChan(			// Returns nothing.
+	ChanForm*	pchan,			// In:  Sops to check.
+	bool			bExact,			// In:  true, if they must be bit-identical.
+	Result*		presult)			// Out: How it went.
+	{
+	memset(presult, 0, sizeof(*presult) );
+
+	RTransform	tObj;
+	int32_t		lNumItems	= pchan->NumItems();
+	for (int32_t l = 0; l < lNumItems; l++)
+		{
+		RSop*	psop		= pchan->GetItem(l);
+		RSop*	psopNext	= pchan->GetItem( (l + 1) % lNumItems);
+		if (psopNext->m_lNum != psop->m_lNum)
+			psopNext	= NULL;
+
+		for (int16_t sAngle = 0; sAngle < 360; sAngle += 360 / NUM_ANGLES)
+			{
+			MakeObj(sAngle, tObj);
+
+			ms_pipe.Transform(psop, tObj);
+			TransformOld(psop, tObj, NULL, 0, ms_pptsRef);
+			Compare(psop->m_lNum, bExact, presult);
+
+			if (psopNext != NULL)
+				{
+				ms_pipe.Transform(psop, tObj, psopNext, REAL(0.5) );
+				TransformOld(psop, tObj, psopNext, REAL(0.5), ms_pptsRef);
+				Compare(psop->m_lNum, bExact, presult);
+				}
+			}
+		}
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time transforming every sop in a channel.
+////////////////////////////////////////////////////////////////////////////////
+static double TimeChan(			// Returns nanoseconds per point.
+	ChanForm*	pchan,			// In:  Sops to transform.
+	bool			bOld)				// In:  true to time the original loop.
+	{
+	RTransform	tObj;
+	MakeObj(45, tObj);
+
+	int32_t	lPts		= 0;
+	clock_t	clkStart	= clock();
+	clock_t	clkTime;
+	do
+		{
+		for (int32_t l = 0; l < pchan->NumItems(); l++)
+			{
+			RSop*	psop	= pchan->GetItem(l);
+			if (bOld)
+				TransformOld(psop, tObj, NULL, 0, ms_pptsRef);
+			else
+				ms_pipe.Transform(psop, tObj);
+			lPts	+= psop->m_lNum;
+			}
+		clkTime	= clock() - clkStart;
+		} while (clkTime < MIN_BENCH_TIME);
+
+	return (double)clkTime * 1.0e9 / CLOCKS_PER_SEC / lPts;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Make a character sized animation:  points in a 2 x 7 x 2 Randy unit body
+// that sway from frame to frame.
+////////////////////////////////////////////////////////////////////////////////
+static ChanForm* MakeSynthetic(	// Returns new channel.
+	int16_t	sSeed)					// In:  Seed for the points.
+	{
+	ChanForm*	pchan	= new ChanForm;
+	pchan->SetType(RChannel_Array);
+	pchan->SetName("synthetic");
+	pchan->CreateItems(SYNTH_FRAMES);
+	pchan->SetResolution(100);
+	pchan->SetTotalTime(SYNTH_FRAMES * 100);
+	pchan->SetLooping(RChannel_LoopAtEnd);
+
+	srand(sSeed);
+	RP3d	aptBase[SYNTH_PTS];
+	int32_t	l;
+	for (l = 0; l < SYNTH_PTS; l++)
+		{
+		aptBase[l].x	= (rand() % 2001 - 1000) / 1000.0F;
+		aptBase[l].y	= (rand() % 7001) / 1000.0F;
+		aptBase[l].z	= (rand() % 2001 - 1000) / 1000.0F;
+		aptBase[l].w	= 1.0F;
+		}
+
+	for (int32_t lFrame = 0; lFrame < SYNTH_FRAMES; lFrame++)
+		{
+		RSop*	psop	= pchan->GetItem(lFrame);
+		psop->Alloc(SYNTH_PTS);
+		double	dPhase	= lFrame * 2.0 * 3.14159265 / SYNTH_FRAMES;
+		for (l = 0; l < SYNTH_PTS; l++)
+			{
+			psop->m_pArray[l]		= aptBase[l];
+			psop->m_pArray[l].x	+= REAL(0.3 * sin(dPhase + aptBase[l].y) );
+			psop->m_pArray[l].z	+= REAL(0.3 * cos(dPhase + aptBase[l].y) );
+			}
+		}
+
+	return pchan;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Load the sops from a .sop file or an animation pack.
+////////////////////////////////////////////////////////////////////////////////
+static ChanForm* LoadChan(		// Returns new channel or NULL.
+	const char*	pszName)			// In:  File to load.
+	{
+	RFile	file;
+	if (file.Open((char*)pszName, "rb", RFile::LittleEndian) != 0)
+		return NULL;
+
+	ChanForm*	pchan	= new ChanForm;
+	size_t		sLen	= strlen(pszName);
+	int16_t		sRes;
+	if (sLen > 5 && rspStricmp(pszName + sLen - 5, ".anim") == 0)
+		{
+		// Unpack it into a channel of our own.
+		CAnimPack	pack;
+		ChanForm*	pchanPacked;
+		sRes	= pack.Load(&file);
+		if (sRes == 0 && pack.Get(".sop", &pchanPacked) == true)
+			{
+			pchan->SetType(RChannel_Array);
+			pchan->SetName("unpacked");
+			pchan->CreateItems(pchanPacked->NumItems() );
+			pchan->SetResolution(pchanPacked->Resolution() );
+			pchan->SetTotalTime(pchanPacked->TotalTime() );
+			for (int32_t l = 0; l < pchanPacked->NumItems(); l++)
+				{
+				RSop*	psopPacked	= pchanPacked->GetItem(l);
+				RSop*	psop			= pchan->GetItem(l);
+				psop->Alloc(psopPacked->m_lNum);
+				for (int32_t lPt = 0; lPt < psopPacked->m_lNum; lPt++)
+					psopPacked->GetPt(lPt, psop->m_pArray[lPt]);
+				}
+			}
+		else
+			sRes	= -1;
+		}
+	else
+		sRes	= pchan->Load(&file);
+
+	file.Close();
+
+	if (sRes != 0)
+		{
+		delete pchan;
+		pchan	= NULL;
+		}
+
+	return pchan;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Add an animation, making its packed copy.
+////////////////////////////////////////////////////////////////////////////////
+static int16_t AddAnim(			// Returns 0 on success.
+	const char*	pszName,			// In:  Name to report it by.
+	ChanForm*	pchan)			// In:  Unpacked sops.
+	{
+	if (ms_sNumAnims >= MAX_ANIMS)
+		return -1;
+
+	Anim*	panim		= &ms_aanims[ms_sNumAnims];
+	panim->pszName	= pszName;
+	panim->pchan	= pchan;
+	panim->ppack	= new CAnimPack;
+
+	// Pack it the way the game's .anim files are made.
+	CAnimPack	packSave;
+	RFile			file;
+	packSave.Add(".sop", pchan);
+	if (file.Open(1024, 1024, RFile::LittleEndian) != 0 || packSave.Save(&file) != 0)
+		return -1;
+
+	int32_t	lSize	= file.Tell();
+	RFile		fileLoad;
+	if (fileLoad.Open(file.GetMemory(), lSize, RFile::LittleEndian) != 0
+		|| panim->ppack->Load(&fileLoad) != 0
+		|| panim->ppack->Get(".sop", &panim->pchanPacked) == false)
+		return -1;
+
+	for (int32_t l = 0; l < pchan->NumItems(); l++)
+		{
+		if (pchan->GetItem(l)->m_lNum > ms_lMaxPts)
+			ms_lMaxPts	= pchan->GetItem(l)->m_lNum;
+		}
+
+	ms_sNumAnims++;
+	return 0;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main.
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+	{
+	if (argc - 1 > MAX_ANIMS)
+		{
+		fprintf(stderr, "Usage: %s [<file.sop | file.anim> ...] (up to %d)\n", argv[0], MAX_ANIMS);
+		return 2;
+		}
+
+	int	i;
+	for (i = 1; i < argc; i++)
+		{
+		ChanForm*	pchan	= LoadChan(argv[i]);
+		if (pchan == NULL || AddAnim(argv[i], pchan) != 0)
+			{
+			fprintf(stderr, "%s: can't load.\n", argv[i]);
+			return 2;
+			}
+		}
+
+	if (argc < 2)
+		{
+		for (int16_t s = 0; s < SYNTH_ANIMS; s++)
+			AddAnim("synthetic", MakeSynthetic(s + 1) );
+		}
+
+	SetupPipe();
+	ms_pipe.Create(ms_lMaxPts, 0);
+	ms_pptsRef	= (RP3d*)malloc(sizeof(RP3d) * ms_lMaxPts);
+
+	int32_t	lMismatches	= 0;
+	double	dOldTotal	= 0;
+	double	dNewTotal	= 0;
+	double	dPackedTotal	= 0;
+	for (i = 0; i < ms_sNumAnims; i++)
+		{
+		Anim*		panim	= &ms_aanims[i];
+		Result	result;
+		Result	resultPacked;
+		CheckChan(panim->pchan, true, &result);
+		CheckChan(panim->pchanPacked, false, &resultPacked);
+
+		double	dOld		= TimeChan(panim->pchan, true);
+		double	dNew		= TimeChan(panim->pchan, false);
+		double	dPacked	= TimeChan(panim->pchanPacked, false);
+		printf("%s: %ld sops, %ld pts checked, %ld mismatches; packed %ld mismatches (worst %g xy, %g z); "
+			"old %.2f ns, new %.2f ns, packed %.2f ns per pt\n",
+			panim->pszName, (long)panim->pchan->NumItems(), (long)result.lPts, (long)result.lBad,
+			(long)resultPacked.lBad, resultPacked.dMaxXY, resultPacked.dMaxZ, dOld, dNew, dPacked);
+
+		lMismatches		+= result.lBad + resultPacked.lBad;
+		dOldTotal		+= dOld;
+		dNewTotal		+= dNew;
+		dPackedTotal	+= dPacked;
+		}
+
+	printf("%d animations, %ld mismatches, old %.2f ns, new %.2f ns, packed %.2f ns per pt (average)\n",
+		ms_sNumAnims, (long)lMismatches, dOldTotal / ms_sNumAnims, dNewTotal / ms_sNumAnims,
+		dPackedTotal / ms_sNumAnims);
+
+	return (lMismatches == 0) ? 0 : 1;
+	}
+
+////////////////////////////////////////////////////////////////////////////////
+// EOF
+////////////////////////////////////////////////////////////////////////////////
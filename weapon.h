@@ -120,7 +120,7 @@ class CWeapon : public CThing
 
 		CWeaponState m_eState;				// State variable for run routine
 
-		U16		m_idParent;					// Anyone can be this item's parent.
+		CIdBank::Handle	m_hParent;				// Anyone can be this item's parent.
 													// It'd probably be a good idea to make
 													// sure this is NULL before setting it,
 													// though.
@@ -153,7 +153,7 @@ class CWeapon : public CThing
 			m_sSuspend = 0;
 			m_dX = m_dY = m_dZ = m_dRot = m_dVertVel = m_dHorizVel = 0.0;
 			m_eState = State_Idle;
-			m_idParent = CIdBank::IdNil;
+			m_hParent = CIdBank::HandleNil;
 			m_spriteShadow.m_sInFlags = CSprite::InHidden;
 			m_spriteShadow.m_pImage = NULL;
 			m_spriteShadow.m_pthing = this;
@@ -89,6 +89,7 @@ class CTime
 		int32_t m_lLastTime;
 		int32_t m_lGameTime;
 		int32_t m_lForceInterval;
+		int32_t m_lStepBank;			// Real time banked toward fixed steps.
 		int16_t	m_sNumSuspends;		// Number of Suspend()s that have occurred w/o
 											// corresponding Resume()s.
 
@@ -123,6 +124,7 @@ class CTime
 			m_lLastTime = m_lResetTime;
 			m_lGameTime = 0;
 			m_lForceInterval = 0;
+			m_lStepBank = 0;
 			m_sNumSuspends	= 0;
 			}
 
@@ -190,6 +192,62 @@ class CTime
 			}
 
 
+		////////////////////////////////////////////////////////////////////////////////
+		// Fixed step alternative to Update().  Banks the real time that has passed
+		// since the last call (with the same limit Update() uses) and returns the
+		// number of whole steps now due, up to sMaxSteps.  Call Step() once for
+		// each.  If more than sMaxSteps are due, the extra time is dropped so we
+		// don't keep falling further behind.
+		////////////////////////////////////////////////////////////////////////////////
+		int16_t GetDueSteps(					// Returns number of steps to take.
+			int32_t lStepTime,				// In:  Length of a step.
+			int16_t sMaxSteps)				// In:  Most steps to take at once.
+			{
+			int32_t lNewTime = rspGetMilliseconds();
+
+			// If suspended . . .
+			if (m_sNumSuspends > 0)
+				{
+				m_lLastTime	= lNewTime;
+				}
+
+			int32_t lElapsedTime = lNewTime - m_lLastTime;
+			if (lElapsedTime > MaxElapsedRealTime)
+				lElapsedTime = DefaultElapsedRealTime;
+
+			m_lLastTime = lNewTime;
+			m_lStepBank += lElapsedTime;
+
+			int32_t lSteps = m_lStepBank / lStepTime;
+			if (lSteps > sMaxSteps)
+				{
+				lSteps = sMaxSteps;
+				m_lStepBank = lStepTime * sMaxSteps;
+				}
+
+			m_lStepBank -= lSteps * lStepTime;
+
+			return (int16_t)lSteps;
+			}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Move game time forward one fixed step.  See GetDueSteps().
+		////////////////////////////////////////////////////////////////////////////////
+		void Step(
+			int32_t lStepTime)				// In:  Length of a step.
+			{
+			m_lGameTime += lStepTime;
+			}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Get how far real time is into the next fixed step, in 256ths of a step.
+		////////////////////////////////////////////////////////////////////////////////
+		int16_t GetStepFraction(			// Returns 0 to 255.
+			int32_t lStepTime)				// In:  Length of a step.
+			{
+			return (int16_t)((m_lStepBank * 256) / lStepTime);
+			}
+
 		////////////////////////////////////////////////////////////////////////////////
 		// Get game time since last Reset().  Note that this is NOT compatible with
 		// the time returned by rspGetMilliseconds()!